@@ -0,0 +1,48 @@
+#pragma once
+#include "core/core_export.h"
+#include "core/core.h"
+#include "core/memory/allocator.h"
+#include "core/memory/page_pool.h"
+#include "core/std/shared_ptr.h"
+
+namespace tundra::core::memory {
+
+/// Allocates memory linearly from a chain of pages, acquired from a `PagePool` when
+/// they are needed. Allocations larger than a page get their own block.
+///
+/// Constructing the allocator does not allocate, and once the pool has enough pages,
+/// neither does `alloc`.
+class CORE_API PageAllocator : public IAllocator {
+private:
+    struct Page {
+        Page* next;
+        /// Size of the page, including this header.
+        usize size;
+    };
+
+private:
+    core::SharedPtr<PagePool> m_pool;
+    Page* m_first_page = nullptr;
+    Page* m_current_page = nullptr;
+    /// Offset of the next allocation in `m_current_page`.
+    usize m_offset = 0;
+
+public:
+    /// Uses the page pool of the calling thread.
+    PageAllocator() noexcept;
+    explicit PageAllocator(core::SharedPtr<PagePool> pool) noexcept;
+    virtual ~PageAllocator() noexcept override;
+    PageAllocator(PageAllocator&& rhs) noexcept;
+    PageAllocator& operator=(PageAllocator&& rhs) noexcept;
+    PageAllocator(const PageAllocator&) noexcept = delete;
+    PageAllocator& operator=(const PageAllocator&) noexcept = delete;
+
+public:
+    virtual void* alloc(
+        const usize size, const usize alignment = alignof(std::max_align_t)) final;
+    virtual void free(void* const ptr) final;
+    /// Returns all pages to the pool.
+    void reset() noexcept;
+};
+
+} // namespace tundra::core::memory
@@ -0,0 +1,70 @@
+#pragma once
+#include "core/core_export.h"
+#include "core/core.h"
+#include "core/std/shared_ptr.h"
+#include "core/std/sync/lock.h"
+
+namespace tundra::core::memory {
+
+/// A pool of fixed-size pages, used by `PageAllocator`.
+///
+/// Every thread has its own pool (see `get_thread_local`), so acquiring a page is
+/// uncontended. Pages can be released from any thread, and return to the pool they
+/// were acquired from. Released pages are kept for reuse, and freed with the pool.
+class CORE_API PagePool {
+public:
+    static constexpr usize PAGE_SIZE = 64 * 1024;
+
+    /// Sizes are in pages.
+    struct Statistics {
+        /// Pages allocated by the pool(s).
+        usize num_pages = 0;
+        /// Pages acquired, and not released yet.
+        usize num_used_pages = 0;
+        /// The highest `num_used_pages`. Reserving this many pages makes acquiring
+        /// pages allocation-free.
+        usize max_num_used_pages = 0;
+    };
+
+private:
+    /// Free pages are linked through their first bytes.
+    struct FreePage {
+        FreePage* next;
+    };
+
+    struct Inner {
+        FreePage* free_pages = nullptr;
+        Statistics statistics;
+    };
+
+private:
+    mutable core::Lock<Inner> m_inner;
+
+public:
+    PagePool() noexcept = default;
+    ~PagePool() noexcept;
+    PagePool(const PagePool&) = delete;
+    PagePool& operator=(const PagePool&) = delete;
+
+public:
+    /// Returns the pool of the calling thread.
+    [[nodiscard]] static const core::SharedPtr<PagePool>& get_thread_local() noexcept;
+
+    /// Returns statistics of all pools. `max_num_used_pages` is the highest number of
+    /// pages used at the same time by all threads.
+    [[nodiscard]] static Statistics get_global_statistics() noexcept;
+
+public:
+    /// Returns a page of `PAGE_SIZE` bytes, aligned to `alignof(std::max_align_t)`.
+    [[nodiscard]] void* acquire_page() noexcept;
+
+    /// Returns `page` to the pool. `page` must be acquired from this pool.
+    void release_page(void* const page) noexcept;
+
+    /// Allocates free pages, until the pool has at least `num_pages` pages.
+    void reserve(const usize num_pages) noexcept;
+
+    [[nodiscard]] Statistics get_statistics() const noexcept;
+};
+
+} // namespace tundra::core::memory
@@ -1,6 +1,92 @@
 #pragma once
+#include "core/core_export.h"
+#include "core/core.h"
+#include "core/macros.h"
 
-namespace tundra::core {
+#ifndef TNDR_ENABLE_PROFILER
+#define TNDR_ENABLE_PROFILER 0
+#endif
+
+namespace tundra::core::profiler {
+
+/// Returns nanoseconds elapsed since the profiler was started.
+[[nodiscard]] CORE_API u64 now() noexcept;
+
+/// Records a zone on the calling thread.
+///
+/// Every thread records into its own ring buffer, without locks. When a buffer is
+/// full, the oldest zones are overwritten.
+///
+/// # Params
+/// - name - Must outlive the profiler, e.g. a string literal.
+/// - begin - Value returned by `now()` when the zone started.
+/// - end - Value returned by `now()` when the zone ended.
+CORE_API void record_zone(const char* name, const u64 begin, const u64 end) noexcept;
+
+/// Records an instant event on the calling thread.
+///
+/// # Params
+/// - scope, name - Must outlive the profiler, e.g. string literals.
+CORE_API void record_event(const char* scope, const char* name) noexcept;
+
+/// Marks the start of a frame.
+CORE_API void new_frame(const u64 frame) noexcept;
+
+/// Writes zones, events and frame markers, recorded by all threads, in the Chrome
+/// trace event format. The file can be opened in `chrome://tracing` or Perfetto.
+///
+/// Zones recorded while the trace is written may be missing.
+///
+/// Returns `false` when the file can not be written.
+[[nodiscard]] CORE_API bool export_chrome_trace(const char* path) noexcept;
+
+/// Records a zone from its construction to its destruction.
+class ScopedZone {
+private:
+    const char* m_name;
+    u64 m_begin;
+    bool m_enabled;
+
+public:
+    explicit ScopedZone(const char* name, const bool enabled = true) noexcept
+        : m_name(name)
+        , m_begin(enabled ? profiler::now() : 0)
+        , m_enabled(enabled)
+    {
+    }
+
+    ~ScopedZone() noexcept
+    {
+        if (m_enabled) {
+            profiler::record_zone(m_name, m_begin, profiler::now());
+        }
+    }
+
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+};
+
+} // namespace tundra::core::profiler
+
+#if TNDR_ENABLE_PROFILER
+
+///
+#define TNDR_PROFILER_TRACE(name)                                                        \
+    const tundra::core::profiler::ScopedZone TNDR_APPEND(tndr_profiler_zone_, __LINE__)( \
+        name)
+
+///
+#define TNDR_PROFILER_TRACE_IF(condition, name)                                          \
+    const tundra::core::profiler::ScopedZone TNDR_APPEND(tndr_profiler_zone_, __LINE__)( \
+        name, condition)
+
+///
+#define TNDR_PROFILER_EVENT(scope, name) tundra::core::profiler::record_event(scope, name)
+
+///
+#define TNDR_PROFILER_NEW_FRAME(frame) tundra::core::profiler::new_frame(frame)
+
+#else
 
 ///
 #define TNDR_PROFILER_TRACE(name) (void)0
@@ -14,4 +100,4 @@ namespace tundra::core {
 ///
 #define TNDR_PROFILER_NEW_FRAME(frame) (void)0
 
-} // namespace tundra::core
+#endif // TNDR_ENABLE_PROFILER
@@ -0,0 +1,68 @@
+#pragma once
+#include "core/core.h"
+#include "core/std/option.h"
+#include "core/std/utils.h"
+#include <atomic>
+
+namespace tundra::core {
+
+/// A bounded single-producer single-consumer queue.
+///
+/// `push` is called by one thread, and `pop` by one other thread. Both block when
+/// the queue is full or empty, respectively, so the producer can be at most `CAPACITY`
+/// elements ahead of the consumer.
+template <typename T, usize CAPACITY>
+class SpscQueue {
+private:
+    static_assert(CAPACITY > 0, "`CAPACITY` must be greater than zero.");
+
+    /// Index of the next element to pop. Written only by the consumer.
+    alignas(64) std::atomic<usize> m_head = 0;
+    /// Index of the next element to push. Written only by the producer.
+    alignas(64) std::atomic<usize> m_tail = 0;
+    core::Option<T> m_elements[CAPACITY];
+
+public:
+    SpscQueue() noexcept = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+public:
+    /// Waits until there is space in the queue, and pushes `value`.
+    void push(T value) noexcept
+    {
+        const usize tail = m_tail.load(std::memory_order_relaxed);
+
+        usize head = m_head.load(std::memory_order_acquire);
+        while ((tail - head) == CAPACITY) {
+            m_head.wait(head, std::memory_order_acquire);
+            head = m_head.load(std::memory_order_acquire);
+        }
+
+        m_elements[tail % CAPACITY] = core::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        m_tail.notify_one();
+    }
+
+    /// Waits until the queue is not empty, and pops the oldest element.
+    [[nodiscard]] T pop() noexcept
+    {
+        const usize head = m_head.load(std::memory_order_relaxed);
+
+        usize tail = m_tail.load(std::memory_order_acquire);
+        while (tail == head) {
+            m_tail.wait(tail, std::memory_order_acquire);
+            tail = m_tail.load(std::memory_order_acquire);
+        }
+
+        core::Option<T>& element = m_elements[head % CAPACITY];
+        T value = core::move(*element);
+        element = std::nullopt;
+
+        m_head.store(head + 1, std::memory_order_release);
+        m_head.notify_one();
+        return value;
+    }
+};
+
+} // namespace tundra::core
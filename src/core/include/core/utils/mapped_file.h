@@ -0,0 +1,44 @@
+#pragma once
+#include "core/core_export.h"
+#include "core/core.h"
+#include "core/std/option.h"
+#include "core/std/span.h"
+#include <filesystem>
+
+namespace tundra::core {
+
+/// A read-only view of a whole file, mapped into memory.
+///
+/// Pages are read by the OS when they are first accessed, so opening a file does not
+/// read nor copy it. The view stays valid until the `MappedFile` is destroyed.
+class CORE_API MappedFile {
+private:
+    const char* m_data = nullptr;
+    usize m_size = 0;
+#if TNDR_PLATFORM_WINDOWS
+    /// `HANDLE` of the file mapping.
+    void* m_mapping = nullptr;
+#endif
+
+public:
+    /// Returns `None` when the file can't be opened or mapped.
+    [[nodiscard]] static core::Option<MappedFile> open(
+        const std::filesystem::path& path) noexcept;
+
+    ~MappedFile() noexcept;
+    MappedFile(MappedFile&& rhs) noexcept;
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+private:
+    MappedFile() noexcept = default;
+
+public:
+    [[nodiscard]] core::Span<const char> get_data() const noexcept;
+
+private:
+    void unmap() noexcept;
+};
+
+} // namespace tundra::core
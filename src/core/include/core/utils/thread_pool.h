@@ -0,0 +1,78 @@
+#pragma once
+#include "core/core_export.h"
+#include "core/core.h"
+#include "core/std/containers/array.h"
+#include "core/std/containers/deque.h"
+#include "core/std/function.h"
+#include "core/std/traits/is_callable.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <latch>
+#include <mutex>
+#include <thread>
+
+namespace tundra::core {
+
+/// A fixed number of worker threads executing tasks in FIFO order.
+class CORE_API ThreadPool {
+private:
+    core::Array<std::thread> m_threads;
+    core::Deque<core::Function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop = false;
+
+public:
+    /// # Params
+    /// - num_threads - Number of worker threads.
+    ///     When `0`, one less than the number of hardware threads is used.
+    explicit ThreadPool(const usize num_threads = 0) noexcept;
+    ~ThreadPool() noexcept;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+    /// Enqueues a task.
+    void push(core::Function<void()> task) noexcept;
+
+    /// Calls `func(i)` for every `i` in `[0, count)`, and waits until all calls return.
+    /// The calling thread takes part in the work.
+    ///
+    /// Must not be called from a worker thread of the same pool.
+    template <traits::callable<usize> Func>
+    void parallel_for(const usize count, Func&& func) noexcept
+    {
+        if (count == 0) {
+            return;
+        }
+
+        const usize num_helpers = std::min(m_threads.size(), count - 1);
+        std::atomic<usize> next_index = 0;
+        std::latch helpers_done(static_cast<std::ptrdiff_t>(num_helpers));
+
+        const auto work = [&] {
+            for (usize i = next_index.fetch_add(1); i < count;
+                 i = next_index.fetch_add(1)) {
+                func(i);
+            }
+        };
+
+        for (usize i = 0; i < num_helpers; ++i) {
+            this->push([&] {
+                work();
+                helpers_done.count_down();
+            });
+        }
+
+        work();
+        helpers_done.wait();
+    }
+
+    [[nodiscard]] usize get_num_threads() const noexcept;
+
+private:
+    void worker_loop() noexcept;
+};
+
+} // namespace tundra::core
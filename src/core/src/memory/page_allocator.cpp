@@ -0,0 +1,108 @@
+#include "core/memory/page_allocator.h"
+#include "core/memory/pointer_math.h"
+#include "core/std/assert.h"
+#include "core/std/utils.h"
+#include <new>
+
+namespace tundra::core::memory {
+
+PageAllocator::PageAllocator() noexcept
+    : PageAllocator(PagePool::get_thread_local())
+{
+}
+
+PageAllocator::PageAllocator(core::SharedPtr<PagePool> pool) noexcept
+    : m_pool(core::move(pool))
+{
+}
+
+PageAllocator::~PageAllocator() noexcept
+{
+    this->reset();
+}
+
+PageAllocator::PageAllocator(PageAllocator&& rhs) noexcept
+    : m_pool(core::move(rhs.m_pool))
+    , m_first_page(core::exchange(rhs.m_first_page, nullptr))
+    , m_current_page(core::exchange(rhs.m_current_page, nullptr))
+    , m_offset(core::exchange(rhs.m_offset, 0u))
+{
+}
+
+PageAllocator& PageAllocator::operator=(PageAllocator&& rhs) noexcept
+{
+    if (&rhs != this) {
+        this->reset();
+
+        m_pool = core::move(rhs.m_pool);
+        m_first_page = core::exchange(rhs.m_first_page, nullptr);
+        m_current_page = core::exchange(rhs.m_current_page, nullptr);
+        m_offset = core::exchange(rhs.m_offset, 0u);
+    }
+
+    return *this;
+}
+
+void* PageAllocator::alloc(
+    const usize size, const usize alignment /*= alignof(std::max_align_t)*/)
+{
+    if (m_current_page != nullptr) {
+        char* const page = reinterpret_cast<char*>(m_current_page);
+        char* const ptr = pointer_math::align(
+            pointer_math::add(page, m_offset), alignment);
+        const usize new_offset = static_cast<usize>(ptr - page) + size;
+
+        if (new_offset <= m_current_page->size) {
+            m_offset = new_offset;
+            return ptr;
+        }
+    }
+
+    // The worst case size of the allocation in a new page.
+    const usize required_size = sizeof(Page) + alignment + size;
+    const bool is_pooled = required_size <= PagePool::PAGE_SIZE;
+    void* const memory = is_pooled ? m_pool->acquire_page() : new char[required_size];
+
+    Page* const page = new (memory) Page {
+        .next = nullptr,
+        .size = is_pooled ? PagePool::PAGE_SIZE : required_size,
+    };
+
+    if (m_current_page != nullptr) {
+        m_current_page->next = page;
+    } else {
+        m_first_page = page;
+    }
+    m_current_page = page;
+    m_offset = sizeof(Page);
+
+    return this->alloc(size, alignment);
+}
+
+void PageAllocator::free(void* const ptr)
+{
+    // noop
+    (void)ptr;
+}
+
+void PageAllocator::reset() noexcept
+{
+    Page* page = m_first_page;
+    while (page != nullptr) {
+        Page* const next = page->next;
+
+        if (page->size == PagePool::PAGE_SIZE) {
+            m_pool->release_page(page);
+        } else {
+            delete[] reinterpret_cast<char*>(page);
+        }
+
+        page = next;
+    }
+
+    m_first_page = nullptr;
+    m_current_page = nullptr;
+    m_offset = 0;
+}
+
+} // namespace tundra::core::memory
@@ -0,0 +1,115 @@
+#include "core/memory/page_pool.h"
+#include "core/std/assert.h"
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace tundra::core::memory {
+
+/// Statistics of all pools.
+static std::atomic<usize> g_num_pages = 0;
+static std::atomic<usize> g_num_used_pages = 0;
+static std::atomic<usize> g_max_num_used_pages = 0;
+
+PagePool::~PagePool() noexcept
+{
+    auto inner = m_inner.lock();
+    tndr_assert(
+        inner->statistics.num_used_pages == 0, "Pages must be released before the pool.");
+
+    while (inner->free_pages != nullptr) {
+        FreePage* const page = inner->free_pages;
+        inner->free_pages = page->next;
+        delete[] reinterpret_cast<char*>(page);
+    }
+
+    g_num_pages.fetch_sub(inner->statistics.num_pages, std::memory_order_relaxed);
+}
+
+const core::SharedPtr<PagePool>& PagePool::get_thread_local() noexcept
+{
+    // Allocators hold a reference to the pool, so it outlives the thread if they do.
+    static thread_local const core::SharedPtr<PagePool> pool =
+        core::make_shared<PagePool>();
+    return pool;
+}
+
+PagePool::Statistics PagePool::get_global_statistics() noexcept
+{
+    return Statistics {
+        .num_pages = g_num_pages.load(std::memory_order_relaxed),
+        .num_used_pages = g_num_used_pages.load(std::memory_order_relaxed),
+        .max_num_used_pages = g_max_num_used_pages.load(std::memory_order_relaxed),
+    };
+}
+
+void* PagePool::acquire_page() noexcept
+{
+    FreePage* page = nullptr;
+    {
+        auto inner = m_inner.lock();
+        Statistics& statistics = inner->statistics;
+        statistics.num_used_pages += 1;
+        statistics.max_num_used_pages = std::max(
+            statistics.max_num_used_pages, statistics.num_used_pages);
+
+        if (inner->free_pages != nullptr) {
+            page = inner->free_pages;
+            inner->free_pages = page->next;
+        } else {
+            statistics.num_pages += 1;
+        }
+    }
+
+    const usize num_used_pages =
+        g_num_used_pages.fetch_add(1, std::memory_order_relaxed) + 1;
+    usize max_num_used_pages = g_max_num_used_pages.load(std::memory_order_relaxed);
+    while (max_num_used_pages < num_used_pages &&
+           !g_max_num_used_pages.compare_exchange_weak(
+               max_num_used_pages, num_used_pages, std::memory_order_relaxed)) {
+    }
+
+    if (page != nullptr) {
+        return page;
+    }
+
+    // New pages are allocated outside of the lock.
+    g_num_pages.fetch_add(1, std::memory_order_relaxed);
+    return new char[PAGE_SIZE];
+}
+
+void PagePool::release_page(void* const page) noexcept
+{
+    tndr_assert(page != nullptr, "`page` must not be null.");
+
+    g_num_used_pages.fetch_sub(1, std::memory_order_relaxed);
+
+    auto inner = m_inner.lock();
+    tndr_assert(inner->statistics.num_used_pages > 0, "`page` is not used.");
+    inner->statistics.num_used_pages -= 1;
+
+    FreePage* const free_page = new (page) FreePage {
+        .next = inner->free_pages,
+    };
+    inner->free_pages = free_page;
+}
+
+void PagePool::reserve(const usize num_pages) noexcept
+{
+    auto inner = m_inner.lock();
+    while (inner->statistics.num_pages < num_pages) {
+        FreePage* const free_page = new (new char[PAGE_SIZE]) FreePage {
+            .next = inner->free_pages,
+        };
+        inner->free_pages = free_page;
+        inner->statistics.num_pages += 1;
+        g_num_pages.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PagePool::Statistics PagePool::get_statistics() const noexcept
+{
+    return m_inner.lock()->statistics;
+}
+
+} // namespace tundra::core::memory
@@ -1 +1,308 @@
 #include "core/profiler.h"
+#include "core/std/containers/array.h"
+#include "core/std/unique_ptr.h"
+#include <fmt/format.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+
+namespace tundra::core::profiler {
+
+namespace {
+
+/// Number of records kept per thread.
+constexpr u64 THREAD_BUFFER_CAPACITY = 1 << 16;
+/// Number of frame markers kept.
+constexpr u64 FRAME_BUFFER_CAPACITY = 1 << 12;
+
+enum class RecordType : u8 {
+    Zone,
+    Event,
+};
+
+struct Record {
+    const char* scope;
+    const char* name;
+    u64 begin;
+    u64 end;
+    RecordType type;
+};
+
+/// A record guarded by a sequence lock, so it can be copied while its thread overwrites
+/// it. Fields are atomics, so a copy that overlaps a write is detected by the sequence,
+/// without a data race.
+struct RecordSlot {
+    /// `2 * index + 2` once record `index` is written, and odd while it is written.
+    std::atomic<u64> sequence = 0;
+    std::atomic<const char*> scope = nullptr;
+    std::atomic<const char*> name = nullptr;
+    std::atomic<u64> begin = 0;
+    std::atomic<u64> end = 0;
+    std::atomic<RecordType> type = RecordType::Zone;
+};
+
+/// A ring buffer written only by its thread.
+struct ThreadBuffer {
+    u32 thread_index;
+    /// Number of records written since the thread was registered.
+    std::atomic<u64> num_records = 0;
+    std::array<RecordSlot, THREAD_BUFFER_CAPACITY> records;
+};
+
+struct FrameMarker {
+    u64 frame;
+    u64 time;
+};
+
+struct Profiler {
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    /// Guards `threads` and `frames`.
+    std::mutex mutex;
+    core::Array<core::UniquePtr<ThreadBuffer>> threads;
+    core::Array<FrameMarker> frames;
+    u64 num_frames = 0;
+};
+
+[[nodiscard]] Profiler& get_profiler() noexcept
+{
+    static Profiler s_profiler;
+    return s_profiler;
+}
+
+[[nodiscard]] ThreadBuffer* register_thread() noexcept
+{
+    Profiler& profiler = get_profiler();
+
+    core::UniquePtr<ThreadBuffer> buffer = core::make_unique<ThreadBuffer>();
+
+    std::scoped_lock lock(profiler.mutex);
+    buffer->thread_index = static_cast<u32>(profiler.threads.size());
+    return profiler.threads.emplace_back(core::move(buffer)).get();
+}
+
+[[nodiscard]] ThreadBuffer& get_thread_buffer() noexcept
+{
+    // Buffers are owned by the profiler, so records of finished threads are kept.
+    thread_local ThreadBuffer* t_buffer = register_thread();
+    return *t_buffer;
+}
+
+void push_record(const Record& record) noexcept
+{
+    ThreadBuffer& buffer = get_thread_buffer();
+
+    const u64 index = buffer.num_records.load(std::memory_order_relaxed);
+    RecordSlot& slot = buffer.records[index % THREAD_BUFFER_CAPACITY];
+
+    slot.sequence.store((2 * index) + 1, std::memory_order_relaxed);
+    // Orders the odd sequence before the fields, for readers that see new fields.
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.scope.store(record.scope, std::memory_order_relaxed);
+    slot.name.store(record.name, std::memory_order_relaxed);
+    slot.begin.store(record.begin, std::memory_order_relaxed);
+    slot.end.store(record.end, std::memory_order_relaxed);
+    slot.type.store(record.type, std::memory_order_relaxed);
+    slot.sequence.store((2 * index) + 2, std::memory_order_release);
+
+    buffer.num_records.store(index + 1, std::memory_order_release);
+}
+
+/// Copies records that were not overwritten while they were being copied.
+[[nodiscard]] core::Array<Record> read_records(const ThreadBuffer& buffer) noexcept
+{
+    const u64 end = buffer.num_records.load(std::memory_order_acquire);
+    const u64 begin = (end > THREAD_BUFFER_CAPACITY) ? (end - THREAD_BUFFER_CAPACITY)
+                                                     : 0;
+
+    core::Array<Record> records;
+    records.reserve(end - begin);
+    for (u64 i = begin; i < end; ++i) {
+        const RecordSlot& slot = buffer.records[i % THREAD_BUFFER_CAPACITY];
+
+        // Records that are overwritten, or being overwritten, by newer ones are skipped.
+        const u64 sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != ((2 * i) + 2)) {
+            continue;
+        }
+
+        const Record record {
+            .scope = slot.scope.load(std::memory_order_relaxed),
+            .name = slot.name.load(std::memory_order_relaxed),
+            .begin = slot.begin.load(std::memory_order_relaxed),
+            .end = slot.end.load(std::memory_order_relaxed),
+            .type = slot.type.load(std::memory_order_relaxed),
+        };
+
+        // Orders the copy before the second read of the sequence.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        records.push_back(record);
+    }
+
+    return records;
+}
+
+void write_escaped(fmt::memory_buffer& out, const char* str) noexcept
+{
+    for (const char* c = str; *c != '\0'; ++c) {
+        switch (*c) {
+            case '"':
+                fmt::format_to(fmt::appender(out), "\\\"");
+                break;
+            case '\\':
+                fmt::format_to(fmt::appender(out), "\\\\");
+                break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    fmt::format_to(
+                        fmt::appender(out), "\\u{:04x}", static_cast<u32>(*c));
+                } else {
+                    out.push_back(*c);
+                }
+                break;
+        }
+    }
+}
+
+[[nodiscard]] f64 to_microseconds(const u64 nanoseconds) noexcept
+{
+    return static_cast<f64>(nanoseconds) / 1000.0;
+}
+
+} // namespace
+
+u64 now() noexcept
+{
+    const auto elapsed = std::chrono::steady_clock::now() - get_profiler().epoch;
+    return static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void record_zone(const char* name, const u64 begin, const u64 end) noexcept
+{
+    push_record(Record {
+        .scope = nullptr,
+        .name = name,
+        .begin = begin,
+        .end = end,
+        .type = RecordType::Zone,
+    });
+}
+
+void record_event(const char* scope, const char* name) noexcept
+{
+    const u64 time = profiler::now();
+    push_record(Record {
+        .scope = scope,
+        .name = name,
+        .begin = time,
+        .end = time,
+        .type = RecordType::Event,
+    });
+}
+
+void new_frame(const u64 frame) noexcept
+{
+    const u64 time = profiler::now();
+
+    Profiler& profiler = get_profiler();
+    std::scoped_lock lock(profiler.mutex);
+
+    const FrameMarker marker {
+        .frame = frame,
+        .time = time,
+    };
+
+    if (profiler.frames.size() < FRAME_BUFFER_CAPACITY) {
+        profiler.frames.push_back(marker);
+    } else {
+        profiler.frames[profiler.num_frames % FRAME_BUFFER_CAPACITY] = marker;
+    }
+    profiler.num_frames += 1;
+}
+
+bool export_chrome_trace(const char* path) noexcept
+{
+    Profiler& profiler = get_profiler();
+
+    fmt::memory_buffer out;
+    fmt::format_to(fmt::appender(out), "{{\"traceEvents\":[\n");
+
+    bool is_first = true;
+    const auto begin_event = [&] {
+        if (!is_first) {
+            fmt::format_to(fmt::appender(out), ",\n");
+        }
+        is_first = false;
+    };
+
+    {
+        std::scoped_lock lock(profiler.mutex);
+
+        for (const core::UniquePtr<ThreadBuffer>& buffer : profiler.threads) {
+            begin_event();
+            fmt::format_to(
+                fmt::appender(out),
+                "{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":{},"
+                "\"args\":{{\"name\":\"Thread {}\"}}}}",
+                buffer->thread_index,
+                buffer->thread_index);
+
+            for (const Record& record : read_records(*buffer)) {
+                begin_event();
+                fmt::format_to(fmt::appender(out), "{{\"name\":\"");
+                write_escaped(out, record.name);
+
+                switch (record.type) {
+                    case RecordType::Zone:
+                        fmt::format_to(
+                            fmt::appender(out),
+                            "\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,"
+                            "\"tid\":{}}}",
+                            to_microseconds(record.begin),
+                            to_microseconds(record.end - record.begin),
+                            buffer->thread_index);
+                        break;
+                    case RecordType::Event:
+                        fmt::format_to(fmt::appender(out), "\",\"cat\":\"");
+                        write_escaped(out, record.scope);
+                        fmt::format_to(
+                            fmt::appender(out),
+                            "\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f},\"pid\":0,"
+                            "\"tid\":{}}}",
+                            to_microseconds(record.begin),
+                            buffer->thread_index);
+                        break;
+                }
+            }
+        }
+
+        for (const FrameMarker& marker : profiler.frames) {
+            begin_event();
+            fmt::format_to(
+                fmt::appender(out),
+                "{{\"name\":\"Frame {}\",\"ph\":\"i\",\"s\":\"g\",\"ts\":{:.3f},"
+                "\"pid\":0,\"tid\":0}}",
+                marker.frame,
+                to_microseconds(marker.time));
+        }
+    }
+
+    fmt::format_to(fmt::appender(out), "\n]}}\n");
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return file.good();
+}
+
+} // namespace tundra::core::profiler
@@ -0,0 +1,146 @@
+#include "core/utils/mapped_file.h"
+#include "core/std/utils.h"
+
+#if TNDR_PLATFORM_WINDOWS
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tundra::core {
+
+core::Option<MappedFile> MappedFile::open(const std::filesystem::path& path) noexcept
+{
+    MappedFile mapped_file;
+
+#if TNDR_PLATFORM_WINDOWS
+    const HANDLE file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return std::nullopt;
+    }
+
+    // Empty files can't be mapped.
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return mapped_file;
+    }
+
+    // The mapping keeps the file open.
+    const HANDLE mapping = CreateFileMappingW(
+        file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return std::nullopt;
+    }
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        CloseHandle(mapping);
+        return std::nullopt;
+    }
+
+    mapped_file.m_data = static_cast<const char*>(data);
+    mapped_file.m_size = static_cast<usize>(size.QuadPart);
+    mapped_file.m_mapping = mapping;
+#else
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file == -1) {
+        return std::nullopt;
+    }
+
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0) {
+        close(file);
+        return std::nullopt;
+    }
+
+    // Empty files can't be mapped.
+    if (file_stat.st_size == 0) {
+        close(file);
+        return mapped_file;
+    }
+
+    // The mapping keeps the file open.
+    void* data = mmap(
+        nullptr, static_cast<usize>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    mapped_file.m_data = static_cast<const char*>(data);
+    mapped_file.m_size = static_cast<usize>(file_stat.st_size);
+#endif
+
+    return mapped_file;
+}
+
+MappedFile::~MappedFile() noexcept
+{
+    this->unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept
+    : m_data(core::exchange(rhs.m_data, nullptr))
+    , m_size(core::exchange(rhs.m_size, usize(0)))
+#if TNDR_PLATFORM_WINDOWS
+    , m_mapping(core::exchange(rhs.m_mapping, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+    if (&rhs != this) {
+        this->unmap();
+        m_data = core::exchange(rhs.m_data, nullptr);
+        m_size = core::exchange(rhs.m_size, usize(0));
+#if TNDR_PLATFORM_WINDOWS
+        m_mapping = core::exchange(rhs.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+core::Span<const char> MappedFile::get_data() const noexcept
+{
+    return core::Span<const char>(m_data, m_size);
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_data == nullptr) {
+        return;
+    }
+
+#if TNDR_PLATFORM_WINDOWS
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+} // namespace tundra::core
@@ -0,0 +1,77 @@
+#include "core/utils/thread_pool.h"
+#include "core/profiler.h"
+#include "core/std/utils.h"
+
+namespace tundra::core {
+
+ThreadPool::ThreadPool(const usize num_threads) noexcept
+{
+    TNDR_PROFILER_TRACE("ThreadPool::ThreadPool");
+
+    const usize thread_count = [&]() -> usize {
+        if (num_threads != 0) {
+            return num_threads;
+        }
+
+        const usize hardware_threads = std::thread::hardware_concurrency();
+        return hardware_threads > 1 ? hardware_threads - 1 : 1;
+    }();
+
+    m_threads.reserve(thread_count);
+    for (usize i = 0; i < thread_count; ++i) {
+        m_threads.emplace_back([this] { this->worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    TNDR_PROFILER_TRACE("ThreadPool::~ThreadPool");
+
+    {
+        std::unique_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::push(core::Function<void()> task) noexcept
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_tasks.push_back(core::move(task));
+    }
+    m_condition.notify_one();
+}
+
+usize ThreadPool::get_num_threads() const noexcept
+{
+    return m_threads.size();
+}
+
+void ThreadPool::worker_loop() noexcept
+{
+    while (true) {
+        core::Function<void()> task;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+
+            // Remaining tasks are still executed.
+            if (m_stop && m_tasks.empty()) {
+                return;
+            }
+
+            task = core::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+} // namespace tundra::core
@@ -28,6 +28,10 @@ public:
     [[nodiscard]] BufferHandle create_buffer(
         const core::String& name, const BufferCreateInfo& create_info) noexcept;
 
+    /// Declares that the pass executes recorded bundles. Bundles can't be executed
+    /// inside queries, so pipeline statistics of the pass are not counted.
+    void use_recorded_bundles() noexcept;
+
 public:
     ///
     template <ResourceType Type, typename ResourceUsage>
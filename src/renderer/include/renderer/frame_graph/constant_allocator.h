@@ -0,0 +1,76 @@
+#pragma once
+#include "renderer/renderer_export.h"
+#include "core/core.h"
+#include "core/std/span.h"
+#include "rhi/config.h"
+#include "rhi/resources/handle.h"
+#include <atomic>
+#include <type_traits>
+
+namespace tundra::rhi {
+class IRHIContext;
+} // namespace tundra::rhi
+
+namespace tundra::renderer::frame_graph {
+
+/// Linear allocator of constants read by shaders with
+/// `rhi::CommandEncoder::push_constants`.
+///
+/// Constants are written straight into a persistently mapped `MemoryType::Dynamic`
+/// buffer, which is split into `NUM_REGIONS` regions used by consecutive frames.
+/// There is one more region than frames in flight, so the region written while a frame
+/// is recorded is never read by a frame that is still in flight.
+///
+/// `allocate` is thread safe, so it can be called by passes recorded on worker threads.
+class RENDERER_API ConstantAllocator {
+public:
+    ///
+    static constexpr u32 NUM_REGIONS = rhi::config::MAX_FRAMES_IN_FLIGHT + 1;
+    /// Satisfies offset alignment requirements of uniform and storage buffers.
+    static constexpr u64 ALIGNMENT = 256;
+    ///
+    static constexpr u64 DEFAULT_REGION_SIZE = 1024 * 1024;
+
+private:
+    rhi::BufferHandle m_buffer;
+    core::Span<char> m_memory;
+    u64 m_region_size;
+    /// Offset of the region used by the current frame.
+    u64 m_region_offset = 0;
+    /// Number of bytes allocated in the current region.
+    std::atomic<u64> m_num_allocated_bytes = 0;
+
+public:
+    ConstantAllocator(rhi::IRHIContext* context, const u64 region_size) noexcept;
+    ConstantAllocator(const ConstantAllocator&) = delete;
+    ConstantAllocator& operator=(const ConstantAllocator&) = delete;
+
+public:
+    /// Starts allocating from the region of the frame `frame_index`.
+    /// Must not be called while passes are recorded.
+    void begin_frame(const u64 frame_index) noexcept;
+
+    /// Destroys the buffer.
+    void destroy(rhi::IRHIContext* context) noexcept;
+
+    /// Copies `data` into the buffer, and returns its offset in the buffer.
+    [[nodiscard]] u32 allocate(const core::Span<const char> data) noexcept;
+
+    /// # Example:
+    /// ```
+    /// const u32 offset = registry.get_constant_allocator().allocate(ubo);
+    /// encoder.push_constants(registry.get_constant_allocator().get_buffer(), offset);
+    /// ```
+    template <typename T>
+    [[nodiscard]] u32 allocate(const T& value) noexcept
+    {
+        static_assert(
+            std::is_trivially_copyable_v<T>, "`T` must be trivially copyable.");
+        return this->allocate(core::as_byte_span(value));
+    }
+
+public:
+    [[nodiscard]] rhi::BufferHandle get_buffer() const noexcept;
+};
+
+} // namespace tundra::renderer::frame_graph
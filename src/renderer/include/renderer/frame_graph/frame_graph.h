@@ -11,18 +11,29 @@
 #include "core/std/tuple.h"
 #include "core/std/unique_ptr.h"
 #include "renderer/frame_graph/builder.h"
+#include "renderer/frame_graph/constant_allocator.h"
 #include "renderer/frame_graph/enums.h"
 #include "renderer/frame_graph/present_pass.h"
+#include "renderer/frame_graph/recorded_bundle_cache.h"
 #include "renderer/frame_graph/registry.h"
 #include "renderer/frame_graph/render_pass.h"
 #include "renderer/frame_graph/resources/barrier.h"
 #include "renderer/frame_graph/resources/base_resource.h"
 #include "renderer/frame_graph/resources/enums.h"
+#include "renderer/frame_graph/transient_resource_allocator.h"
+#include "rhi/config.h"
 #include "rhi/queue.h"
+#include "rhi/resources/handle.h"
+#include "rhi/submit_info.h"
+
+namespace tundra::core {
+class ThreadPool;
+} // namespace tundra::core
 
 namespace tundra::rhi {
 class IRHIContext;
 class CommandEncoder;
+class UploadService;
 } // namespace tundra::rhi
 
 namespace tundra::renderer::frame_graph {
@@ -39,6 +50,16 @@ concept render_pass_setup = core::traits::callable<Func, Builder&, RenderPass&>;
 
 } // namespace concepts
 
+/// GPU time of a pass.
+struct PassTiming {
+    core::String name;
+    QueueType queue_type;
+    /// Nanoseconds.
+    u64 duration;
+    /// Counted only for passes on `QueueType::Graphics`.
+    core::Option<rhi::PipelineStatistics> pipeline_statistics;
+};
+
 ///
 class RENDERER_API FrameGraph {
 private:
@@ -47,6 +68,18 @@ private:
         core::HashMap<ResourceId, ResourceUsage> reads;
         core::HashMap<ResourceId, ResourceUsage> writes;
         core::HashSet<ResourceId> creates;
+        /// Passes that have to be executed before this pass.
+        core::HashSet<RenderPassId> dependencies;
+        /// See `Builder::use_recorded_bundles`.
+        bool uses_recorded_bundles = false;
+    };
+
+    /// Accesses of a resource, in the order in which passes were added.
+    struct ResourceAccesses {
+        /// The creator, or the last pass that wrote to the resource.
+        RenderPassId last_writer = NULL_RENDER_PASS_ID;
+        /// Passes that read the resource after `last_writer`.
+        core::Array<RenderPassId> readers;
     };
 
     ///
@@ -63,6 +96,20 @@ private:
         Barrier<core::Option<GlobalBarrier>> global_barrier;
         Barrier<core::Array<TextureBarrier>> texture_barriers;
         Barrier<core::Array<BufferBarrier>> buffer_barriers;
+        /// Split barriers (indices into `m_split_barriers`) set after a render pass.
+        core::Array<u32> set_events;
+        /// Split barriers (indices into `m_split_barriers`) waited for before a render pass.
+        core::Array<u32> wait_events;
+    };
+
+    /// Barrier between two passes on the same queue, with other passes executed between
+    /// them. It is set after `producer`, and waited for before `consumer`, so
+    /// the passes in between are not blocked by it.
+    struct SplitBarrier {
+        RenderPassId producer;
+        RenderPassId consumer;
+        core::Option<GlobalBarrier> global_barrier;
+        core::Array<TextureBarrier> texture_barriers;
     };
 
     ///
@@ -71,27 +118,104 @@ private:
         core::Array<RenderPassId> passes;
     };
 
+    /// Passes of one dependency level running on the same queue.
+    /// They are independent, so they are recorded into one encoder.
+    struct PassBatch {
+        QueueType queue_type;
+        core::Array<RenderPassId> passes;
+    };
+
+    /// Batches submitted together to one queue.
+    struct Submission {
+        QueueType queue_type;
+        /// Indices into `m_pass_batches`, in the execution order.
+        core::Array<usize> batches;
+        /// Earlier submissions, on other queues, that must finish
+        /// before this submission starts.
+        core::Array<usize> wait_submissions;
+    };
+
+    /// A pass measured by timestamp queries `2 * i` and `2 * i + 1`,
+    /// where `i` is its index.
+    struct TimedPass {
+        core::String name;
+        QueueType queue_type;
+        core::Option<u32> pipeline_statistics_query;
+    };
+
+    /// Number of readback buffers of a readback. One more than frames in flight,
+    /// so the buffer read after a submit is never the one written by it.
+    static constexpr u32 NUM_READBACK_BUFFERS = rhi::config::MAX_FRAMES_IN_FLIGHT + 1;
+
+    /// A range of a buffer copied to the host every frame it is added.
+    struct Readback {
+        u64 size = 0;
+        rhi::BufferHandle buffers[NUM_READBACK_BUFFERS];
+        /// Frames (`m_frame_index`) that wrote to `buffers`.
+        core::Option<u64> frames[NUM_READBACK_BUFFERS];
+        core::Option<core::Array<char>> data;
+    };
+
     Registry m_registry;
     core::Array<core::UniquePtr<IBaseResource>> m_resources;
+    core::Array<ResourceAccesses> m_resources_accesses;
     core::Array<core::UniquePtr<IFrameGraphPass>> m_render_passes;
     core::Array<PresentPass> m_present_passes;
     core::Array<RenderPassResources> m_render_passes_resources;
-    core::Array<RenderPassBarriers> m_render_passes_barriers;
+    core::HashSet<ResourceId> m_exported_resources;
+    /// Passes added by `add_readback`. They are never culled.
+    core::HashSet<RenderPassId> m_readback_passes;
 
+    // Compiled graph. Kept between frames, and rebuilt only when the key
+    // of the declared graph changes.
+    core::Option<core::Array<u64>> m_compiled_graph_key;
+    /// Key of the declared graph. A member, so its memory is reused between frames.
+    core::Array<u64> m_graph_key;
+    /// `true` for passes whose outputs are never consumed.
+    core::Array<bool> m_culled_passes;
+    core::Array<RenderPassBarriers> m_render_passes_barriers;
+    core::Array<core::Option<TextureBarrier>> m_present_passes_barriers;
+    /// Index of a split barrier is also its event.
+    core::Array<SplitBarrier> m_split_barriers;
     core::Array<core::Array<RenderPassId>> m_adjacency_list;
     core::Array<RenderPassId> m_topologically_sorted_passes;
     core::Array<DependencyLevel> m_dependency_levels;
+    core::Array<PassBatch> m_pass_batches;
+    core::Array<Submission> m_submissions;
 
+    rhi::IRHIContext* m_context;
+    core::ThreadPool* m_thread_pool = nullptr;
+    rhi::UploadService* m_upload_service = nullptr;
     rhi::QueueFamilyIndices m_queue_indices;
+    TransientResourceAllocator m_transient_resource_allocator;
+    ConstantAllocator m_constant_allocator;
+    RecordedBundleCache m_recorded_bundle_cache;
+
+    /// Timed passes of frames in flight, indexed by `m_frame_index`.
+    core::Array<TimedPass> m_timed_passes[rhi::config::MAX_FRAMES_IN_FLIGHT];
+    core::Array<PassTiming> m_pass_timings;
+    core::HashMap<core::String, Readback> m_readbacks;
+    u64 m_frame_index = 0;
 
 private:
     friend class Builder;
 
 public:
-    FrameGraph(const rhi::IRHIContext* context) noexcept;
+    FrameGraph(rhi::IRHIContext* context) noexcept;
+    ~FrameGraph() noexcept;
     FrameGraph(const FrameGraph&) = delete;
     FrameGraph& operator=(const FrameGraph&) = delete;
 
+public:
+    /// When set, passes are recorded on worker threads of the `thread_pool`.
+    /// Execute functions of passes must be thread safe then.
+    /// `nullptr` records all passes on the calling thread.
+    void set_thread_pool(core::ThreadPool* thread_pool) noexcept;
+
+    /// When set, [`FrameGraph::execute`] flushes the `upload_service`, and submits its
+    /// work before the passes.
+    void set_upload_service(rhi::UploadService* upload_service) noexcept;
+
 public:
     /// # Params
     /// - execute - Execute function must capture all variables by value.
@@ -121,7 +245,6 @@ public:
         TNDR_PROFILER_TRACE("FrameGraph::add_pass");
 
         m_render_passes_resources.push_back({});
-        m_render_passes_barriers.push_back({});
         Builder builder(*this, RenderPassId { static_cast<u32>(m_render_passes.size()) });
         Data data = setup(builder);
         m_render_passes.push_back(core::make_unique<FrameGraphPass<Data, Execute>>(
@@ -231,7 +354,6 @@ public:
         TNDR_PROFILER_TRACE("FrameGraph::add_render_pass");
 
         m_render_passes_resources.push_back({});
-        m_render_passes_barriers.push_back({});
         Builder builder(*this, RenderPassId { static_cast<u32>(m_render_passes.size()) });
         RenderPass render_pass {};
         Data data = setup(builder, render_pass);
@@ -247,24 +369,75 @@ public:
     void add_present_pass(
         const rhi::SwapchainHandle swapchain, const TextureHandle texture) noexcept;
 
+    /// Marks a resource as an output of the graph.
+    /// Passes writing to exported resources are never culled.
+    template <ResourceType Type, typename ResourceUsage>
+    void export_resource(const Handle<Type, ResourceUsage> handle) noexcept
+    {
+        tndr_assert(handle.is_valid(), "`handle` must be a valid handle");
+        m_exported_resources.insert(handle.handle);
+    }
+
+    /// Copies `size` bytes at `offset` of `buffer` to the host, without stalling.
+    /// The copy is returned by [`FrameGraph::get_readback`] after
+    /// `rhi::config::MAX_FRAMES_IN_FLIGHT` frames, e.g. to read GPU culling counters.
+    ///
+    /// `buffer` must be readable with `BufferResourceUsage::TRANSFER`.
+    void add_readback(
+        const core::String& name,
+        const BufferHandle buffer,
+        const u64 offset,
+        const u64 size) noexcept;
+
 public:
+    /// Compiles the graph. When passes, resources and their usages are the same
+    /// as in the previous frame, the previously compiled graph is reused.
     void compile() noexcept;
     void execute(rhi::IRHIContext* context) noexcept;
+    /// Clears all passes and resources. The compiled graph is kept.
     void reset() noexcept;
 
+    /// Returns GPU times of passes executed `rhi::config::MAX_FRAMES_IN_FLIGHT` frames
+    /// ago, in the execution order. Timestamps are read without waiting for the GPU,
+    /// so passes that did not finish yet are missing.
+    ///
+    /// Passes on `QueueType::Transfer` are not measured. Results are valid only when
+    /// the frame graph is the only one submitting work to its context.
+    [[nodiscard]] const core::Array<PassTiming>& get_pass_timings() const noexcept;
+
+    /// Returns the latest completed copy of a readback added with `name`,
+    /// or `nullptr` when no copy has completed yet.
+    [[nodiscard]] const core::Array<char>* get_readback(
+        const core::String& name) const noexcept;
+
 private:
+    /// Appends everything that affects the compiled graph to `key`, in a canonical order.
+    /// Keys are compared whole, so different graphs never share a compiled graph.
+    void build_graph_key(core::Array<u64>& key) const noexcept;
+
+    void cull_passes() noexcept;
     void build_adjacency_list() noexcept;
     void topological_sort() noexcept;
     void build_dependency_levels() noexcept;
+    void build_transient_resources() noexcept;
+    /// Barriers between passes on the same queue, with other passes executed between
+    /// them, are split into `m_split_barriers`.
     void build_barriers() noexcept;
+    /// Groups passes into submissions, and derives semaphore waits between queues
+    /// from dependencies between passes.
+    void build_submissions() noexcept;
+    void build_render_passes() noexcept;
 
 private:
+    /// Adds a barrier to `global_barrier` or `texture_barriers`,
+    /// depending on the resource type and usages.
     void insert_barrier(
         const ResourceId resource_id,
         const core::Tuple<ResourceUsage, bool>& previous_usage,
-        const RenderPassId pass_id,
         const core::Tuple<ResourceUsage, bool>& next_usage,
-        const bool discard_contents) noexcept;
+        const bool discard_contents,
+        core::Option<GlobalBarrier>& global_barrier,
+        core::Array<TextureBarrier>& texture_barriers) noexcept;
 
     void queue_ownership_transfer(
         const ResourceId resource_id,
@@ -283,6 +456,9 @@ private:
     [[nodiscard]] RenderPassResources& get_render_pass_resources(
         const RenderPassId render_pass) noexcept;
 
+    [[nodiscard]] ResourceAccesses& get_resource_accesses(
+        const ResourceId resource) noexcept;
+
     [[nodiscard]] TextureHandle create_texture(
         const RenderPassId creator,
         const core::String& name,
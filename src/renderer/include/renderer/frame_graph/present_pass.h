@@ -12,7 +12,6 @@ namespace tundra::renderer::frame_graph {
 struct RENDERER_API PresentPass {
     rhi::SwapchainHandle swapchain;
     TextureHandle texture;
-    core::Option<TextureBarrier> barrier;
 
     static constexpr TextureAccessFlags ACCESS_FLAGS =
         rhi::TextureAccessFlags::TRANSFER_SOURCE;
@@ -0,0 +1,154 @@
+#pragma once
+#include "renderer/renderer_export.h"
+#include "core/core.h"
+#include "core/std/containers/array.h"
+#include "core/std/containers/hash_map.h"
+#include "core/std/containers/string.h"
+#include "core/std/option.h"
+#include "core/std/span.h"
+#include "core/std/sync/lock.h"
+#include "rhi/commands/command_encoder.h"
+#include "rhi/config.h"
+#include "rhi/enums.h"
+#include "rhi/resources/handle.h"
+#include "rhi/rhi_context.h"
+
+namespace tundra::renderer::frame_graph {
+
+/// Recorded bundles of passes whose commands only change when their inputs change,
+/// e.g. passes that initialize counters and indirect arguments.
+///
+/// A bundle is recorded once for a `(name, key, constants)` tuple, and executed
+/// by the following frames with `rhi::CommandEncoder::execute_recorded_bundle`.
+/// Transient resources rotate between frames in flight, so a few bundles are kept
+/// per name, and the least recently used one is destroyed when there are too many.
+///
+/// `get_or_record` is thread safe, so it can be called by passes recorded on worker
+/// threads.
+///
+/// Passes executing bundles must call `Builder::use_recorded_bundles` when they are
+/// set up.
+class RENDERER_API RecordedBundleCache {
+public:
+    ///
+    static constexpr usize MAX_BUNDLES_PER_NAME = rhi::config::MAX_FRAMES_IN_FLIGHT + 1;
+
+private:
+    ///
+    struct Entry {
+        core::Array<u64> key;
+        core::Array<char> constants;
+        rhi::RecordedBundleHandle bundle;
+        /// Holds `constants`, read by the bundle at offset `0`. Null without constants.
+        rhi::BufferHandle constants_buffer;
+        /// Value of `Inner::num_uses` when the bundle was last returned.
+        u64 last_use = 0;
+    };
+
+    ///
+    struct Inner {
+        core::HashMap<core::String, core::Array<Entry>> entries;
+        u64 num_uses = 0;
+    };
+
+private:
+    core::Lock<Inner> m_inner;
+
+public:
+    RecordedBundleCache() noexcept = default;
+    RecordedBundleCache(const RecordedBundleCache&) = delete;
+    RecordedBundleCache& operator=(const RecordedBundleCache&) = delete;
+
+public:
+    /// Destroys all bundles.
+    void destroy(rhi::IRHIContext* context) noexcept;
+
+    /// Returns a bundle of commands recorded by `record(encoder, constants_buffer)`.
+    /// `record` is called only when there is no bundle for `name`, `key` and
+    /// `constants` yet. `constants` are copied to `constants_buffer` at offset `0`.
+    ///
+    /// `key` and `constants` must identify everything the commands depend on,
+    /// e.g. pipelines, resources and dispatch sizes.
+    ///
+    /// # Example:
+    /// ```
+    /// encoder.execute_recorded_bundle(registry.get_recorded_bundle_cache().get_or_record(
+    ///     context,
+    ///     "init",
+    ///     rhi::QueueType::Graphics,
+    ///     { pipeline.get_handle().get_id() },
+    ///     core::as_byte_span(ubo),
+    ///     [&](rhi::CommandEncoder& bundle_encoder, const rhi::BufferHandle constants_buffer) {
+    ///         bundle_encoder.push_constants(constants_buffer, 0);
+    ///         bundle_encoder.dispatch(pipeline, 1, 1, 1);
+    ///     }));
+    /// ```
+    template <typename Func>
+    [[nodiscard]] rhi::RecordedBundleHandle get_or_record(
+        rhi::IRHIContext* context,
+        const char* name,
+        const rhi::QueueType queue_type,
+        const core::Array<u64>& key,
+        const core::Span<const char> constants,
+        Func&& record) noexcept
+    {
+        auto inner = m_inner.lock();
+        core::Array<Entry>& entries = inner->entries[name];
+        inner->num_uses += 1;
+
+        if (const core::Option<rhi::RecordedBundleHandle> bundle = find(
+                entries, key, constants, inner->num_uses)) {
+            return *bundle;
+        }
+
+        const rhi::BufferHandle constants_buffer = create_constants_buffer(
+            context, name, constants);
+
+        rhi::CommandEncoder encoder;
+        encoder.begin_command_buffer();
+        record(encoder, constants_buffer);
+        encoder.end_command_buffer();
+
+        const rhi::RecordedBundleHandle bundle = context->create_recorded_bundle(
+            rhi::RecordedBundleCreateInfo {
+                .queue_type = queue_type,
+                .encoder = core::move(encoder),
+                .name = name,
+            });
+
+        insert(
+            context,
+            entries,
+            Entry {
+                .key = key,
+                .constants = core::Array<char>(constants.begin(), constants.end()),
+                .bundle = bundle,
+                .constants_buffer = constants_buffer,
+                .last_use = inner->num_uses,
+            });
+
+        return bundle;
+    }
+
+private:
+    [[nodiscard]] static core::Option<rhi::RecordedBundleHandle> find(
+        core::Array<Entry>& entries,
+        const core::Array<u64>& key,
+        const core::Span<const char> constants,
+        const u64 use) noexcept;
+
+    /// Destroys the least recently used entry, when there are too many.
+    static void insert(
+        rhi::IRHIContext* context,
+        core::Array<Entry>& entries,
+        Entry&& entry) noexcept;
+
+    [[nodiscard]] static rhi::BufferHandle create_constants_buffer(
+        rhi::IRHIContext* context,
+        const char* name,
+        const core::Span<const char> constants) noexcept;
+
+    static void destroy_entry(rhi::IRHIContext* context, const Entry& entry) noexcept;
+};
+
+} // namespace tundra::renderer::frame_graph
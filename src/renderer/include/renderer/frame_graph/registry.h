@@ -7,11 +7,16 @@
 
 namespace tundra::renderer::frame_graph {
 
+class ConstantAllocator;
+class RecordedBundleCache;
+
 ///
 class RENDERER_API Registry {
 private:
     core::HashMap<TextureHandle, rhi::TextureHandle> m_textures;
     core::HashMap<BufferHandle, rhi::BufferHandle> m_buffers;
+    ConstantAllocator* m_constant_allocator = nullptr;
+    RecordedBundleCache* m_recorded_bundle_cache = nullptr;
 
 public:
     void add_texture(
@@ -27,6 +32,10 @@ public:
         const TextureHandle fg_handle) const noexcept;
     [[nodiscard]] rhi::BufferHandle get_buffer(
         const BufferHandle fg_handle) const noexcept;
+    /// Allocator of constants of the current frame, see `ConstantAllocator`.
+    [[nodiscard]] ConstantAllocator& get_constant_allocator() const noexcept;
+    /// Bundles of passes whose commands repeat between frames, see `RecordedBundleCache`.
+    [[nodiscard]] RecordedBundleCache& get_recorded_bundle_cache() const noexcept;
 
 private:
     friend class FrameGraph;
@@ -46,6 +46,26 @@ public:
     [[nodiscard]] virtual const core::String& get_name() const noexcept final;
     [[nodiscard]] virtual ResourceType get_resource_type() const noexcept final;
     [[nodiscard]] virtual bool is_transient() const noexcept final;
+
+public:
+    [[nodiscard]] const BufferCreateInfo& get_create_info() const noexcept;
 };
 
 } // namespace tundra::renderer::frame_graph
+
+namespace tundra::core {
+
+template <>
+struct Hash<renderer::frame_graph::BufferCreateInfo> {
+    [[nodiscard]] usize operator()(
+        const renderer::frame_graph::BufferCreateInfo& create_info) const noexcept
+    {
+        usize seed = 0;
+        core::hash_and_combine(seed, create_info.usage);
+        core::hash_and_combine(seed, create_info.memory_type);
+        core::hash_and_combine(seed, create_info.size);
+        return seed;
+    }
+};
+
+} // namespace tundra::core
@@ -50,6 +50,7 @@ public:
     [[nodiscard]] virtual bool is_transient() const noexcept final;
 
 public:
+    [[nodiscard]] const TextureCreateInfo& get_create_info() const noexcept;
     [[nodiscard]] rhi::TextureUsageFlags get_usage_flags() const noexcept;
     [[nodiscard]] rhi::TextureFormat get_format() const noexcept;
     [[nodiscard]] rhi::TextureTiling get_tiling() const noexcept;
@@ -57,3 +58,28 @@ public:
 };
 
 } // namespace tundra::renderer::frame_graph
+
+namespace tundra::core {
+
+template <>
+struct Hash<renderer::frame_graph::TextureCreateInfo> {
+    [[nodiscard]] usize operator()(
+        const renderer::frame_graph::TextureCreateInfo& create_info) const noexcept
+    {
+        using TextureKind = renderer::frame_graph::TextureKind;
+
+        usize seed = 0;
+        core::hash_and_combine(seed, create_info.kind.index());
+        core::hash_and_combine(seed, TextureKind::get_extent(create_info.kind));
+        core::hash_and_combine(seed, TextureKind::get_sample_count(create_info.kind));
+        core::hash_and_combine(seed, TextureKind::get_num_layers(create_info.kind));
+        core::hash_and_combine(seed, TextureKind::get_num_mips(create_info.kind));
+        core::hash_and_combine(seed, create_info.memory_type);
+        core::hash_and_combine(seed, create_info.format);
+        core::hash_and_combine(seed, create_info.usage);
+        core::hash_and_combine(seed, create_info.tiling);
+        return seed;
+    }
+};
+
+} // namespace tundra::core
@@ -0,0 +1,135 @@
+#pragma once
+#include "renderer/renderer_export.h"
+#include "core/core.h"
+#include "core/std/containers/array.h"
+#include "core/std/containers/hash_map.h"
+#include "core/std/containers/string.h"
+#include "core/std/unique_ptr.h"
+#include "renderer/frame_graph/resources/base_resource.h"
+#include "renderer/frame_graph/resources/buffer.h"
+#include "renderer/frame_graph/resources/enums.h"
+#include "renderer/frame_graph/resources/texture.h"
+#include "rhi/resources/handle.h"
+
+namespace tundra::rhi {
+class IRHIContext;
+} // namespace tundra::rhi
+
+namespace tundra::renderer::frame_graph {
+
+class Registry;
+
+/// Maps transient frame graph resources to physical rhi resources.
+///
+/// Lifetimes of transient resources are measured in dependency levels.
+/// Resources in `MemoryType::GPU` memory, with compatible create infos and
+/// non-overlapping lifetimes, are packed into the same physical resource (a slot).
+/// Physical resources are pooled between frames, keyed by a hash of their create info,
+/// so in the steady state no resource is created nor destroyed. Pooled resources
+/// not used for `MAX_UNUSED_FRAMES` frames are destroyed.
+///
+/// Host visible resources are never aliased, because they are written by the host
+/// while passes are being recorded. They are also reused only after more than
+/// `rhi::config::MAX_FRAMES_IN_FLIGHT` frames.
+///
+/// Resources used outside of the graphics queue are treated the same way. Work on
+/// other queues overlaps graphics work of the same and the next frame, so neither
+/// aliasing nor reusing them in the next frame is ordered by barriers.
+class RENDERER_API TransientResourceAllocator {
+public:
+    /// First and last dependency level in which a resource is used.
+    struct Lifetime {
+        u32 first_level = ~0u;
+        u32 last_level = 0;
+        /// Used by a pass that does not run on the graphics queue.
+        bool is_async = false;
+    };
+
+    /// Dependency level of resources consumed after all passes (e.g. by a present pass).
+    static constexpr u32 END_OF_FRAME_LEVEL = ~0u;
+
+    /// Number of frames a pooled resource can stay unused before it is destroyed.
+    static constexpr u64 MAX_UNUSED_FRAMES = 8;
+
+private:
+    /// A physical resource shared by transient resources with disjoint lifetimes.
+    struct Slot {
+        ResourceType resource_type;
+        TextureCreateInfo texture_create_info;
+        BufferCreateInfo buffer_create_info;
+        core::String name;
+        u32 last_level = 0;
+        bool is_async = false;
+        ResourceId last_resource = NULL_RESOURCE_ID;
+        core::Array<ResourceId> resources;
+    };
+
+    /// A pooled texture. `last_used_frame` decides when it can be reused or destroyed.
+    struct PhysicalTexture {
+        rhi::TextureHandle handle;
+        TextureCreateInfo create_info;
+        u64 last_used_frame = 0;
+        bool is_async = false;
+    };
+
+    /// A pooled buffer. `last_used_frame` decides when it can be reused or destroyed.
+    struct PhysicalBuffer {
+        rhi::BufferHandle handle;
+        BufferCreateInfo create_info;
+        u64 last_used_frame = 0;
+        bool is_async = false;
+    };
+
+    core::Array<Slot> m_slots;
+    /// `resource -> previous resource placed in the same slot`.
+    core::HashMap<ResourceId, ResourceId> m_aliases;
+
+    /// `hash of a create info -> physical resources`.
+    core::HashMap<usize, core::Array<PhysicalTexture>> m_texture_pool;
+    core::HashMap<usize, core::Array<PhysicalBuffer>> m_buffer_pool;
+    u64 m_frame_index = 0;
+
+public:
+    TransientResourceAllocator() noexcept = default;
+    TransientResourceAllocator(const TransientResourceAllocator&) = delete;
+    TransientResourceAllocator& operator=(const TransientResourceAllocator&) = delete;
+
+public:
+    /// Assigns transient resources to slots.
+    ///
+    /// # Params
+    /// - resources - All frame graph resources.
+    /// - lifetimes - Lifetime of every resource in `resources`.
+    void plan(
+        const core::Array<core::UniquePtr<IBaseResource>>& resources,
+        const core::Array<Lifetime>& lifetimes) noexcept;
+
+    /// Binds every slot to a physical resource,
+    /// and registers transient resources in a `registry`.
+    void allocate(rhi::IRHIContext* context, Registry& registry) noexcept;
+
+    /// Ends the frame. Physical resources not used for `MAX_UNUSED_FRAMES` frames
+    /// are destroyed.
+    void release(rhi::IRHIContext* context) noexcept;
+
+    /// Destroys all physical resources.
+    void destroy(rhi::IRHIContext* context) noexcept;
+
+    /// Returns a resource that previously occupied the same physical resource in this frame.
+    [[nodiscard]] ResourceId get_aliased_resource(const ResourceId resource) const noexcept;
+
+    /// Clears per frame data.
+    void reset() noexcept;
+
+private:
+    [[nodiscard]] rhi::TextureHandle acquire_texture(
+        rhi::IRHIContext* context, const Slot& slot) noexcept;
+    [[nodiscard]] rhi::BufferHandle acquire_buffer(
+        rhi::IRHIContext* context, const Slot& slot) noexcept;
+    [[nodiscard]] bool is_reusable(
+        const u64 last_used_frame,
+        const MemoryType memory_type,
+        const bool is_async) const noexcept;
+};
+
+} // namespace tundra::renderer::frame_graph
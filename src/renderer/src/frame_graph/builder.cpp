@@ -34,6 +34,11 @@ BufferHandle Builder::create_buffer(
     return handle;
 }
 
+void Builder::use_recorded_bundles() noexcept
+{
+    m_frame_graph.get_render_pass_resources(m_render_pass).uses_recorded_bundles = true;
+}
+
 void Builder::read_impl(
     const ResourceId resource, const ResourceUsage resource_usage) noexcept
 {
@@ -45,6 +50,17 @@ void Builder::read_impl(
     } else {
         resources.reads.insert({ resource, resource_usage });
     }
+
+    // Read after write.
+    FrameGraph::ResourceAccesses& accesses = m_frame_graph.get_resource_accesses(resource);
+    if ((accesses.last_writer != NULL_RENDER_PASS_ID) &&
+        (accesses.last_writer != m_render_pass)) {
+        resources.dependencies.insert(accesses.last_writer);
+    }
+
+    if (accesses.readers.empty() || (accesses.readers.back() != m_render_pass)) {
+        accesses.readers.push_back(m_render_pass);
+    }
 }
 
 void Builder::write_impl(
@@ -58,6 +74,22 @@ void Builder::write_impl(
     } else {
         resources.writes.insert({ resource, resource_usage });
     }
+
+    // Write after read and write after write.
+    FrameGraph::ResourceAccesses& accesses = m_frame_graph.get_resource_accesses(resource);
+    for (const RenderPassId reader : accesses.readers) {
+        if (reader != m_render_pass) {
+            resources.dependencies.insert(reader);
+        }
+    }
+
+    if ((accesses.last_writer != NULL_RENDER_PASS_ID) &&
+        (accesses.last_writer != m_render_pass)) {
+        resources.dependencies.insert(accesses.last_writer);
+    }
+
+    accesses.last_writer = m_render_pass;
+    accesses.readers.clear();
 }
 
 } // namespace tundra::renderer::frame_graph
@@ -0,0 +1,63 @@
+#include "renderer/frame_graph/constant_allocator.h"
+#include "core/memory/pointer_math.h"
+#include "core/profiler.h"
+#include "core/std/assert.h"
+#include "core/std/panic.h"
+#include "rhi/rhi_context.h"
+#include <cstring>
+
+namespace tundra::renderer::frame_graph {
+
+ConstantAllocator::ConstantAllocator(
+    rhi::IRHIContext* context, const u64 region_size) noexcept
+    : m_region_size(region_size)
+{
+    TNDR_PROFILER_TRACE("ConstantAllocator::ConstantAllocator");
+
+    tndr_assert(
+        (region_size % ALIGNMENT) == 0, "`region_size` must be a multiple of ALIGNMENT.");
+
+    m_buffer = context->create_buffer(rhi::BufferCreateInfo {
+        .usage = rhi::BufferUsageFlags::UNIFORM_BUFFER |
+                 rhi::BufferUsageFlags::STORAGE_BUFFER,
+        .memory_type = rhi::MemoryType::Dynamic,
+        .size = region_size * NUM_REGIONS,
+        .name = "frame_graph_constants",
+    });
+    m_memory = context->map_buffer(m_buffer);
+}
+
+void ConstantAllocator::begin_frame(const u64 frame_index) noexcept
+{
+    m_region_offset = (frame_index % NUM_REGIONS) * m_region_size;
+    m_num_allocated_bytes.store(0, std::memory_order_relaxed);
+}
+
+void ConstantAllocator::destroy(rhi::IRHIContext* context) noexcept
+{
+    context->destroy_buffer(m_buffer);
+    m_buffer = {};
+    m_memory = {};
+}
+
+u32 ConstantAllocator::allocate(const core::Span<const char> data) noexcept
+{
+    const u64 size = (data.size() + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    const u64 offset = m_num_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if ((offset + size) > m_region_size) {
+        core::panic("Out of constant memory. Increase the region size.");
+    }
+
+    const u64 buffer_offset = m_region_offset + offset;
+    std::memcpy(
+        core::pointer_math::add(m_memory.data(), buffer_offset), data.data(), data.size());
+
+    return static_cast<u32>(buffer_offset);
+}
+
+rhi::BufferHandle ConstantAllocator::get_buffer() const noexcept
+{
+    return m_buffer;
+}
+
+} // namespace tundra::renderer::frame_graph
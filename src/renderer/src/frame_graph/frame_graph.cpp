@@ -4,23 +4,27 @@
 #include "core/std/containers/hash_set.h"
 #include "core/std/panic.h"
 #include "core/std/tuple.h"
+#include "core/utils/thread_pool.h"
 #include "renderer/frame_graph/resources/buffer.h"
 #include "renderer/frame_graph/resources/enums.h"
 #include "renderer/frame_graph/resources/texture.h"
 #include "rhi/commands/command_encoder.h"
 #include "rhi/resources/access_flags.h"
+#include "rhi/resources/buffer.h"
 #include "rhi/resources/texture.h"
 #include "rhi/rhi_context.h"
+#include "rhi/upload_service.h"
 #include <algorithm>
 #include <random>
 #include <stack>
 
 namespace tundra::renderer::frame_graph {
 
-static math::Vec3 get_random_color() noexcept
+/// Debug region color, stable between frames.
+static math::Vec3 get_pass_color(const RenderPassId pass_id) noexcept
 {
-    static std::mt19937 gen { 0 };
-    static std::uniform_real_distribution<f32> dis(0.f, 1.f);
+    std::mt19937 gen { static_cast<u32>(pass_id) };
+    std::uniform_real_distribution<f32> dis(0.f, 1.f);
     return math::Vec3 {
         dis(gen),
         dis(gen),
@@ -90,6 +94,19 @@ static math::Vec3 get_random_color() noexcept
     }
 }
 
+[[nodiscard]] static rhi::TextureBarrier translate_texture_barrier(
+    const Registry& registry, const TextureBarrier& barrier) noexcept
+{
+    return rhi::TextureBarrier {
+        .texture = registry.get_texture(TextureHandle { barrier.texture }),
+        .previous_access = barrier.previous_access,
+        .next_access = barrier.next_access,
+        .source_queue = map_fg_queue_to_rhi_queue(barrier.source_queue),
+        .destination_queue = map_fg_queue_to_rhi_queue(barrier.destination_queue),
+        .discard_contents = barrier.discard_contents,
+    };
+}
+
 void translate_barriers(
     const Registry& registry,
     rhi::CommandEncoder& encoder,
@@ -113,14 +130,7 @@ void translate_barriers(
         rhi_barriers.reserve(texture_barriers.size());
 
         for (const TextureBarrier& barrier : texture_barriers) {
-            rhi_barriers.push_back(rhi::TextureBarrier {
-                .texture = registry.get_texture(TextureHandle { barrier.texture }),
-                .previous_access = barrier.previous_access,
-                .next_access = barrier.next_access,
-                .source_queue = map_fg_queue_to_rhi_queue(barrier.source_queue),
-                .destination_queue = map_fg_queue_to_rhi_queue(barrier.destination_queue),
-                .discard_contents = barrier.discard_contents,
-            });
+            rhi_barriers.push_back(translate_texture_barrier(registry, barrier));
         }
 
         encoder.texture_barrier(core::move(rhi_barriers));
@@ -145,12 +155,65 @@ void translate_barriers(
     }
 }
 
+[[nodiscard]] static rhi::SplitBarrier translate_split_barrier(
+    const Registry& registry,
+    const u32 event,
+    const core::Option<GlobalBarrier>& global_barrier,
+    const core::Array<TextureBarrier>& texture_barriers) noexcept
+{
+    rhi::SplitBarrier split_barrier {
+        .event = event,
+    };
+
+    if (global_barrier.has_value()) {
+        split_barrier.global_barrier = rhi::GlobalBarrier {
+            .previous_access = global_barrier->previous_access,
+            .next_access = global_barrier->next_access,
+        };
+    }
+
+    split_barrier.texture_barriers.reserve(texture_barriers.size());
+    for (const TextureBarrier& barrier : texture_barriers) {
+        split_barrier.texture_barriers.push_back(
+            translate_texture_barrier(registry, barrier));
+    }
+
+    return split_barrier;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // FrameGraph
 
-FrameGraph::FrameGraph(const rhi::IRHIContext* context) noexcept
-    : m_queue_indices(context->get_queue_family_indices())
+FrameGraph::FrameGraph(rhi::IRHIContext* context) noexcept
+    : m_context(context)
+    , m_queue_indices(context->get_queue_family_indices())
+    , m_constant_allocator(context, ConstantAllocator::DEFAULT_REGION_SIZE)
+{
+    m_registry.m_constant_allocator = &m_constant_allocator;
+    m_registry.m_recorded_bundle_cache = &m_recorded_bundle_cache;
+}
+
+FrameGraph::~FrameGraph() noexcept
+{
+    m_transient_resource_allocator.destroy(m_context);
+    m_constant_allocator.destroy(m_context);
+    m_recorded_bundle_cache.destroy(m_context);
+
+    for (const auto& [_, readback] : m_readbacks) {
+        for (const rhi::BufferHandle buffer : readback.buffers) {
+            m_context->destroy_buffer(buffer);
+        }
+    }
+}
+
+void FrameGraph::set_thread_pool(core::ThreadPool* thread_pool) noexcept
+{
+    m_thread_pool = thread_pool;
+}
+
+void FrameGraph::set_upload_service(rhi::UploadService* upload_service) noexcept
 {
+    m_upload_service = upload_service;
 }
 
 void FrameGraph::add_present_pass(
@@ -196,14 +259,102 @@ void FrameGraph::add_present_pass(
     });
 }
 
+void FrameGraph::add_readback(
+    const core::String& name,
+    const BufferHandle buffer,
+    const u64 offset,
+    const u64 size) noexcept
+{
+    TNDR_PROFILER_TRACE("FrameGraph::add_readback");
+    tndr_assert(buffer.is_valid(), "`buffer` must be a valid handle");
+    tndr_assert(size > 0, "`size` must be greater than 0");
+
+    FrameGraph::Readback& readback = m_readbacks[name];
+    if (readback.size != size) {
+        for (usize i = 0; i < NUM_READBACK_BUFFERS; ++i) {
+            if (readback.buffers[i].is_valid()) {
+                m_context->destroy_buffer(readback.buffers[i]);
+            }
+
+            readback.buffers[i] = m_context->create_buffer(rhi::BufferCreateInfo {
+                .usage = rhi::BufferUsageFlags::TRANSFER_DESTINATION,
+                .memory_type = rhi::MemoryType::Readback,
+                .size = size,
+                .name = name,
+            });
+            readback.frames[i] = std::nullopt;
+        }
+
+        readback.size = size;
+    }
+
+    const usize slot = m_frame_index % NUM_READBACK_BUFFERS;
+    readback.frames[slot] = m_frame_index;
+    const rhi::BufferHandle dst = readback.buffers[slot];
+
+    m_readback_passes.insert(
+        RenderPassId { static_cast<u32>(m_render_passes.size()) });
+    [[maybe_unused]] const BufferHandle read_buffer = this->add_pass(
+        QueueType::Graphics,
+        name,
+        [&](Builder& builder) {
+            return builder.read(buffer, BufferResourceUsage::TRANSFER);
+        },
+        [=](rhi::IRHIContext*,
+            const Registry& registry,
+            rhi::CommandEncoder& encoder,
+            const BufferHandle& src) {
+            encoder.buffer_copy(
+                registry.get_buffer(src),
+                dst,
+                {
+                    rhi::BufferCopyRegion {
+                        .src_offset = offset,
+                        .dst_offset = 0,
+                        .size = size,
+                    },
+                });
+
+            // Makes the copy visible to `IRHIContext::read_buffer`.
+            encoder.buffer_barrier({
+                rhi::BufferBarrier {
+                    .buffer = dst,
+                    .previous_access = rhi::BufferAccessFlags::TRANSFER_DESTINATION,
+                    .next_access = rhi::BufferAccessFlags::HOST_READ,
+                },
+            });
+        });
+}
+
 void FrameGraph::compile() noexcept
 {
     TNDR_PROFILER_TRACE("FrameGraph::compile");
 
-    this->build_adjacency_list();
-    this->topological_sort();
-    this->build_dependency_levels();
-    this->build_barriers();
+    m_graph_key.clear();
+    this->build_graph_key(m_graph_key);
+    if (!m_compiled_graph_key || (*m_compiled_graph_key != m_graph_key)) {
+        m_culled_passes.clear();
+        m_render_passes_barriers.clear();
+        m_present_passes_barriers.clear();
+        m_split_barriers.clear();
+        m_adjacency_list.clear();
+        m_topologically_sorted_passes.clear();
+        m_dependency_levels.clear();
+        m_pass_batches.clear();
+        m_submissions.clear();
+
+        this->cull_passes();
+        this->build_adjacency_list();
+        this->topological_sort();
+        this->build_dependency_levels();
+        this->build_transient_resources();
+        this->build_barriers();
+        this->build_submissions();
+
+        m_compiled_graph_key = m_graph_key;
+    }
+
+    this->build_render_passes();
 }
 
 void FrameGraph::execute(rhi::IRHIContext* context) noexcept
@@ -212,57 +363,86 @@ void FrameGraph::execute(rhi::IRHIContext* context) noexcept
 
     // #TODO: Not optimal...
     if (!m_dependency_levels.empty()) {
-        frame_graph::QueueType queue_type = frame_graph::QueueType::Graphics;
-        core::Array<rhi::SubmitInfo> submit_infos;
+        m_transient_resource_allocator.allocate(context, m_registry);
+        m_constant_allocator.begin_frame(m_frame_index);
+
+        // Timestamp queries of passes.
+        core::Array<TimedPass>& timed_passes =
+            m_timed_passes[m_frame_index % rhi::config::MAX_FRAMES_IN_FLIGHT];
+        const core::Array<TimedPass> previous_timed_passes = core::move(timed_passes);
+        timed_passes.clear();
+
+        core::Array<core::Option<u32>> pass_queries(m_render_passes.size());
+        core::Array<core::Option<u32>> pass_pipeline_statistics_queries(
+            m_render_passes.size());
+        u32 num_pipeline_statistics_queries = 0;
+        for (const FrameGraph::Submission& submission : m_submissions) {
+            if (submission.queue_type == QueueType::Transfer) {
+                continue;
+            }
 
-        rhi::CommandEncoder encoder;
-        encoder.begin_command_buffer();
+            for (const usize batch_index : submission.batches) {
+                for (const RenderPassId pass_id : m_pass_batches[batch_index].passes) {
+                    const u32 query = static_cast<u32>(timed_passes.size()) * 2;
+                    if ((query + 1) >= rhi::config::MAX_TIMESTAMP_QUERIES) {
+                        break;
+                    }
 
-        for (const FrameGraph::DependencyLevel& dependency_level : m_dependency_levels) {
-            for (const RenderPassId pass_id : dependency_level.passes) {
-                const core::UniquePtr<IFrameGraphPass>& pass =
-                    m_render_passes[static_cast<usize>(pass_id)];
-                const FrameGraph::RenderPassResources& pass_resources =
-                    m_render_passes_resources[static_cast<usize>(pass_id)];
-                const FrameGraph::RenderPassBarriers& pass_barriers =
-                    m_render_passes_barriers[static_cast<usize>(pass_id)];
+                    // Graphics statistics can be counted only on the graphics queue,
+                    // and recorded bundles can't be executed inside the query.
+                    core::Option<u32> pipeline_statistics_query;
+                    if ((submission.queue_type == QueueType::Graphics) &&
+                        !m_render_passes_resources[static_cast<usize>(pass_id)]
+                             .uses_recorded_bundles &&
+                        (num_pipeline_statistics_queries <
+                         rhi::config::MAX_PIPELINE_STATISTICS_QUERIES)) {
+                        pipeline_statistics_query = num_pipeline_statistics_queries++;
+                    }
 
-                for (const ResourceId resource_id : pass_resources.creates) {
-                    core::UniquePtr<IBaseResource>& resource =
-                        m_resources[static_cast<usize>(resource_id)];
-                    resource->create(context, m_registry);
+                    pass_queries[static_cast<usize>(pass_id)] = query;
+                    pass_pipeline_statistics_queries[static_cast<usize>(pass_id)] =
+                        pipeline_statistics_query;
+                    timed_passes.push_back(TimedPass {
+                        .name = m_render_passes[static_cast<usize>(pass_id)]->get_name(),
+                        .queue_type = submission.queue_type,
+                        .pipeline_statistics_query = pipeline_statistics_query,
+                    });
                 }
+            }
+        }
 
-                if (!submit_infos.empty()) {
-                    rhi::SubmitInfo& submit_info = submit_infos.back();
-
-                    if (submit_info.queue_type !=
-                        map_fg_queue_to_rhi_queue(pass->get_queue_type())) {
-                        encoder.end_command_buffer();
-
-                        rhi::SubmitInfo sb;
-                        sb.encoders.push_back(core::move(encoder));
-                        sb.synchronization_stage = map_queue_to_synchronization_stage(
-                            pass->get_queue_type());
-                        sb.queue_type = *map_fg_queue_to_rhi_queue(
-                            pass->get_queue_type());
+        // All batches can be recorded at the same time.
+        core::Array<rhi::CommandEncoder> encoders(m_pass_batches.size());
 
-                        submit_infos.push_back(core::move(sb));
+        const auto record_batch = [&](const usize batch_index) {
+            TNDR_PROFILER_TRACE("FrameGraph::execute::record_batch");
 
-                        encoder = rhi::CommandEncoder {};
-                        encoder.begin_command_buffer();
-                    }
-                }
+            rhi::CommandEncoder& encoder = encoders[batch_index];
+            encoder.begin_command_buffer();
 
-                queue_type = pass->get_queue_type();
+            for (const RenderPassId pass_id : m_pass_batches[batch_index].passes) {
+                const core::UniquePtr<IFrameGraphPass>& pass =
+                    m_render_passes[static_cast<usize>(pass_id)];
+                const FrameGraph::RenderPassBarriers& pass_barriers =
+                    m_render_passes_barriers[static_cast<usize>(pass_id)];
 
                 encoder.begin_region(
                     pass->get_name(),
                     math::Vec4 {
-                        get_random_color(),
+                        get_pass_color(pass_id),
                         1.f,
                     });
 
+                for (const u32 event : pass_barriers.wait_events) {
+                    const FrameGraph::SplitBarrier& split_barrier =
+                        m_split_barriers[event];
+                    encoder.wait_event(translate_split_barrier(
+                        m_registry,
+                        event,
+                        split_barrier.global_barrier,
+                        split_barrier.texture_barriers));
+                }
+
                 translate_barriers(
                     m_registry,
                     encoder,
@@ -270,8 +450,26 @@ void FrameGraph::execute(rhi::IRHIContext* context) noexcept
                     pass_barriers.texture_barriers.before,
                     pass_barriers.buffer_barriers.before);
 
+                const core::Option<u32>& query =
+                    pass_queries[static_cast<usize>(pass_id)];
+                const core::Option<u32>& pipeline_statistics_query =
+                    pass_pipeline_statistics_queries[static_cast<usize>(pass_id)];
+                if (query.has_value()) {
+                    encoder.write_timestamp(*query, rhi::TimestampStage::Top);
+                }
+                if (pipeline_statistics_query.has_value()) {
+                    encoder.begin_pipeline_statistics(*pipeline_statistics_query);
+                }
+
                 pass->execute(context, m_registry, encoder);
 
+                if (pipeline_statistics_query.has_value()) {
+                    encoder.end_pipeline_statistics(*pipeline_statistics_query);
+                }
+                if (query.has_value()) {
+                    encoder.write_timestamp(*query + 1, rhi::TimestampStage::Bottom);
+                }
+
                 translate_barriers(
                     m_registry,
                     encoder,
@@ -279,45 +477,86 @@ void FrameGraph::execute(rhi::IRHIContext* context) noexcept
                     pass_barriers.texture_barriers.after,
                     pass_barriers.buffer_barriers.after);
 
+                for (const u32 event : pass_barriers.set_events) {
+                    const FrameGraph::SplitBarrier& split_barrier =
+                        m_split_barriers[event];
+                    encoder.set_event(translate_split_barrier(
+                        m_registry,
+                        event,
+                        split_barrier.global_barrier,
+                        split_barrier.texture_barriers));
+                }
+
                 encoder.end_region();
             }
+
+            encoder.end_command_buffer();
+        };
+
+        if (m_thread_pool != nullptr) {
+            m_thread_pool->parallel_for(m_pass_batches.size(), record_batch);
+        } else {
+            for (usize i = 0; i < m_pass_batches.size(); ++i) {
+                record_batch(i);
+            }
         }
 
-        encoder.end_command_buffer();
-        if (!submit_infos.empty()) {
-            rhi::SubmitInfo& submit_info = submit_infos.back();
+        // Uploads are submitted first. Submissions of the graph follow them, so their
+        // indices are offset.
+        core::Array<rhi::SubmitInfo> submit_infos;
+        if (m_upload_service != nullptr) {
+            submit_infos = m_upload_service->flush();
+        }
+        const usize first_submission = submit_infos.size();
 
-            if (submit_info.queue_type != map_fg_queue_to_rhi_queue(queue_type)) {
-                rhi::SubmitInfo sb;
-                sb.encoders.push_back(core::move(encoder));
-                sb.synchronization_stage = map_queue_to_synchronization_stage(queue_type);
-                sb.queue_type = *map_fg_queue_to_rhi_queue(queue_type);
+        // Stitch encoders in the execution order.
+        submit_infos.reserve(first_submission + m_submissions.size() + 1);
+        for (const FrameGraph::Submission& submission : m_submissions) {
+            rhi::SubmitInfo submit_info;
+            submit_info.synchronization_stage = map_queue_to_synchronization_stage(
+                submission.queue_type);
+            submit_info.queue_type = *map_fg_queue_to_rhi_queue(submission.queue_type);
+            for (const usize wait_submission : submission.wait_submissions) {
+                submit_info.wait_submit_infos.push_back(
+                    first_submission + wait_submission);
+            }
 
-                submit_infos.push_back(core::move(sb));
-            } else {
-                submit_info.encoders.push_back(core::move(encoder));
+            for (const usize batch_index : submission.batches) {
+                submit_info.encoders.push_back(core::move(encoders[batch_index]));
             }
-        } else {
-            rhi::SubmitInfo sb;
-            sb.encoders.push_back(core::move(encoder));
-            sb.synchronization_stage = map_queue_to_synchronization_stage(queue_type);
-            sb.queue_type = *map_fg_queue_to_rhi_queue(queue_type);
 
-            submit_infos.push_back(core::move(sb));
+            submit_infos.push_back(core::move(submit_info));
         }
 
         core::Array<rhi::PresentInfo> present_infos;
         present_infos.reserve(m_present_passes.size());
         if (!m_present_passes.empty()) {
-            rhi::CommandEncoder encoder;
-            encoder.begin_command_buffer();
-            encoder.begin_region(
-                "Prepare textures to present", math::Vec4 { 1.f, 0.5f, 1.f, 1.f });
-
-            for (const PresentPass& present_pass : m_present_passes) {
-                if (present_pass.barrier.has_value()) {
-                    translate_barriers(
-                        m_registry, encoder, std::nullopt, { *present_pass.barrier }, {});
+            // Barriers only change with the swapchain images and their accesses, so they
+            // are recorded once into a bundle keyed by them.
+            core::Array<u64> barriers_key;
+            const auto push = [&](const auto value) {
+                barriers_key.push_back(static_cast<u64>(value));
+            };
+            const auto push_queue = [&](const core::Option<QueueType> queue_type) {
+                push(queue_type.has_value() ? static_cast<u64>(*queue_type) + 1 : 0);
+            };
+
+            bool has_barriers = false;
+            for (usize i = 0; i < m_present_passes.size(); ++i) {
+                const PresentPass& present_pass = m_present_passes[i];
+                const core::Option<TextureBarrier>& present_barrier =
+                    m_present_passes_barriers[i];
+
+                if (present_barrier.has_value()) {
+                    has_barriers = true;
+                    const rhi::TextureHandle texture = m_registry.get_texture(
+                        TextureHandle { present_barrier->texture });
+                    push(texture.get_handle().get_id());
+                    push(present_barrier->previous_access);
+                    push(present_barrier->next_access);
+                    push_queue(present_barrier->source_queue);
+                    push_queue(present_barrier->destination_queue);
+                    push(present_barrier->discard_contents);
                 }
 
                 present_infos.push_back(rhi::PresentInfo {
@@ -327,6 +566,33 @@ void FrameGraph::execute(rhi::IRHIContext* context) noexcept
                 });
             }
 
+            rhi::CommandEncoder encoder;
+            encoder.begin_command_buffer();
+            encoder.begin_region(
+                "Prepare textures to present", math::Vec4 { 1.f, 0.5f, 1.f, 1.f });
+
+            if (has_barriers) {
+                encoder.execute_recorded_bundle(m_recorded_bundle_cache.get_or_record(
+                    context,
+                    "Prepare textures to present",
+                    *map_fg_queue_to_rhi_queue(QueueType::Present),
+                    barriers_key,
+                    {},
+                    [&](rhi::CommandEncoder& bundle_encoder, const rhi::BufferHandle) {
+                        for (const core::Option<TextureBarrier>& present_barrier :
+                             m_present_passes_barriers) {
+                            if (present_barrier.has_value()) {
+                                translate_barriers(
+                                    m_registry,
+                                    bundle_encoder,
+                                    std::nullopt,
+                                    { *present_barrier },
+                                    {});
+                            }
+                        }
+                    }));
+            }
+
             encoder.end_region();
             encoder.end_command_buffer();
 
@@ -336,15 +602,85 @@ void FrameGraph::execute(rhi::IRHIContext* context) noexcept
                 QueueType::Present);
             submit_info.queue_type = *map_fg_queue_to_rhi_queue(QueueType::Present);
 
+            // Wait for the last submission of every other queue.
+            core::HashMap<QueueType, usize> last_submissions;
+            for (usize i = 0; i < m_submissions.size(); ++i) {
+                last_submissions.insert_or_assign(m_submissions[i].queue_type, i);
+            }
+
+            for (const auto& [queue_type, submission] : last_submissions) {
+                if (queue_type != QueueType::Present) {
+                    submit_info.wait_submit_infos.push_back(
+                        first_submission + submission);
+                }
+            }
+
             submit_infos.push_back(core::move(submit_info));
         }
 
         context->submit(core::move(submit_infos), core::move(present_infos));
 
-        for (core::UniquePtr<IBaseResource>& resource : m_resources) {
-            resource->destroy(context);
+        // Timestamps of the frame that used the same slot of `m_timed_passes`.
+        const core::Array<core::Option<u64>> timestamps = context->get_timestamps();
+        const core::Array<core::Option<rhi::PipelineStatistics>> pipeline_statistics =
+            context->get_pipeline_statistics();
+        m_pass_timings.clear();
+        for (usize i = 0; i < previous_timed_passes.size(); ++i) {
+            const FrameGraph::TimedPass& timed_pass = previous_timed_passes[i];
+            const usize begin = i * 2;
+            const usize end = begin + 1;
+            if ((end < timestamps.size()) && timestamps[begin].has_value() &&
+                timestamps[end].has_value()) {
+                const core::Option<u32>& query = timed_pass.pipeline_statistics_query;
+                core::Option<rhi::PipelineStatistics> pass_pipeline_statistics;
+                if (query.has_value() && (*query < pipeline_statistics.size())) {
+                    pass_pipeline_statistics = pipeline_statistics[*query];
+                }
+
+                m_pass_timings.push_back(PassTiming {
+                    .name = timed_pass.name,
+                    .queue_type = timed_pass.queue_type,
+                    .duration = *timestamps[end] - *timestamps[begin],
+                    .pipeline_statistics = pass_pipeline_statistics,
+                });
+            }
+        }
+
+        // The submit waited for the frame submitted `MAX_FRAMES_IN_FLIGHT` frames ago,
+        // so readback buffers written by it, or earlier, can be read without stalling.
+        for (auto& [_, readback] : m_readbacks) {
+            const usize slot = (m_frame_index + 1) % NUM_READBACK_BUFFERS;
+            const core::Option<u64>& frame = readback.frames[slot];
+            if (frame.has_value() &&
+                ((*frame + rhi::config::MAX_FRAMES_IN_FLIGHT) <= m_frame_index)) {
+                readback.data = context->read_buffer(
+                    readback.buffers[slot],
+                    rhi::BufferSubresourceRange {
+                        .offset = 0,
+                        .size = readback.size,
+                    });
+                readback.frames[slot] = std::nullopt;
+            }
         }
+
+        m_transient_resource_allocator.release(context);
+        m_frame_index += 1;
+    }
+}
+
+const core::Array<PassTiming>& FrameGraph::get_pass_timings() const noexcept
+{
+    return m_pass_timings;
+}
+
+const core::Array<char>* FrameGraph::get_readback(const core::String& name) const noexcept
+{
+    const auto it = m_readbacks.find(name);
+    if ((it == m_readbacks.end()) || !it->second.data.has_value()) {
+        return nullptr;
     }
+
+    return &*it->second.data;
 }
 
 void FrameGraph::reset() noexcept
@@ -353,40 +689,201 @@ void FrameGraph::reset() noexcept
 
     m_registry.clear();
     m_resources.clear();
+    m_resources_accesses.clear();
     m_render_passes.clear();
     m_present_passes.clear();
     m_render_passes_resources.clear();
-    m_render_passes_barriers.clear();
-    m_adjacency_list.clear();
-    m_topologically_sorted_passes.clear();
-    m_dependency_levels.clear();
+    m_exported_resources.clear();
+    m_readback_passes.clear();
+}
+
+void FrameGraph::build_graph_key(core::Array<u64>& key) const noexcept
+{
+    TNDR_PROFILER_TRACE("FrameGraph::build_graph_key");
+
+    const auto push = [&](const auto value) { key.push_back(static_cast<u64>(value)); };
+
+    // Iteration order of hash maps depends on their history,
+    // so their entries are sorted to make the key independent of it.
+    core::Array<u64> sorted;
+    const auto push_sorted = [&] {
+        std::sort(sorted.begin(), sorted.end());
+        push(sorted.size());
+        key.insert(key.end(), sorted.begin(), sorted.end());
+        sorted.clear();
+    };
+
+    const auto push_usages = [&](const core::HashMap<ResourceId, ResourceUsage>& usages) {
+        for (const auto& [resource_id, usage] : usages) {
+            sorted.push_back(
+                (static_cast<u64>(resource_id) << 32u) | static_cast<u64>(usage));
+        }
+        push_sorted();
+    };
+
+    push(m_resources.size());
+    for (const core::UniquePtr<IBaseResource>& resource : m_resources) {
+        const ResourceType resource_type = resource->get_resource_type();
+        push(resource_type);
+
+        switch (resource_type) {
+            case ResourceType::Texture: {
+                const auto* texture = static_cast<const TextureResource*>(resource.get());
+                const TextureCreateInfo& create_info = texture->get_create_info();
+                const rhi::Extent extent = rhi::TextureKind::get_extent(create_info.kind);
+
+                push(create_info.kind.index());
+                push(extent.width);
+                push(extent.height);
+                push(extent.depth);
+                push(rhi::TextureKind::get_num_layers(create_info.kind));
+                push(rhi::TextureKind::get_num_mips(create_info.kind));
+                push(rhi::TextureKind::get_sample_count(create_info.kind));
+                push(create_info.memory_type);
+                push(create_info.format);
+                push(create_info.usage);
+                push(create_info.tiling);
+                break;
+            }
+            case ResourceType::Buffer: {
+                const auto* buffer = static_cast<const BufferResource*>(resource.get());
+                const BufferCreateInfo& create_info = buffer->get_create_info();
+                push(create_info.usage);
+                push(create_info.memory_type);
+                push(create_info.size);
+                break;
+            }
+            default:
+                core::unreachable();
+        }
+    }
+
+    push(m_render_passes.size());
+    for (usize i = 0; i < m_render_passes.size(); ++i) {
+        const IFrameGraphPass* pass = m_render_passes[i].get();
+        const FrameGraph::RenderPassResources& pass_resources =
+            m_render_passes_resources[i];
+
+        push(pass->get_queue_type());
+        push(pass->get_pass_type());
+        push_usages(pass_resources.reads);
+        push_usages(pass_resources.writes);
+
+        for (const ResourceId resource_id : pass_resources.creates) {
+            sorted.push_back(static_cast<u64>(resource_id));
+        }
+        push_sorted();
+    }
+
+    push(m_present_passes.size());
+    for (const PresentPass& present_pass : m_present_passes) {
+        push(present_pass.texture.handle);
+    }
+
+    for (const ResourceId resource_id : m_exported_resources) {
+        sorted.push_back(static_cast<u64>(resource_id));
+    }
+    push_sorted();
+
+    for (const RenderPassId pass_id : m_readback_passes) {
+        sorted.push_back(static_cast<u64>(pass_id));
+    }
+    push_sorted();
+}
+
+void FrameGraph::cull_passes() noexcept
+{
+    TNDR_PROFILER_TRACE("FrameGraph::cull_passes");
+
+    const usize num_render_passes = m_render_passes.size();
+    m_culled_passes.assign(num_render_passes, true);
+
+    // `resource -> passes that create or write the resource`
+    core::Array<core::Array<RenderPassId>> producers(m_resources.size());
+    for (usize pass_index = 0; pass_index < num_render_passes; ++pass_index) {
+        const FrameGraph::RenderPassResources& pass_resources =
+            m_render_passes_resources[pass_index];
+        const RenderPassId pass_id { static_cast<u32>(pass_index) };
+
+        for (const ResourceId resource_id : pass_resources.creates) {
+            producers[static_cast<usize>(resource_id)].push_back(pass_id);
+        }
+
+        for (const auto& [resource_id, _] : pass_resources.writes) {
+            if (!pass_resources.creates.contains(resource_id)) {
+                producers[static_cast<usize>(resource_id)].push_back(pass_id);
+            }
+        }
+    }
+
+    // Walk back from the outputs of the graph. A pass is kept when it produces
+    // a resource that is presented, exported or read by a kept pass.
+    core::Array<bool> is_needed(m_resources.size(), false);
+    core::Array<ResourceId> needed_resources;
+
+    const auto mark_as_needed = [&](const ResourceId resource_id) {
+        if (!is_needed[static_cast<usize>(resource_id)]) {
+            is_needed[static_cast<usize>(resource_id)] = true;
+            needed_resources.push_back(resource_id);
+        }
+    };
+
+    for (const PresentPass& present_pass : m_present_passes) {
+        mark_as_needed(present_pass.texture.handle);
+    }
+
+    for (const ResourceId resource_id : m_exported_resources) {
+        mark_as_needed(resource_id);
+    }
+
+    // Readbacks are outputs of the graph too.
+    for (const RenderPassId pass_id : m_readback_passes) {
+        m_culled_passes[static_cast<usize>(pass_id)] = false;
+        for (const auto& [read, _] :
+             m_render_passes_resources[static_cast<usize>(pass_id)].reads) {
+            mark_as_needed(read);
+        }
+    }
+
+    while (!needed_resources.empty()) {
+        const ResourceId resource_id = needed_resources.back();
+        needed_resources.pop_back();
+
+        for (const RenderPassId producer : producers[static_cast<usize>(resource_id)]) {
+            if (!m_culled_passes[static_cast<usize>(producer)]) {
+                continue;
+            }
+
+            m_culled_passes[static_cast<usize>(producer)] = false;
+            for (const auto& [read, _] :
+                 m_render_passes_resources[static_cast<usize>(producer)].reads) {
+                mark_as_needed(read);
+            }
+        }
+    }
 }
 
 void FrameGraph::build_adjacency_list() noexcept
 {
+    TNDR_PROFILER_TRACE("FrameGraph::build_adjacency_list");
+
+    // Dependencies are recorded by the `Builder`, and they are already deduplicated.
     m_adjacency_list.resize(m_render_passes.size());
 
     for (usize pass_index = 0; pass_index < m_render_passes.size(); ++pass_index) {
-        core::Array<RenderPassId>& adjacent_node_indices = m_adjacency_list[pass_index];
+        if (m_culled_passes[pass_index]) {
+            continue;
+        }
 
-        for (usize other_pass_index = 0; other_pass_index < m_render_passes.size();
-             ++other_pass_index) {
-            // We don't want to check dependencies to itself.
-            if (pass_index == other_pass_index) {
+        for (const RenderPassId dependency :
+             m_render_passes_resources[pass_index].dependencies) {
+            // A culled pass can only be a reader that a write has to wait for.
+            if (m_culled_passes[static_cast<usize>(dependency)]) {
                 continue;
             }
 
-            for (const auto& [read, _] :
-                 m_render_passes_resources[other_pass_index].reads) {
-                const core::HashMap<ResourceId, ResourceUsage>& pass_write_resources =
-                    m_render_passes_resources[pass_index].writes;
-                const bool depends = pass_write_resources.contains(read);
-
-                if (depends) {
-                    adjacent_node_indices.push_back(
-                        RenderPassId { static_cast<u32>(other_pass_index) });
-                }
-            }
+            m_adjacency_list[static_cast<usize>(dependency)].push_back(
+                RenderPassId { static_cast<u32>(pass_index) });
         }
     }
 }
@@ -399,7 +896,7 @@ void FrameGraph::topological_sort() noexcept
     core::Array<bool> on_stack(num_render_passes, false);
 
     for (usize i = 0; i < num_render_passes; ++i) {
-        if (visited[i]) {
+        if (visited[i] || m_culled_passes[i]) {
             continue;
         }
 
@@ -456,6 +953,65 @@ void FrameGraph::build_dependency_levels() noexcept
     }
 }
 
+void FrameGraph::build_transient_resources() noexcept
+{
+    TNDR_PROFILER_TRACE("FrameGraph::build_transient_resources");
+
+    m_transient_resource_allocator.reset();
+
+    core::Array<TransientResourceAllocator::Lifetime> lifetimes(m_resources.size());
+
+    const auto extend_lifetime = [&](const ResourceId resource_id, const u32 level) {
+        TransientResourceAllocator::Lifetime& lifetime =
+            lifetimes[static_cast<usize>(resource_id)];
+        lifetime.first_level = math::min(lifetime.first_level, level);
+        lifetime.last_level = math::max(lifetime.last_level, level);
+    };
+
+    const auto mark_async = [&](const ResourceId resource_id, const QueueType queue) {
+        if (queue != QueueType::Graphics) {
+            lifetimes[static_cast<usize>(resource_id)].is_async = true;
+        }
+    };
+
+    for (const FrameGraph::DependencyLevel& dependency_level : m_dependency_levels) {
+        for (const RenderPassId pass_id : dependency_level.passes) {
+            const FrameGraph::RenderPassResources& pass_resources =
+                m_render_passes_resources[static_cast<usize>(pass_id)];
+            const QueueType pass_queue =
+                m_render_passes[static_cast<usize>(pass_id)]->get_queue_type();
+
+            for (const ResourceId resource_id : pass_resources.creates) {
+                extend_lifetime(resource_id, dependency_level.level);
+                mark_async(resource_id, pass_queue);
+            }
+
+            for (const auto& [resource_id, _] : pass_resources.reads) {
+                extend_lifetime(resource_id, dependency_level.level);
+                mark_async(resource_id, pass_queue);
+            }
+
+            for (const auto& [resource_id, _] : pass_resources.writes) {
+                extend_lifetime(resource_id, dependency_level.level);
+                mark_async(resource_id, pass_queue);
+            }
+        }
+    }
+
+    // Textures are copied to swapchains after all passes,
+    // and exported resources must stay intact until the end of the frame.
+    for (const PresentPass& present_pass : m_present_passes) {
+        extend_lifetime(
+            present_pass.texture.handle, TransientResourceAllocator::END_OF_FRAME_LEVEL);
+    }
+
+    for (const ResourceId resource_id : m_exported_resources) {
+        extend_lifetime(resource_id, TransientResourceAllocator::END_OF_FRAME_LEVEL);
+    }
+
+    m_transient_resource_allocator.plan(m_resources, lifetimes);
+}
+
 void FrameGraph::build_barriers() noexcept
 {
     struct LastResourceUsage {
@@ -467,13 +1023,44 @@ void FrameGraph::build_barriers() noexcept
 
     core::HashMap<ResourceId, LastResourceUsage> last_resources_usage;
 
-    const auto get_access_flags = [&](const ResourceId resource) {
-        const auto it = last_resources_usage.find(resource);
-        tndr_assert(it != last_resources_usage.end(), "");
+    m_render_passes_barriers.resize(m_render_passes.size());
+    m_present_passes_barriers.resize(m_present_passes.size());
+
+    // Position of every pass in the execution order of its queue.
+    core::Array<u32> queue_positions(m_render_passes.size(), 0);
+    {
+        core::HashMap<QueueType, u32> num_queue_passes;
+        for (const FrameGraph::DependencyLevel& dependency_level : m_dependency_levels) {
+            for (const RenderPassId pass_id : dependency_level.passes) {
+                const QueueType pass_queue =
+                    m_render_passes[static_cast<usize>(pass_id)]->get_queue_type();
+                queue_positions[static_cast<usize>(pass_id)] =
+                    num_queue_passes[pass_queue]++;
+            }
+        }
+    }
+
+    // `producer << 32 | consumer -> index into m_split_barriers`.
+    core::HashMap<u64, u32> split_barriers;
 
-        const LastResourceUsage& last_resource_use = it->second;
+    const auto get_split_barrier = [&](const RenderPassId producer,
+                                       const RenderPassId consumer) -> SplitBarrier& {
+        const u64 key = (static_cast<u64>(producer) << 32) | static_cast<u64>(consumer);
+        const auto [it, inserted] = split_barriers.try_emplace(
+            key, static_cast<u32>(m_split_barriers.size()));
 
-        return core::make_tuple(last_resource_use.usage, last_resource_use.is_written);
+        if (inserted) {
+            m_split_barriers.push_back(SplitBarrier {
+                .producer = producer,
+                .consumer = consumer,
+            });
+            m_render_passes_barriers[static_cast<usize>(producer)].set_events.push_back(
+                it->second);
+            m_render_passes_barriers[static_cast<usize>(consumer)].wait_events.push_back(
+                it->second);
+        }
+
+        return m_split_barriers[it->second];
     };
 
     for (const FrameGraph::DependencyLevel& dependency_level : m_dependency_levels) {
@@ -482,7 +1069,6 @@ void FrameGraph::build_barriers() noexcept
 
             core::UniquePtr<IFrameGraphPass>& pass = m_render_passes[pass_id_index];
             const QueueType pass_queue = pass->get_queue_type();
-            const PassType pass_type = pass->get_pass_type();
             const auto& pass_resource_writes = m_render_passes_resources[pass_id_index]
                                                    .writes;
             const auto& pass_resource_reads = m_render_passes_resources[pass_id_index]
@@ -632,15 +1218,60 @@ void FrameGraph::build_barriers() noexcept
                         }
                     }();
 
-                    if (is_same_queue) {
+                    // Events are set and waited for on the same queue, and the barrier
+                    // is worth splitting only if there is work to overlap with.
+                    const bool is_split = (last_resource_usage.queue == pass_queue) &&
+                                          ((queue_positions[pass_id_index] -
+                                            queue_positions[static_cast<usize>(
+                                                last_resource_usage.render_pass)]) > 1);
+
+                    if (is_split) {
+                        core::Option<GlobalBarrier> global_barrier;
+                        core::Array<TextureBarrier> texture_barriers;
                         this->insert_barrier(
                             resource_id,
                             core::make_tuple(
                                 last_resource_usage.usage,
                                 last_resource_usage.is_written),
-                            pass_id,
                             core::make_tuple(all_resource_usage, is_written),
-                            discard_previous_contents);
+                            discard_previous_contents,
+                            global_barrier,
+                            texture_barriers);
+
+                        // Read after read, or a texture read in the same layout, needs
+                        // no barrier, so no event is set and waited for.
+                        if (global_barrier.has_value() || !texture_barriers.empty()) {
+                            SplitBarrier& split_barrier = get_split_barrier(
+                                last_resource_usage.render_pass, pass_id);
+
+                            if (global_barrier.has_value()) {
+                                if (split_barrier.global_barrier.has_value()) {
+                                    split_barrier.global_barrier->previous_access |=
+                                        global_barrier->previous_access;
+                                    split_barrier.global_barrier->next_access |=
+                                        global_barrier->next_access;
+                                } else {
+                                    split_barrier.global_barrier = global_barrier;
+                                }
+                            }
+
+                            for (TextureBarrier& texture_barrier : texture_barriers) {
+                                split_barrier.texture_barriers.push_back(
+                                    core::move(texture_barrier));
+                            }
+                        }
+                    } else if (is_same_queue) {
+                        RenderPassBarriers& pass_barriers =
+                            m_render_passes_barriers[pass_id_index];
+                        this->insert_barrier(
+                            resource_id,
+                            core::make_tuple(
+                                last_resource_usage.usage,
+                                last_resource_usage.is_written),
+                            core::make_tuple(all_resource_usage, is_written),
+                            discard_previous_contents,
+                            pass_barriers.global_barrier.before,
+                            pass_barriers.texture_barriers.before);
                     } else {
                         this->queue_ownership_transfer(
                             resource_id,
@@ -665,148 +1296,94 @@ void FrameGraph::build_barriers() noexcept
                             resource_name);
                     }
                     // tndr_assert(!is_read, "No one used resource before us.");
-                    // We are inserting a barrier, but only for textures. For buffers we don't bother.
+
+                    // The resource shares memory with a resource used earlier
+                    // in this frame, so we have to wait for the previous user
+                    // before we overwrite it.
+                    // Across queues the synchronization is done by semaphores.
+                    const auto aliased_it = last_resources_usage.find(
+                        m_transient_resource_allocator.get_aliased_resource(resource_id));
+                    const bool is_aliased_on_same_queue =
+                        (aliased_it != last_resources_usage.end()) &&
+                        (map_queue_to_family_index(
+                             m_queue_indices, aliased_it->second.queue) ==
+                         map_queue_to_family_index(m_queue_indices, pass_queue));
 
                     const ResourceType resource_type =
                         m_resources[static_cast<usize>(resource_id)]->get_resource_type();
-                    switch (resource_type) {
-                        case ResourceType::Texture: {
-                            const rhi::TextureAccessFlags previous_access //
-                                = to_texture_access_flags(ResourceUsage::NONE, false);
-                            const rhi::TextureAccessFlags next_access //
-                                = to_texture_access_flags(all_resource_usage, is_written);
-
-                            core::Array<TextureBarrier>& texture_barriers =
-                                m_render_passes_barriers[static_cast<usize>(pass_id)]
-                                    .texture_barriers.before;
-
-                            texture_barriers.push_back(TextureBarrier {
-                                .texture = resource_id,
-                                .previous_access = previous_access,
-                                .next_access = next_access,
-                                .discard_contents = true,
-                            });
-                            break;
+
+                    if (is_aliased_on_same_queue) {
+                        const LastResourceUsage& aliased_usage = aliased_it->second;
+                        RenderPassBarriers& pass_barriers =
+                            m_render_passes_barriers[pass_id_index];
+                        this->insert_barrier(
+                            resource_id,
+                            core::make_tuple(
+                                aliased_usage.usage, aliased_usage.is_written),
+                            core::make_tuple(all_resource_usage, is_written),
+                            true,
+                            pass_barriers.global_barrier.before,
+                            pass_barriers.texture_barriers.before);
+                    } else {
+                        // We are inserting a barrier, but only for textures.
+                        // For buffers we don't bother.
+                        switch (resource_type) {
+                            case ResourceType::Texture: {
+                                const rhi::TextureAccessFlags previous_access //
+                                    = to_texture_access_flags(ResourceUsage::NONE, false);
+                                const rhi::TextureAccessFlags next_access //
+                                    = to_texture_access_flags(
+                                        all_resource_usage, is_written);
+
+                                core::Array<TextureBarrier>& texture_barriers =
+                                    m_render_passes_barriers[static_cast<usize>(pass_id)]
+                                        .texture_barriers.before;
+
+                                texture_barriers.push_back(TextureBarrier {
+                                    .texture = resource_id,
+                                    .previous_access = previous_access,
+                                    .next_access = next_access,
+                                    .discard_contents = true,
+                                });
+                                break;
+                            }
+                            default:
+                                break;
                         }
-                        default:
-                            break;
                     }
                 }
 
-                last_resources_usage.insert({
+                // Reads of a buffer on the same queue are not separated by barriers,
+                // so the next write has to wait for all of them, not only for the
+                // last one. The latest reader is kept, because split barriers are
+                // set after it.
+                // Reads of a texture with a different usage are separated by
+                // a texture barrier, which already waits for the previous readers.
+                ResourceUsage usage = all_resource_usage;
+                if (const auto it = last_resources_usage.find(resource_id);
+                    (it != last_resources_usage.end()) && !is_written &&
+                    !it->second.is_written &&
+                    (map_queue_to_family_index(m_queue_indices, it->second.queue) ==
+                     map_queue_to_family_index(m_queue_indices, pass_queue)) &&
+                    (m_resources[static_cast<usize>(resource_id)]
+                         ->get_resource_type() == ResourceType::Buffer)) {
+                    usage |= it->second.usage;
+                }
+
+                last_resources_usage.insert_or_assign(
                     resource_id,
                     LastResourceUsage {
                         .render_pass = pass_id,
                         .queue = pass_queue,
-                        .usage = all_resource_usage,
+                        .usage = usage,
                         .is_written = is_written,
-                    },
-                });
-            }
-
-            // Prepare rhi::RenderPass
-            if (pass_type == PassType::RenderPass) {
-                IFrameGraphRenderPass* const render_pass =
-                    static_cast<IFrameGraphRenderPass*>(pass.get());
-                const RenderPass& fg_render_pass = render_pass->get_fg_render_pass();
-
-                rhi::RenderPass& rhi_render_pass = render_pass->get_render_pass();
-                rhi_render_pass.color_attachments.reserve(
-                    fg_render_pass.color_attachments.size());
-
-                for (const ColorAttachment& fg_color_attachment :
-                     fg_render_pass.color_attachments) {
-                    const ResourceId color_attachment_resource_id =
-                        attachment_texture_to_resource_id(fg_color_attachment.texture);
-
-                    tndr_assert(
-                        resources_used.contains(color_attachment_resource_id), "");
-
-                    const auto [usage, write] //
-                        = get_access_flags(color_attachment_resource_id);
-                    const rhi::TextureAccessFlags texture_access //
-                        = to_texture_access_flags(usage, write);
-
-                    rhi_render_pass.color_attachments.push_back(rhi::ColorAttachment {
-                        .ops = fg_color_attachment.ops,
-                        .texture_access = texture_access,
-                        .clear_value = fg_color_attachment.clear_value,
                     });
-
-                    if (fg_color_attachment.resolve_texture.has_value()) {
-                        const ResourceId color_attachment_resolve_resource_id =
-                            attachment_texture_to_resource_id(
-                                *fg_color_attachment.resolve_texture);
-
-                        tndr_assert(
-                            resources_used.contains(color_attachment_resolve_resource_id),
-                            "");
-
-                        const auto [usage, write] //
-                            = get_access_flags(color_attachment_resolve_resource_id);
-                        const rhi::TextureAccessFlags texture_access //
-                            = to_texture_access_flags(usage, write);
-
-                        rhi_render_pass.color_attachments.back()
-                            .resolve_texture = rhi::ResolveTexture {
-                            .texture_access = texture_access,
-                        };
-                    }
-                }
-
-                if (fg_render_pass.depth_stencil_attachment.has_value()) {
-                    const DepthStencilAttachment& fg_depth_stencil_attachment =
-                        *fg_render_pass.depth_stencil_attachment;
-
-                    const ResourceId depth_stencil_attachment_resource_id =
-                        attachment_texture_to_resource_id(
-                            fg_depth_stencil_attachment.texture);
-
-                    tndr_assert(
-                        resources_used.contains(depth_stencil_attachment_resource_id),
-                        "");
-
-                    const auto [usage, write] //
-                        = get_access_flags(depth_stencil_attachment_resource_id);
-                    const rhi::TextureAccessFlags texture_access //
-                        = to_texture_access_flags(usage, write);
-
-                    rhi_render_pass
-                        .depth_stencil_attachment = rhi::DepthStencilAttachment {
-                        .ops = fg_depth_stencil_attachment.ops,
-                        .stencil_ops = fg_depth_stencil_attachment.stencil_ops,
-                        .texture_access = texture_access,
-                        .clear_value = fg_depth_stencil_attachment.clear_value,
-                    };
-
-                    if (fg_depth_stencil_attachment.resolve_texture.has_value()) {
-                        const ResourceId depth_stencil_attachment_resolve_resource_id =
-                            attachment_texture_to_resource_id(
-                                *fg_depth_stencil_attachment.resolve_texture);
-
-                        tndr_assert(
-                            resources_used.contains(
-                                depth_stencil_attachment_resolve_resource_id),
-                            "");
-
-                        const auto [usage, write] //
-                            = get_access_flags(
-                                depth_stencil_attachment_resolve_resource_id);
-                        const rhi::TextureAccessFlags texture_access //
-                            = to_texture_access_flags(usage, write);
-
-                        rhi_render_pass.depth_stencil_attachment
-                            ->resolve_texture = rhi::ResolveTexture {
-                            .texture_access = texture_access,
-                        };
-                    }
-                }
             }
         }
     }
 
-    for (PresentPass& present_pass : m_present_passes) {
-        const ResourceId resource_id = present_pass.texture.handle;
+    for (usize i = 0; i < m_present_passes.size(); ++i) {
+        const ResourceId resource_id = m_present_passes[i].texture.handle;
 
         if (auto it = last_resources_usage.find(resource_id);
             it != last_resources_usage.end()) {
@@ -821,7 +1398,7 @@ void FrameGraph::build_barriers() noexcept
                   map_queue_to_family_index(m_queue_indices, QueueType::Present);
 
             if (is_same_queue) {
-                present_pass.barrier = TextureBarrier {
+                m_present_passes_barriers[i] = TextureBarrier {
                     .texture = resource_id,
                     .previous_access = previous_access,
                     .next_access = PresentPass::ACCESS_FLAGS,
@@ -846,7 +1423,7 @@ void FrameGraph::build_barriers() noexcept
                 }
 
                 // Acquire barrier
-                present_pass.barrier = TextureBarrier {
+                m_present_passes_barriers[i] = TextureBarrier {
                     .texture = resource_id,
                     .previous_access = previous_access,
                     .next_access = PresentPass::ACCESS_FLAGS,
@@ -861,12 +1438,209 @@ void FrameGraph::build_barriers() noexcept
     }
 }
 
+void FrameGraph::build_submissions() noexcept
+{
+    TNDR_PROFILER_TRACE("FrameGraph::build_submissions");
+
+    for (const FrameGraph::DependencyLevel& dependency_level : m_dependency_levels) {
+        const usize first_batch = m_pass_batches.size();
+
+        for (const RenderPassId pass_id : dependency_level.passes) {
+            const QueueType pass_queue =
+                m_render_passes[static_cast<usize>(pass_id)]->get_queue_type();
+
+            const auto it = std::find_if(
+                m_pass_batches.begin() + first_batch,
+                m_pass_batches.end(),
+                [&](const auto& batch) { return batch.queue_type == pass_queue; });
+
+            if (it != m_pass_batches.end()) {
+                it->passes.push_back(pass_id);
+            } else {
+                m_pass_batches.push_back(FrameGraph::PassBatch {
+                    .queue_type = pass_queue,
+                    .passes = { pass_id },
+                });
+            }
+        }
+    }
+
+    static constexpr usize NO_SUBMISSION = ~0ull;
+    core::Array<usize> pass_submissions(m_render_passes.size(), NO_SUBMISSION);
+    // Submissions, per queue, to which batches without cross queue waits are appended.
+    core::HashMap<QueueType, usize> open_submissions;
+
+    for (usize batch_index = 0; batch_index < m_pass_batches.size(); ++batch_index) {
+        const FrameGraph::PassBatch& batch = m_pass_batches[batch_index];
+
+        // Passes on the same queue are ordered by barriers.
+        core::Array<usize> wait_submissions;
+        for (const RenderPassId pass_id : batch.passes) {
+            for (const RenderPassId dependency :
+                 m_render_passes_resources[static_cast<usize>(pass_id)].dependencies) {
+                const usize submission = pass_submissions[static_cast<usize>(dependency)];
+
+                // Culled passes are never submitted.
+                if ((submission != NO_SUBMISSION) &&
+                    (m_submissions[submission].queue_type != batch.queue_type) &&
+                    (std::find(
+                         wait_submissions.begin(), wait_submissions.end(), submission) ==
+                     wait_submissions.end())) {
+                    wait_submissions.push_back(submission);
+                }
+            }
+        }
+
+        // Work appended to a waited for submission would delay the waiting queue.
+        for (const usize submission : wait_submissions) {
+            const auto it = open_submissions.find(m_submissions[submission].queue_type);
+            if ((it != open_submissions.end()) && (it->second == submission)) {
+                open_submissions.erase(it);
+            }
+        }
+
+        // Waits apply to a whole submission, so a batch that waits starts a new one.
+        usize submission_index;
+        const auto it = open_submissions.find(batch.queue_type);
+        if ((it != open_submissions.end()) && wait_submissions.empty()) {
+            submission_index = it->second;
+        } else {
+            submission_index = m_submissions.size();
+            m_submissions.push_back(FrameGraph::Submission {
+                .queue_type = batch.queue_type,
+                .wait_submissions = core::move(wait_submissions),
+            });
+            open_submissions.insert_or_assign(batch.queue_type, submission_index);
+        }
+
+        m_submissions[submission_index].batches.push_back(batch_index);
+        for (const RenderPassId pass_id : batch.passes) {
+            pass_submissions[static_cast<usize>(pass_id)] = submission_index;
+        }
+    }
+}
+
+void FrameGraph::build_render_passes() noexcept
+{
+    TNDR_PROFILER_TRACE("FrameGraph::build_render_passes");
+
+    for (usize pass_index = 0; pass_index < m_render_passes.size(); ++pass_index) {
+        core::UniquePtr<IFrameGraphPass>& pass = m_render_passes[pass_index];
+        const FrameGraph::RenderPassResources& pass_resources =
+            m_render_passes_resources[pass_index];
+
+        if (m_culled_passes[pass_index] ||
+            (pass->get_pass_type() != PassType::RenderPass)) {
+            continue;
+        }
+
+        const auto get_access_flags = [&](const ResourceId resource) {
+            ResourceUsage usage {};
+
+            const auto read_it = pass_resources.reads.find(resource);
+            const bool is_read = read_it != pass_resources.reads.end();
+            if (is_read) {
+                usage |= read_it->second;
+            }
+
+            const auto write_it = pass_resources.writes.find(resource);
+            const bool is_written = write_it != pass_resources.writes.end();
+            if (is_written) {
+                usage |= write_it->second;
+            }
+
+            tndr_assert(is_read || is_written, "Attachment is not used by the pass.");
+            return core::make_tuple(usage, is_written);
+        };
+
+        IFrameGraphRenderPass* const render_pass =
+            static_cast<IFrameGraphRenderPass*>(pass.get());
+        const RenderPass& fg_render_pass = render_pass->get_fg_render_pass();
+
+        rhi::RenderPass& rhi_render_pass = render_pass->get_render_pass();
+        rhi_render_pass.color_attachments.reserve(
+            fg_render_pass.color_attachments.size());
+
+        for (const ColorAttachment& fg_color_attachment :
+             fg_render_pass.color_attachments) {
+            const ResourceId color_attachment_resource_id =
+                attachment_texture_to_resource_id(fg_color_attachment.texture);
+
+            const auto [usage, write] //
+                = get_access_flags(color_attachment_resource_id);
+            const rhi::TextureAccessFlags texture_access //
+                = to_texture_access_flags(usage, write);
+
+            rhi_render_pass.color_attachments.push_back(rhi::ColorAttachment {
+                .ops = fg_color_attachment.ops,
+                .texture_access = texture_access,
+                .clear_value = fg_color_attachment.clear_value,
+            });
+
+            if (fg_color_attachment.resolve_texture.has_value()) {
+                const ResourceId color_attachment_resolve_resource_id =
+                    attachment_texture_to_resource_id(
+                        *fg_color_attachment.resolve_texture);
+
+                const auto [usage, write] //
+                    = get_access_flags(color_attachment_resolve_resource_id);
+                const rhi::TextureAccessFlags texture_access //
+                    = to_texture_access_flags(usage, write);
+
+                rhi_render_pass.color_attachments.back()
+                    .resolve_texture = rhi::ResolveTexture {
+                    .texture_access = texture_access,
+                };
+            }
+        }
+
+        if (fg_render_pass.depth_stencil_attachment.has_value()) {
+            const DepthStencilAttachment& fg_depth_stencil_attachment =
+                *fg_render_pass.depth_stencil_attachment;
+
+            const ResourceId depth_stencil_attachment_resource_id =
+                attachment_texture_to_resource_id(fg_depth_stencil_attachment.texture);
+
+            const auto [usage, write] //
+                = get_access_flags(depth_stencil_attachment_resource_id);
+            const rhi::TextureAccessFlags texture_access //
+                = to_texture_access_flags(usage, write);
+
+            rhi_render_pass
+                .depth_stencil_attachment = rhi::DepthStencilAttachment {
+                .ops = fg_depth_stencil_attachment.ops,
+                .stencil_ops = fg_depth_stencil_attachment.stencil_ops,
+                .texture_access = texture_access,
+                .clear_value = fg_depth_stencil_attachment.clear_value,
+            };
+
+            if (fg_depth_stencil_attachment.resolve_texture.has_value()) {
+                const ResourceId depth_stencil_attachment_resolve_resource_id =
+                    attachment_texture_to_resource_id(
+                        *fg_depth_stencil_attachment.resolve_texture);
+
+                const auto [usage, write] //
+                    = get_access_flags(
+                        depth_stencil_attachment_resolve_resource_id);
+                const rhi::TextureAccessFlags texture_access //
+                    = to_texture_access_flags(usage, write);
+
+                rhi_render_pass.depth_stencil_attachment
+                    ->resolve_texture = rhi::ResolveTexture {
+                    .texture_access = texture_access,
+                };
+            }
+        }
+    }
+}
+
 void FrameGraph::insert_barrier(
     const ResourceId resource_id,
     const core::Tuple<ResourceUsage, bool>& previous_usage,
-    const RenderPassId pass_id,
     const core::Tuple<ResourceUsage, bool>& next_usage,
-    const bool discard_contents) noexcept
+    const bool discard_contents,
+    core::Option<GlobalBarrier>& global_barrier,
+    core::Array<TextureBarrier>& texture_barriers) noexcept
 {
     const ResourceType resource_type //
         = m_resources[static_cast<usize>(resource_id)]->get_resource_type();
@@ -885,9 +1659,6 @@ void FrameGraph::insert_barrier(
                     core::get<ResourceUsage>(next_usage), core::get<bool>(next_usage));
 
             if (core::get<bool>(previous_usage) || core::get<bool>(next_usage)) {
-                core::Option<GlobalBarrier>& global_barrier =
-                    m_render_passes_barriers[static_cast<usize>(pass_id)]
-                        .global_barrier.before;
                 if (global_barrier.has_value()) {
                     global_barrier->previous_access |= previous_access;
                     global_barrier->next_access |= next_access;
@@ -914,9 +1685,6 @@ void FrameGraph::insert_barrier(
                         core::get<bool>(next_usage));
 
                 if (core::get<bool>(previous_usage) || core::get<bool>(next_usage)) {
-                    core::Option<GlobalBarrier>& global_barrier =
-                        m_render_passes_barriers[static_cast<usize>(pass_id)]
-                            .global_barrier.before;
                     if (global_barrier.has_value()) {
                         global_barrier->previous_access |= previous_access;
                         global_barrier->next_access |= next_access;
@@ -929,10 +1697,6 @@ void FrameGraph::insert_barrier(
                 }
             } else {
                 // normal barrier
-                core::Array<TextureBarrier>& texture_barriers =
-                    m_render_passes_barriers[static_cast<usize>(pass_id)]
-                        .texture_barriers.before;
-
                 const rhi::TextureAccessFlags previous_access //
                     = to_texture_access_flags(
                         core::get<ResourceUsage>(previous_usage),
@@ -1100,6 +1864,12 @@ FrameGraph::RenderPassResources& FrameGraph::get_render_pass_resources(
     return m_render_passes_resources[static_cast<usize>(render_pass)];
 }
 
+FrameGraph::ResourceAccesses& FrameGraph::get_resource_accesses(
+    const ResourceId resource) noexcept
+{
+    return m_resources_accesses[static_cast<usize>(resource)];
+}
+
 TextureHandle FrameGraph::create_texture(
     const RenderPassId creator,
     const core::String& name,
@@ -1109,6 +1879,9 @@ TextureHandle FrameGraph::create_texture(
     const TextureHandle fg_handle { handle };
     m_resources.emplace_back(
         core::make_unique<TextureResource>(creator, fg_handle, name, create_info));
+    m_resources_accesses.push_back(ResourceAccesses {
+        .last_writer = creator,
+    });
 
     return fg_handle;
 }
@@ -1122,6 +1895,9 @@ BufferHandle FrameGraph::create_buffer(
     const BufferHandle fg_handle { handle };
     m_resources.emplace_back(
         core::make_unique<BufferResource>(creator, fg_handle, name, create_info));
+    m_resources_accesses.push_back(ResourceAccesses {
+        .last_writer = creator,
+    });
 
     return fg_handle;
 }
@@ -0,0 +1,90 @@
+#include "renderer/frame_graph/recorded_bundle_cache.h"
+#include "core/profiler.h"
+#include "core/std/assert.h"
+#include <algorithm>
+#include <cstring>
+
+namespace tundra::renderer::frame_graph {
+
+void RecordedBundleCache::destroy(rhi::IRHIContext* context) noexcept
+{
+    auto inner = m_inner.lock();
+    for (const auto& [_, entries] : inner->entries) {
+        for (const Entry& entry : entries) {
+            destroy_entry(context, entry);
+        }
+    }
+
+    inner->entries.clear();
+}
+
+core::Option<rhi::RecordedBundleHandle> RecordedBundleCache::find(
+    core::Array<Entry>& entries,
+    const core::Array<u64>& key,
+    const core::Span<const char> constants,
+    const u64 use) noexcept
+{
+    for (Entry& entry : entries) {
+        if ((entry.key == key) && (entry.constants.size() == constants.size()) &&
+            std::equal(constants.begin(), constants.end(), entry.constants.begin())) {
+            entry.last_use = use;
+            return entry.bundle;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void RecordedBundleCache::insert(
+    rhi::IRHIContext* context, core::Array<Entry>& entries, Entry&& entry) noexcept
+{
+    TNDR_PROFILER_TRACE("RecordedBundleCache::insert");
+
+    if (entries.size() >= MAX_BUNDLES_PER_NAME) {
+        const auto least_recently_used = std::min_element(
+            entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+                return lhs.last_use < rhs.last_use;
+            });
+
+        // Frames in flight keep the bundle and its constants alive.
+        destroy_entry(context, *least_recently_used);
+        entries.erase(least_recently_used);
+    }
+
+    entries.push_back(core::move(entry));
+}
+
+rhi::BufferHandle RecordedBundleCache::create_constants_buffer(
+    rhi::IRHIContext* context,
+    const char* name,
+    const core::Span<const char> constants) noexcept
+{
+    if (constants.is_empty()) {
+        return {};
+    }
+
+    const rhi::BufferHandle buffer = context->create_buffer(rhi::BufferCreateInfo {
+        .usage = rhi::BufferUsageFlags::UNIFORM_BUFFER |
+                 rhi::BufferUsageFlags::STORAGE_BUFFER,
+        .memory_type = rhi::MemoryType::Dynamic,
+        .size = constants.size(),
+        .name = name,
+    });
+
+    core::Span<char> memory = context->map_buffer(buffer);
+    tndr_assert(memory.size() >= constants.size(), "");
+    std::memcpy(memory.data(), constants.data(), constants.size());
+
+    return buffer;
+}
+
+void RecordedBundleCache::destroy_entry(
+    rhi::IRHIContext* context, const Entry& entry) noexcept
+{
+    context->destroy_recorded_bundle(entry.bundle);
+    if (entry.constants_buffer.is_valid()) {
+        context->destroy_buffer(entry.constants_buffer);
+    }
+}
+
+} // namespace tundra::renderer::frame_graph
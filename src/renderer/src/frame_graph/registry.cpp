@@ -35,4 +35,16 @@ rhi::BufferHandle Registry::get_buffer(const BufferHandle fg_handle) const noexc
     return it->second;
 }
 
+ConstantAllocator& Registry::get_constant_allocator() const noexcept
+{
+    tndr_assert(m_constant_allocator != nullptr, "");
+    return *m_constant_allocator;
+}
+
+RecordedBundleCache& Registry::get_recorded_bundle_cache() const noexcept
+{
+    tndr_assert(m_recorded_bundle_cache != nullptr, "");
+    return *m_recorded_bundle_cache;
+}
+
 } // namespace tundra::renderer::frame_graph
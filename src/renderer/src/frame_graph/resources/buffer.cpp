@@ -51,4 +51,9 @@ bool BufferResource::is_transient() const noexcept
     return m_creator != NULL_RENDER_PASS_ID;
 }
 
+const BufferCreateInfo& BufferResource::get_create_info() const noexcept
+{
+    return m_create_info;
+}
+
 } // namespace tundra::renderer::frame_graph
@@ -52,6 +52,11 @@ bool TextureResource::is_transient() const noexcept
     return m_creator != NULL_RENDER_PASS_ID;
 }
 
+const TextureCreateInfo& TextureResource::get_create_info() const noexcept
+{
+    return m_create_info;
+}
+
 rhi::TextureUsageFlags TextureResource::get_usage_flags() const noexcept
 {
     return m_create_info.usage;
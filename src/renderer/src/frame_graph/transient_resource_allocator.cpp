@@ -0,0 +1,352 @@
+#include "renderer/frame_graph/transient_resource_allocator.h"
+#include "core/profiler.h"
+#include "core/std/assert.h"
+#include "core/std/panic.h"
+#include "math/math_utils.h"
+#include "renderer/frame_graph/registry.h"
+#include "rhi/config.h"
+#include "rhi/rhi_context.h"
+#include <algorithm>
+
+namespace tundra::renderer::frame_graph {
+
+[[nodiscard]] static bool is_same_texture(
+    const TextureCreateInfo& lhs, const TextureCreateInfo& rhs) noexcept
+{
+    return (lhs.kind.index() == rhs.kind.index()) &&
+           (TextureKind::get_extent(lhs.kind) == TextureKind::get_extent(rhs.kind)) &&
+           (TextureKind::get_sample_count(lhs.kind) ==
+            TextureKind::get_sample_count(rhs.kind)) &&
+           (TextureKind::get_num_layers(lhs.kind) ==
+            TextureKind::get_num_layers(rhs.kind)) &&
+           (TextureKind::get_num_mips(lhs.kind) == TextureKind::get_num_mips(rhs.kind)) &&
+           (lhs.memory_type == rhs.memory_type) && (lhs.format == rhs.format) &&
+           (lhs.usage == rhs.usage) && (lhs.tiling == rhs.tiling);
+}
+
+/// Buffers are compatible when they only differ in size.
+[[nodiscard]] static bool is_compatible_buffer(
+    const BufferCreateInfo& lhs, const BufferCreateInfo& rhs) noexcept
+{
+    return (lhs.usage == rhs.usage) && (lhs.memory_type == rhs.memory_type);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// TransientResourceAllocator
+
+void TransientResourceAllocator::plan(
+    const core::Array<core::UniquePtr<IBaseResource>>& resources,
+    const core::Array<Lifetime>& lifetimes) noexcept
+{
+    TNDR_PROFILER_TRACE("TransientResourceAllocator::plan");
+    tndr_assert(resources.size() == lifetimes.size(), "");
+
+    core::Array<ResourceId> sorted_resources;
+    sorted_resources.reserve(resources.size());
+    for (usize i = 0; i < resources.size(); ++i) {
+        // Resources used only by culled passes have an empty lifetime.
+        const Lifetime& lifetime = lifetimes[i];
+        if (resources[i]->is_transient() &&
+            (lifetime.first_level <= lifetime.last_level)) {
+            sorted_resources.push_back(static_cast<ResourceId>(i));
+        }
+    }
+
+    std::stable_sort(
+        sorted_resources.begin(),
+        sorted_resources.end(),
+        [&](const ResourceId lhs, const ResourceId rhs) {
+            return lifetimes[static_cast<usize>(lhs)].first_level <
+                   lifetimes[static_cast<usize>(rhs)].first_level;
+        });
+
+    for (const ResourceId resource_id : sorted_resources) {
+        const IBaseResource* resource = resources[static_cast<usize>(resource_id)].get();
+        const Lifetime& lifetime = lifetimes[static_cast<usize>(resource_id)];
+
+        Slot* slot = nullptr;
+
+        switch (resource->get_resource_type()) {
+            case ResourceType::Texture: {
+                const TextureCreateInfo& create_info =
+                    static_cast<const TextureResource*>(resource)->get_create_info();
+
+                if ((create_info.memory_type == MemoryType::GPU) && !lifetime.is_async) {
+                    for (Slot& s : m_slots) {
+                        if ((s.resource_type == ResourceType::Texture) && !s.is_async &&
+                            (s.last_level < lifetime.first_level) &&
+                            is_same_texture(s.texture_create_info, create_info)) {
+                            slot = &s;
+                            break;
+                        }
+                    }
+                }
+
+                if (slot == nullptr) {
+                    slot = &m_slots.emplace_back(Slot {
+                        .resource_type = ResourceType::Texture,
+                        .texture_create_info = create_info,
+                        .name = resource->get_name(),
+                        .is_async = lifetime.is_async,
+                    });
+                }
+                break;
+            }
+            case ResourceType::Buffer: {
+                const BufferCreateInfo& create_info =
+                    static_cast<const BufferResource*>(resource)->get_create_info();
+
+                if ((create_info.memory_type == MemoryType::GPU) && !lifetime.is_async) {
+                    // Best fit. When no slot is large enough, the largest one is grown.
+                    for (Slot& s : m_slots) {
+                        if ((s.resource_type != ResourceType::Buffer) || s.is_async ||
+                            (s.last_level >= lifetime.first_level) ||
+                            !is_compatible_buffer(s.buffer_create_info, create_info)) {
+                            continue;
+                        }
+
+                        if (slot == nullptr) {
+                            slot = &s;
+                            continue;
+                        }
+
+                        const u64 size = create_info.size;
+                        const u64 slot_size = slot->buffer_create_info.size;
+                        const u64 s_size = s.buffer_create_info.size;
+                        const bool fits = s_size >= size;
+                        const bool slot_fits = slot_size >= size;
+
+                        if ((fits && (!slot_fits || (s_size < slot_size))) ||
+                            (!fits && !slot_fits && (s_size > slot_size))) {
+                            slot = &s;
+                        }
+                    }
+                }
+
+                if (slot == nullptr) {
+                    slot = &m_slots.emplace_back(Slot {
+                        .resource_type = ResourceType::Buffer,
+                        .buffer_create_info = create_info,
+                        .name = resource->get_name(),
+                        .is_async = lifetime.is_async,
+                    });
+                } else {
+                    slot->buffer_create_info.size = math::max(
+                        slot->buffer_create_info.size, create_info.size);
+                }
+                break;
+            }
+            default:
+                core::unreachable();
+        }
+
+        if (slot->last_resource != NULL_RESOURCE_ID) {
+            m_aliases.insert({ resource_id, slot->last_resource });
+        }
+
+        slot->last_level = lifetime.last_level;
+        slot->last_resource = resource_id;
+        slot->resources.push_back(resource_id);
+    }
+}
+
+void TransientResourceAllocator::allocate(
+    rhi::IRHIContext* context, Registry& registry) noexcept
+{
+    TNDR_PROFILER_TRACE("TransientResourceAllocator::allocate");
+
+    for (const Slot& slot : m_slots) {
+        switch (slot.resource_type) {
+            case ResourceType::Texture: {
+                const rhi::TextureHandle handle = this->acquire_texture(context, slot);
+                for (const ResourceId resource : slot.resources) {
+                    registry.add_texture(TextureHandle { resource }, handle);
+                }
+                break;
+            }
+            case ResourceType::Buffer: {
+                const rhi::BufferHandle handle = this->acquire_buffer(context, slot);
+                for (const ResourceId resource : slot.resources) {
+                    registry.add_buffer(BufferHandle { resource }, handle);
+                }
+                break;
+            }
+            default:
+                core::unreachable();
+        }
+    }
+}
+
+void TransientResourceAllocator::release(rhi::IRHIContext* context) noexcept
+{
+    TNDR_PROFILER_TRACE("TransientResourceAllocator::release");
+
+    static_assert(MAX_UNUSED_FRAMES >= rhi::config::MAX_FRAMES_IN_FLIGHT);
+
+    const auto is_stale = [&](const u64 last_used_frame) {
+        return (m_frame_index - last_used_frame) >= MAX_UNUSED_FRAMES;
+    };
+
+    core::erase_if(m_texture_pool, [&](auto& entry) {
+        core::erase_if(entry.second, [&](const PhysicalTexture& texture) {
+            if (is_stale(texture.last_used_frame)) {
+                context->destroy_texture(texture.handle);
+                return true;
+            }
+            return false;
+        });
+        return entry.second.empty();
+    });
+
+    core::erase_if(m_buffer_pool, [&](auto& entry) {
+        core::erase_if(entry.second, [&](const PhysicalBuffer& buffer) {
+            if (is_stale(buffer.last_used_frame)) {
+                context->destroy_buffer(buffer.handle);
+                return true;
+            }
+            return false;
+        });
+        return entry.second.empty();
+    });
+
+    m_frame_index += 1;
+}
+
+void TransientResourceAllocator::destroy(rhi::IRHIContext* context) noexcept
+{
+    TNDR_PROFILER_TRACE("TransientResourceAllocator::destroy");
+
+    for (const auto& [_, textures] : m_texture_pool) {
+        for (const PhysicalTexture& texture : textures) {
+            context->destroy_texture(texture.handle);
+        }
+    }
+    m_texture_pool.clear();
+
+    for (const auto& [_, buffers] : m_buffer_pool) {
+        for (const PhysicalBuffer& buffer : buffers) {
+            context->destroy_buffer(buffer.handle);
+        }
+    }
+    m_buffer_pool.clear();
+}
+
+ResourceId TransientResourceAllocator::get_aliased_resource(
+    const ResourceId resource) const noexcept
+{
+    if (const auto it = m_aliases.find(resource); it != m_aliases.end()) {
+        return it->second;
+    }
+
+    return NULL_RESOURCE_ID;
+}
+
+void TransientResourceAllocator::reset() noexcept
+{
+    m_slots.clear();
+    m_aliases.clear();
+}
+
+rhi::TextureHandle TransientResourceAllocator::acquire_texture(
+    rhi::IRHIContext* context, const Slot& slot) noexcept
+{
+    const TextureCreateInfo& create_info = slot.texture_create_info;
+    core::Array<PhysicalTexture>& textures =
+        m_texture_pool[core::Hash<TextureCreateInfo> {}(create_info)];
+
+    for (PhysicalTexture& texture : textures) {
+        if (this->is_reusable(
+                texture.last_used_frame,
+                create_info.memory_type,
+                slot.is_async || texture.is_async) &&
+            is_same_texture(texture.create_info, create_info)) {
+            texture.last_used_frame = m_frame_index;
+            texture.is_async = slot.is_async;
+            return texture.handle;
+        }
+    }
+
+    const rhi::TextureHandle handle = context->create_texture(rhi::TextureCreateInfo {
+        .kind = create_info.kind,
+        .format = create_info.format,
+        .usage = create_info.usage,
+        .tiling = create_info.tiling,
+        .memory_type = create_info.memory_type,
+        .name = slot.name,
+    });
+
+    textures.push_back(PhysicalTexture {
+        .handle = handle,
+        .create_info = create_info,
+        .last_used_frame = m_frame_index,
+        .is_async = slot.is_async,
+    });
+
+    return handle;
+}
+
+rhi::BufferHandle TransientResourceAllocator::acquire_buffer(
+    rhi::IRHIContext* context, const Slot& slot) noexcept
+{
+    const BufferCreateInfo& create_info = slot.buffer_create_info;
+    core::Array<PhysicalBuffer>& buffers =
+        m_buffer_pool[core::Hash<BufferCreateInfo> {}(create_info)];
+
+    for (PhysicalBuffer& buffer : buffers) {
+        if (this->is_reusable(
+                buffer.last_used_frame,
+                create_info.memory_type,
+                slot.is_async || buffer.is_async) &&
+            is_compatible_buffer(buffer.create_info, create_info) &&
+            (buffer.create_info.size == create_info.size)) {
+            buffer.last_used_frame = m_frame_index;
+            buffer.is_async = slot.is_async;
+            return buffer.handle;
+        }
+    }
+
+    const rhi::BufferHandle handle = context->create_buffer(rhi::BufferCreateInfo {
+        .usage = create_info.usage,
+        .memory_type = create_info.memory_type,
+        .size = create_info.size,
+        .name = slot.name,
+    });
+
+    buffers.push_back(PhysicalBuffer {
+        .handle = handle,
+        .create_info = create_info,
+        .last_used_frame = m_frame_index,
+        .is_async = slot.is_async,
+    });
+
+    return handle;
+}
+
+bool TransientResourceAllocator::is_reusable(
+    const u64 last_used_frame,
+    const MemoryType memory_type,
+    const bool is_async) const noexcept
+{
+    if (last_used_frame == m_frame_index) {
+        return false;
+    }
+
+    const u64 frames_since_use = m_frame_index - last_used_frame;
+
+    // The host writes host visible resources while passes are recorded, before `submit`
+    // waits for the fence of frame `m_frame_index - MAX_FRAMES_IN_FLIGHT`. That frame can
+    // still be reading the resource, so it is reused one frame later.
+    if (memory_type != MemoryType::GPU) {
+        return frames_since_use > rhi::config::MAX_FRAMES_IN_FLIGHT;
+    }
+
+    // Async queues are not ordered with the graphics queue of the next frame, but the
+    // GPU work of this frame starts after the fence wait.
+    if (is_async) {
+        return frames_since_use >= rhi::config::MAX_FRAMES_IN_FLIGHT;
+    }
+
+    return true;
+}
+
+} // namespace tundra::renderer::frame_graph
@@ -0,0 +1,117 @@
+#include "core/core.h"
+#include "core/std/containers/array.h"
+#include "rhi/resources/concurrent_handle_manager.h"
+#include "rhi/resources/handle.h"
+#include "rhi/resources/handle_manager.h"
+#include <atomic>
+#include <chrono>
+#include <fmt/core.h>
+#include <random>
+#include <thread>
+
+// Measures random lookups of live objects with `HandleManager` and
+// `ConcurrentHandleManager`, from one thread and from all hardware threads.
+
+namespace tundra {
+
+namespace {
+
+/// About the size of the Vulkan backend resources.
+struct Object {
+    u64 data[12] = {};
+};
+
+static constexpr usize NUM_OBJECTS = 100'000;
+static constexpr usize NUM_LOOKUPS_PER_THREAD = 10'000'000;
+/// Lookups cycle through this many random indices, so the generator is not measured.
+static constexpr usize NUM_RANDOM_INDICES = 1 << 16;
+
+/// Returns the number of lookups per second.
+template <typename Manager>
+[[nodiscard]] f64 run_lookups(
+    const Manager& manager,
+    const core::Array<rhi::BufferHandleType>& handles,
+    const u32 num_threads) noexcept
+{
+    std::atomic<bool> is_started = false;
+    std::atomic<u64> sink = 0;
+
+    core::Array<std::thread> threads;
+    threads.reserve(num_threads);
+    for (u32 thread_index = 0; thread_index < num_threads; ++thread_index) {
+        threads.emplace_back([&, thread_index] {
+            std::mt19937 generator(thread_index);
+            std::uniform_int_distribution<usize> distribution(0, handles.size() - 1);
+            core::Array<usize> indices(NUM_RANDOM_INDICES);
+            for (usize& index : indices) {
+                index = distribution(generator);
+            }
+
+            while (!is_started.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            u64 sum = 0;
+            for (usize i = 0; i < NUM_LOOKUPS_PER_THREAD; ++i) {
+                const rhi::BufferHandleType handle =
+                    handles[indices[i % NUM_RANDOM_INDICES]];
+                sum += *manager.with(
+                    handle, [](const Object& object) { return object.data[0]; });
+            }
+            sink.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    is_started.store(true, std::memory_order_release);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const f64 seconds = std::chrono::duration<f64>(end - begin).count();
+    return static_cast<f64>(NUM_LOOKUPS_PER_THREAD * num_threads) / seconds;
+}
+
+template <typename Manager>
+void run_benchmark(const char* name) noexcept
+{
+    Manager manager(name);
+
+    core::Array<rhi::BufferHandleType> handles;
+    handles.reserve(NUM_OBJECTS);
+    for (usize i = 0; i < NUM_OBJECTS; ++i) {
+        handles.push_back(manager.add());
+    }
+
+    core::Array<u32> thread_counts { 1 };
+    if (std::thread::hardware_concurrency() > 1) {
+        thread_counts.push_back(std::thread::hardware_concurrency());
+    }
+
+    for (const u32 threads : thread_counts) {
+        const f64 lookups_per_second = run_lookups(manager, handles, threads);
+        fmt::print(
+            "{}: {} thread(s): {:.1f}M lookups/s\n",
+            name,
+            threads,
+            lookups_per_second / 1'000'000.0);
+    }
+
+    for (const rhi::BufferHandleType handle : handles) {
+        [[maybe_unused]] const bool is_destroyed = manager.destroy(handle);
+    }
+}
+
+} // namespace
+
+} // namespace tundra
+
+int main()
+{
+    using namespace tundra;
+
+    run_benchmark<rhi::HandleManager<rhi::BufferHandleType, Object>>("HandleManager");
+    run_benchmark<rhi::ConcurrentHandleManager<rhi::BufferHandleType, Object>>(
+        "ConcurrentHandleManager");
+}
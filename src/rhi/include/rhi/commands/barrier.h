@@ -1,6 +1,7 @@
 #pragma once
 #include "rhi/rhi_export.h"
 #include "core/core.h"
+#include "core/std/containers/array.h"
 #include "core/std/option.h"
 #include "rhi/enums.h"
 #include "rhi/resources/access_flags.h"
@@ -39,4 +40,18 @@ struct RHI_API BufferBarrier {
     BufferSubresourceRange subresource_range;
 };
 
+/// A barrier split into a signal (`CommandEncoder::set_event`) and a wait
+/// (`CommandEncoder::wait_event`). Commands recorded between the two halves
+/// can overlap the transition.
+///
+/// Both halves must use the same barriers, and must be submitted to the same queue.
+/// Queue ownership transfers are not allowed.
+struct RHI_API SplitBarrier {
+    /// Identifies the event. Unique within one `IRHIContext::submit` call.
+    u32 event = 0;
+    core::Option<GlobalBarrier> global_barrier;
+    core::Array<TextureBarrier> texture_barriers;
+    core::Array<BufferBarrier> buffer_barriers;
+};
+
 } // namespace tundra::rhi
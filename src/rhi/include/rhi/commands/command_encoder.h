@@ -1,7 +1,7 @@
 #pragma once
 #include "rhi/rhi_export.h"
 #include "core/core.h"
-#include "core/memory/linear_allocator.h"
+#include "core/memory/page_allocator.h"
 #include "core/std/containers/array.h"
 #include "core/std/panic.h"
 #include "core/std/span.h"
@@ -17,10 +17,11 @@
 
 namespace tundra::rhi {
 
-///
+/// Commands are allocated from pages of the `core::memory::PagePool` of the thread
+/// constructing the encoder, so the number of commands is not limited.
 class RHI_API CommandEncoder {
 private:
-    core::memory::LinearAllocator m_command_allocator;
+    core::memory::PageAllocator m_command_allocator;
     commands::BaseCommand* m_root_command;
     commands::BaseCommand** m_command_link;
     usize m_num_commands = 0;
@@ -223,6 +224,42 @@ public:
     ///
     void buffer_barrier(core::Array<BufferBarrier> barriers) noexcept;
 
+    /// Signals `barrier.event` once previous commands finish the accesses
+    /// described by `barrier`.
+    void set_event(SplitBarrier barrier) noexcept;
+
+    /// Waits until `barrier.event` is signaled, and makes the accesses described by
+    /// `barrier` available. `barrier` must be the same as in `set_event`.
+    void wait_event(SplitBarrier barrier) noexcept;
+
+    /// Writes the GPU time into `query` at `stage`. Begin a measured range with
+    /// `TimestampStage::Top` and end it with `TimestampStage::Bottom`.
+    /// Results are read with `IRHIContext::get_timestamps`.
+    ///
+    /// `query` must be lower than `config::MAX_TIMESTAMP_QUERIES`, and written at most
+    /// once in one `IRHIContext::submit` call.
+    /// Timestamps are not supported on `QueueType::Transfer`.
+    void write_timestamp(const u32 query, const TimestampStage stage) noexcept;
+
+    /// Starts counting pipeline statistics of the following commands into `query`.
+    /// Results are read with `IRHIContext::get_pipeline_statistics`.
+    ///
+    /// `query` must be lower than `config::MAX_PIPELINE_STATISTICS_QUERIES`, and used
+    /// at most once in one `IRHIContext::submit` call. Queries can't be nested, and must
+    /// begin and end outside of a render pass.
+    /// Pipeline statistics are supported only on `QueueType::Graphics`.
+    void begin_pipeline_statistics(const u32 query) noexcept;
+
+    /// Stops counting pipeline statistics into `query`.
+    void end_pipeline_statistics(const u32 query) noexcept;
+
+    /// Executes commands of `bundle`, see `IRHIContext::create_recorded_bundle`.
+    ///
+    /// Must be called outside of a render pass. The bundle may change the bound
+    /// pipeline, the viewport, the scissor, the culling mode and the index buffer,
+    /// so they must be set again before the following draws.
+    void execute_recorded_bundle(const RecordedBundleHandle bundle) noexcept;
+
 public:
     /// Reset a command encoder to the initial state.
     void reset() noexcept;
@@ -282,6 +319,12 @@ public:
                     CASE(GlobalBarrier)
                     CASE(TextureBarrier)
                     CASE(BufferBarrier)
+                    CASE(SetEvent)
+                    CASE(WaitEvent)
+                    CASE(WriteTimestamp)
+                    CASE(BeginPipelineStatistics)
+                    CASE(EndPipelineStatistics)
+                    CASE(ExecuteRecordedBundle)
 #undef CASE
                     default:
                         core::panic("Invalid command type!");
@@ -39,6 +39,12 @@ enum class CommandType : u8 {
     GlobalBarrier,
     TextureBarrier,
     BufferBarrier,
+    SetEvent,
+    WaitEvent,
+    WriteTimestamp,
+    BeginPipelineStatistics,
+    EndPipelineStatistics,
+    ExecuteRecordedBundle,
 };
 
 ///
@@ -231,4 +237,32 @@ struct RHI_API BufferBarrierCommand : public Command<CommandType::BufferBarrier>
     core::Array<BufferBarrier> barriers;
 };
 
+struct RHI_API SetEventCommand : public Command<CommandType::SetEvent> {
+    SplitBarrier barrier;
+};
+
+struct RHI_API WaitEventCommand : public Command<CommandType::WaitEvent> {
+    SplitBarrier barrier;
+};
+
+struct RHI_API WriteTimestampCommand : public Command<CommandType::WriteTimestamp> {
+    u32 query;
+    TimestampStage stage;
+};
+
+struct RHI_API BeginPipelineStatisticsCommand
+    : public Command<CommandType::BeginPipelineStatistics> {
+    u32 query;
+};
+
+struct RHI_API EndPipelineStatisticsCommand
+    : public Command<CommandType::EndPipelineStatistics> {
+    u32 query;
+};
+
+struct RHI_API ExecuteRecordedBundleCommand
+    : public Command<CommandType::ExecuteRecordedBundle> {
+    RecordedBundleHandle bundle;
+};
+
 } // namespace tundra::rhi::commands
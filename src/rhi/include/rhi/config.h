@@ -3,12 +3,16 @@
 
 namespace tundra::rhi::config {
 
-/// 8MiB
-inline constexpr usize COMMAND_BUFFER_SIZE = 1024u * 1024u * 8u;
-
 ///
 inline constexpr u32 MAX_FRAMES_IN_FLIGHT = 2;
 
+/// Number of timestamp queries that can be written in one `IRHIContext::submit` call.
+inline constexpr u32 MAX_TIMESTAMP_QUERIES = 1024;
+
+/// Number of pipeline statistics queries that can be used in one `IRHIContext::submit`
+/// call.
+inline constexpr u32 MAX_PIPELINE_STATISTICS_QUERIES = 256;
+
 ///
 inline constexpr u32 MAX_NUM_ATTACHMENTS = 6;
 
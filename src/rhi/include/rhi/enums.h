@@ -18,6 +18,17 @@ enum class QueueType : u8 {
     Present,
 };
 
+/// Number of `QueueType`s. `Present` is the last queue type.
+inline constexpr usize NUM_QUEUE_TYPES = static_cast<usize>(QueueType::Present) + 1;
+
+/// Pipeline stage at which `CommandEncoder::write_timestamp` samples the GPU time.
+enum class TimestampStage : u8 {
+    /// As soon as the previous commands start. Use it to begin a measured range.
+    Top,
+    /// Once all previous commands finish. Use it to end a measured range.
+    Bottom,
+};
+
 ///
 enum class SynchronizationStage : u16 {
     NONE = 1 << 0,
@@ -75,6 +75,8 @@ enum class BufferAccessFlags : u16 {
     INDEX_BUFFER = 1 << 7,
     VERTEX_BUFFER = 1 << 8,
     INDIRECT_BUFFER = 1 << 9,
+    /// Read by the host, e.g. with `IRHIContext::read_buffer`.
+    HOST_READ = 1 << 10,
 };
 
 TNDR_ENUM_CLASS_FLAGS(BufferAccessFlags)
@@ -0,0 +1,359 @@
+#pragma once
+#include "rhi/rhi_export.h"
+#include "core/core.h"
+#include "core/std/assert.h"
+#include "core/std/containers/deque.h"
+#include "core/std/expected.h"
+#include "core/std/sync/lock.h"
+#include "core/std/traits/is_callable.h"
+#include "core/std/unique_ptr.h"
+#include "core/std/utils.h"
+#include "rhi/resources/handle_manager.h"
+#include <atomic>
+#include <new>
+#include <thread>
+
+#if TNDR_BUILD_DEBUG
+#include "core/logger.h"
+#endif
+
+namespace tundra::rhi {
+
+/// `ConcurrentHandleManager` is thread safe, and has the same interface as
+/// `HandleManager`.
+///
+/// Objects are stored in place, in chunks of slots that never move. Lookups (`with`,
+/// `with_mut`, `is_valid`) take no global lock: they validate the generation of a slot
+/// with atomics. Only allocation of slots is serialized.
+///
+/// Like in `HandleManager`, `with_mut` is serialized with other `with` and `with_mut`
+/// calls on the same object, by a reader-writer spin lock of its slot. Lookups of
+/// different objects never wait for each other.
+///
+/// `destroy` waits until lookups of the destroyed object return.
+template <typename FrontendType, typename BackendType>
+class ConcurrentHandleManager {
+private:
+    /// `(generation << 1) | is_alive`
+    using SlotState = u32;
+
+    /// `WRITER_BIT` is set while `with_mut` uses the object, and the rest of the bits
+    /// count `with` calls using it.
+    using SlotAccess = u32;
+    static constexpr SlotAccess WRITER_BIT = 1u << 31u;
+
+    ///
+    struct Slot {
+        std::atomic<SlotState> state = 0;
+        /// Number of lookups using `object`.
+        std::atomic<u32> num_users = 0;
+        /// See `SlotAccess`.
+        std::atomic<SlotAccess> access = 0;
+        /// See `mark_used`.
+        std::atomic<u64> last_used_epoch = 0;
+        /// Constructed by `add` and destroyed by `destroy`, while no lookup can use it.
+        alignas(BackendType) char object[sizeof(BackendType)];
+
+        [[nodiscard]] BackendType& get() noexcept
+        {
+            return *std::launder(reinterpret_cast<BackendType*>(object));
+        }
+    };
+
+    /// The number of slots is fixed, so every manager can hold the same number of
+    /// objects (`NUM_SLOTS_PER_CHUNK * MAX_NUM_CHUNKS`), whatever `BackendType` is.
+    static constexpr usize NUM_SLOTS_PER_CHUNK = 1024;
+    ///
+    static constexpr usize MAX_NUM_CHUNKS = 1024;
+    ///
+    static constexpr usize MIN_NUM_FREE_HANDLES = 1024;
+
+    ///
+    struct Chunk {
+        Slot slots[NUM_SLOTS_PER_CHUNK];
+    };
+
+    ///
+    struct Inner {
+        core::Deque<FrontendType> free_list;
+    };
+
+private:
+    core::Lock<Inner> m_inner;
+    /// Chunks below `m_num_slots` are written before `m_num_slots` is published.
+    core::UniquePtr<Chunk> m_chunks[MAX_NUM_CHUNKS];
+    std::atomic<usize> m_num_slots = 0;
+    const char* m_name;
+
+public:
+    explicit ConcurrentHandleManager(const char* name) noexcept
+        : m_name(name)
+    {
+    }
+
+    ~ConcurrentHandleManager() noexcept
+    {
+        const usize num_slots = m_num_slots.load(std::memory_order_acquire);
+
+        usize count = 0;
+        for (usize index = 0; index < num_slots; ++index) {
+            Slot& slot = this->get_slot(index);
+            if (is_alive(slot.state.load(std::memory_order_acquire))) {
+                slot.get().~BackendType();
+                count += 1;
+            }
+        }
+
+#if TNDR_BUILD_DEBUG
+        if (count > 0) {
+            tndr_warn("Leaked {} `{}` resources.", count, m_name);
+        }
+#endif
+    }
+
+    ConcurrentHandleManager(const ConcurrentHandleManager&) = delete;
+    ConcurrentHandleManager& operator=(const ConcurrentHandleManager&) = delete;
+
+public:
+    template <typename... Args>
+    [[nodiscard]] FrontendType add(Args&&... args) noexcept
+    {
+        const FrontendType handle = this->allocate_slot();
+
+        // The slot stays invalid until the object is constructed,
+        // so it is constructed outside of the lock.
+        Slot& slot = this->get_slot(handle.get_index());
+        new (slot.object) BackendType(core::forward<Args>(args)...);
+        slot.last_used_epoch.store(0, std::memory_order_relaxed);
+        slot.state.store(
+            make_state(handle.get_generation(), true), std::memory_order_release);
+
+        return handle;
+    }
+
+    /// Returns true if an object was alive, otherwise false.
+    [[nodiscard]] bool destroy(const FrontendType handle) noexcept
+    {
+        const u64 index = handle.get_index();
+        tndr_assert(index < m_num_slots.load(std::memory_order_acquire), "");
+
+        Slot& slot = this->get_slot(index);
+
+        // New lookups fail from now on. Only one `destroy` can succeed.
+        SlotState expected = make_state(handle.get_generation(), true);
+        const bool is_valid = slot.state.compare_exchange_strong(
+            expected, make_state(handle.get_generation() + 1, false));
+
+        if (!is_valid) {
+            return false;
+        }
+
+        // Wait for lookups that validated the slot before its state changed.
+        while (slot.num_users.load() != 0) {
+            std::this_thread::yield();
+        }
+
+        slot.get().~BackendType();
+
+        if ((handle.get_generation() + 1) < (FrontendType::MAX_GENERATION - 1)) {
+            m_inner.lock()->free_list.push_back(handle);
+        }
+
+        return true;
+    }
+
+    /// Returns true if object is alive, otherwise false.
+    [[nodiscard]] bool is_valid(const FrontendType handle) const noexcept
+    {
+        const u64 index = handle.get_index();
+        tndr_assert(index < m_num_slots.load(std::memory_order_acquire), "");
+
+        return this->get_slot(index).state.load(std::memory_order_acquire) ==
+               make_state(handle.get_generation(), true);
+    }
+
+    /// Records that the object is used by work submitted in `epoch`.
+    /// Epochs are increasing, and `0` means the object was never used.
+    ///
+    /// It is a single relaxed store. Readers of `get_last_used_epoch` must be
+    /// synchronized with the caller by other means.
+    void mark_used(const FrontendType handle, const u64 epoch) const noexcept
+    {
+        const u64 index = handle.get_index();
+        tndr_assert(index < m_num_slots.load(std::memory_order_acquire), "");
+
+        this->get_slot(index).last_used_epoch.store(epoch, std::memory_order_relaxed);
+    }
+
+    /// Returns the last epoch passed to `mark_used` for the object.
+    [[nodiscard]] u64 get_last_used_epoch(const FrontendType handle) const noexcept
+    {
+        const u64 index = handle.get_index();
+        tndr_assert(index < m_num_slots.load(std::memory_order_acquire), "");
+
+        return this->get_slot(index).last_used_epoch.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] const char* get_name() const noexcept
+    {
+        return m_name;
+    }
+
+    /// @see `HandleManager::with`
+    template <
+        core::traits::callable<const BackendType&> Func,
+        typename Data = std::invoke_result_t<Func, const BackendType&>>
+    [[nodiscard]] core::Expected<Data, HandleManagerError> with(
+        const FrontendType handle, Func func) const noexcept
+    {
+        return this->lookup<Data>(handle, [&](Slot& slot) -> Data {
+            lock_shared(slot);
+            if constexpr (std::is_same_v<Data, void>) {
+                func(static_cast<const BackendType&>(slot.get()));
+                unlock_shared(slot);
+            } else {
+                Data data = func(static_cast<const BackendType&>(slot.get()));
+                unlock_shared(slot);
+                return data;
+            }
+        });
+    }
+
+    /// @see `HandleManager::with`
+    ///
+    /// `func` must not look up the same object again, because that would deadlock.
+    template <
+        core::traits::callable<BackendType&> Func,
+        typename Data = std::invoke_result_t<Func, BackendType&>>
+    [[nodiscard]] core::Expected<Data, HandleManagerError> with_mut(
+        const FrontendType handle, Func func) noexcept
+    {
+        return this->lookup<Data>(handle, [&](Slot& slot) -> Data {
+            lock_exclusive(slot);
+            if constexpr (std::is_same_v<Data, void>) {
+                func(slot.get());
+                unlock_exclusive(slot);
+            } else {
+                Data data = func(slot.get());
+                unlock_exclusive(slot);
+                return data;
+            }
+        });
+    }
+
+private:
+    [[nodiscard]] static constexpr SlotState make_state(
+        const u64 generation, const bool is_alive) noexcept
+    {
+        return (static_cast<SlotState>(generation) << 1) |
+               static_cast<SlotState>(is_alive);
+    }
+
+    [[nodiscard]] static constexpr bool is_alive(const SlotState state) noexcept
+    {
+        return (state & 1) != 0;
+    }
+
+    static void lock_shared(Slot& slot) noexcept
+    {
+        SlotAccess access = slot.access.load(std::memory_order_relaxed);
+        while (true) {
+            if ((access & WRITER_BIT) != 0) {
+                std::this_thread::yield();
+                access = slot.access.load(std::memory_order_relaxed);
+            } else if (slot.access.compare_exchange_weak(
+                           access, access + 1, std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+
+    static void unlock_shared(Slot& slot) noexcept
+    {
+        slot.access.fetch_sub(1, std::memory_order_release);
+    }
+
+    static void lock_exclusive(Slot& slot) noexcept
+    {
+        SlotAccess expected = 0;
+        while (!slot.access.compare_exchange_weak(
+            expected, WRITER_BIT, std::memory_order_acquire)) {
+            expected = 0;
+            std::this_thread::yield();
+        }
+    }
+
+    static void unlock_exclusive(Slot& slot) noexcept
+    {
+        slot.access.store(0, std::memory_order_release);
+    }
+
+    /// Returns a handle to an empty slot.
+    [[nodiscard]] FrontendType allocate_slot() noexcept
+    {
+        auto inner = m_inner.lock();
+
+        if (inner->free_list.size() < MIN_NUM_FREE_HANDLES) {
+            const usize index = m_num_slots.load(std::memory_order_relaxed);
+            const usize chunk_index = index / NUM_SLOTS_PER_CHUNK;
+            tndr_assert(chunk_index < MAX_NUM_CHUNKS, "Too many resources.");
+
+            if (!m_chunks[chunk_index].is_valid()) {
+                m_chunks[chunk_index] = core::make_unique<Chunk>();
+            }
+
+            m_num_slots.store(index + 1, std::memory_order_release);
+
+            return FrontendType(static_cast<u64>(index), 0);
+        } else {
+            const FrontendType old_handle = inner->free_list.front();
+            inner->free_list.pop_front();
+
+            return FrontendType(old_handle.get_index(), old_handle.get_generation() + 1);
+        }
+    }
+
+    [[nodiscard]] Slot& get_slot(const usize index) const noexcept
+    {
+        return m_chunks[index / NUM_SLOTS_PER_CHUNK]->slots[index % NUM_SLOTS_PER_CHUNK];
+    }
+
+    template <typename Data, typename Func>
+    [[nodiscard]] core::Expected<Data, HandleManagerError> lookup(
+        const FrontendType handle, Func func) const noexcept
+    {
+        if (handle.is_null()) {
+            return core::make_unexpected(HandleManagerError::NullHandle);
+        }
+
+        const u64 index = handle.get_index();
+        if (index >= m_num_slots.load(std::memory_order_acquire)) {
+            return core::make_unexpected(HandleManagerError::InvalidHandle);
+        }
+
+        Slot& slot = this->get_slot(index);
+
+        // Sequentially consistent, so either `destroy` sees this lookup in `num_users`,
+        // or this lookup sees the state written by `destroy`.
+        slot.num_users.fetch_add(1);
+        const bool is_valid = slot.state.load() ==
+                              make_state(handle.get_generation(), true);
+
+        if (is_valid) {
+            if constexpr (std::is_same_v<Data, void>) {
+                func(slot);
+                slot.num_users.fetch_sub(1, std::memory_order_release);
+                return {};
+            } else {
+                Data data = func(slot);
+                slot.num_users.fetch_sub(1, std::memory_order_release);
+                return data;
+            }
+        } else {
+            slot.num_users.fetch_sub(1, std::memory_order_release);
+            return core::make_unexpected(HandleManagerError::InvalidHandle);
+        }
+    }
+};
+
+} // namespace tundra::rhi
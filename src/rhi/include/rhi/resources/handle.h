@@ -93,8 +93,16 @@ enum class HandleType : u64 {
     Texture,
     TextureView,
     Sampler,
+    RecordedBundle,
 };
 
+/// Returns the type of a handle from its id, see `Handle::get_id`.
+[[nodiscard]] constexpr HandleType get_handle_type(const u64 id) noexcept
+{
+    return static_cast<HandleType>(
+        (id & Handle<0>::HANDLE_TYPE_MASK) >> Handle<0>::HANDLE_TYPE_SHIFT);
+}
+
 namespace handle_impl {
 
 ///
@@ -202,6 +210,7 @@ TNDR_HANDLE(ComputePipelineHandle, ComputePipelineHandleType, HandleType::Comput
 TNDR_HANDLE(
     GraphicsPipelineHandle, GraphicsPipelineHandleType, HandleType::GraphicsPipeline)
 TNDR_HANDLE(SwapchainHandle, SwapchainHandleType, HandleType::Swapchain)
+TNDR_HANDLE(RecordedBundleHandle, RecordedBundleHandleType, HandleType::RecordedBundle)
 
 #undef TNDR_BINDABLE_HANDLE
 #undef TNDR_HANDLE
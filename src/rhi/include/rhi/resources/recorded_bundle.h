@@ -0,0 +1,22 @@
+#pragma once
+#include "rhi/rhi_export.h"
+#include "core/core.h"
+#include "core/std/containers/string.h"
+#include "rhi/commands/command_encoder.h"
+#include "rhi/enums.h"
+
+namespace tundra::rhi {
+
+/// Commands of a recorded bundle are decoded once, when it is created, and can be
+/// executed by any number of command encoders with
+/// `CommandEncoder::execute_recorded_bundle`.
+struct RHI_API RecordedBundleCreateInfo {
+    /// Type of the queue of command encoders executing the bundle.
+    QueueType queue_type;
+    /// Commands of the bundle, from `begin_command_buffer` to `end_command_buffer`.
+    /// They must not use events or queries, and must not execute other bundles.
+    CommandEncoder encoder;
+    core::String name;
+};
+
+} // namespace tundra::rhi
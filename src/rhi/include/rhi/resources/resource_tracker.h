@@ -1,10 +1,11 @@
 #pragma once
 #include "rhi/rhi_export.h"
 #include "core/core.h"
+#include "core/std/containers/array.h"
 #include "core/std/containers/hash_map.h"
-#include "core/std/containers/hash_set.h"
-#include "core/std/function.h"
+#include "core/std/sync/lock.h"
 #include "core/std/sync/rw_lock.h"
+#include "rhi/resources/handle.h"
 #include <atomic>
 
 namespace tundra::rhi {
@@ -19,33 +20,37 @@ namespace tundra::rhi {
 ///
 /// # The goal
 /// The role of the resource tracker is to track resources lifetimes by using
-/// an atomic reference counter, and destroying them only when they are not referenced.
+/// an atomic reference counter. Resources that are no longer referenced are released,
+/// and the backend destroys them in batches (see `take_released_resources`).
+///
+/// References are held by the user and by resources depending on other resources
+/// (e.g. texture views). Command buffers hold no references. Instead, the backend records
+/// the last submission that used a resource, and delays destruction of a released
+/// resource until that submission finishes.
 ///
 /// # Thread safety
 /// `ResourceTracker` is thread safe.
-/// `Resources` is **not** thread safe, and should be used on per-thread basis.
 class RHI_API ResourceTracker {
 public:
-    /// `Resources` is **not** thread safe, and should be used on per-thread basis.
-    struct RHI_API Resources {
-        core::HashSet<u64> resources;
-
-        void add_reference(ResourceTracker& resource_tracker, const u64 resource) noexcept;
+    /// A resource that is not referenced anymore, and can be destroyed.
+    struct RHI_API ReleasedResource {
+        u64 resource;
+        BindableResource bindings;
     };
 
 private:
     ///
     struct Resource {
-        core::Function<void()> resource_destructor;
+        BindableResource bindings;
         std::atomic<i32> ref_count = 1;
 
-        Resource(core::Function<void()>&& func) noexcept
-            : resource_destructor(core::move(func))
+        Resource(const BindableResource resource_bindings) noexcept
+            : bindings(resource_bindings)
         {
         }
 
         Resource(const Resource& rhs) noexcept
-            : resource_destructor(rhs.resource_destructor)
+            : bindings(rhs.bindings)
         {
             ref_count.store(
                 rhs.ref_count.load(std::memory_order_acquire), std::memory_order_release);
@@ -54,7 +59,7 @@ private:
         Resource& operator=(const Resource& rhs) noexcept
         {
             if (&rhs != this) {
-                resource_destructor = rhs.resource_destructor;
+                bindings = rhs.bindings;
                 ref_count.store(
                     rhs.ref_count.load(std::memory_order_acquire),
                     std::memory_order_release);
@@ -63,7 +68,7 @@ private:
         }
 
         Resource(Resource&& rhs) noexcept
-            : resource_destructor(core::move(rhs.resource_destructor))
+            : bindings(rhs.bindings)
         {
             ref_count.store(
                 rhs.ref_count.load(std::memory_order_acquire), std::memory_order_release);
@@ -79,12 +84,17 @@ private:
 
 private:
     core::RwLock<Inner> m_inner;
+    core::Lock<core::Array<ReleasedResource>> m_released_resources;
 
 public:
-    void add_resource(const u64 resource, core::Function<void()>&& destructor) noexcept;
+    /// # Params
+    /// - bindings - Bindless descriptors of the resource, released with it.
+    void add_resource(const u64 resource, const BindableResource bindings = {}) noexcept;
     void add_reference(const u64 resource) noexcept;
     void remove_reference(const u64 resource) noexcept;
-    void remove_references(Resources& resources) noexcept;
+
+    /// Returns resources released since the last call.
+    [[nodiscard]] core::Array<ReleasedResource> take_released_resources() noexcept;
 };
 
 } // namespace tundra::rhi
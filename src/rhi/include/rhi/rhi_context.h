@@ -1,17 +1,23 @@
 #pragma once
 #include "rhi/rhi_export.h"
 #include "core/std/containers/array.h"
+#include "core/std/option.h"
 #include "rhi/queue.h"
 #include "rhi/resources/buffer.h"
 #include "rhi/resources/compute_pipeline.h"
 #include "rhi/resources/graphics_pipeline.h"
 #include "rhi/resources/handle.h"
+#include "rhi/resources/recorded_bundle.h"
 #include "rhi/resources/sampler.h"
 #include "rhi/resources/shader.h"
 #include "rhi/resources/swapchain.h"
 #include "rhi/resources/texture.h"
 #include "rhi/submit_info.h"
 
+namespace tundra::core {
+class ThreadPool;
+} // namespace tundra::core
+
 namespace tundra::rhi {
 
 ///
@@ -35,6 +41,49 @@ public:
         core::Array<SubmitInfo> submit_infos,
         core::Array<PresentInfo> present_infos) noexcept = 0;
 
+    /// Returns statistics of the last `submit` call. With the async submit, it is the
+    /// last call whose work was submitted to the GPU.
+    [[nodiscard]] virtual SubmitStatistics get_submit_statistics() const noexcept = 0;
+
+    /// Returns the number of `submit` calls made so far. Work of the `n`-th call,
+    /// counted from `1`, has finished once `get_num_completed_submits` returns at least
+    /// `n`.
+    [[nodiscard]] virtual u64 get_num_submits() const noexcept = 0;
+
+    /// Returns the number of `submit` calls whose work has finished on the GPU.
+    /// Calls finish in order. It is updated when a frame begins, so it can lag
+    /// behind the GPU by up to `config::MAX_FRAMES_IN_FLIGHT` calls.
+    [[nodiscard]] virtual u64 get_num_completed_submits() const noexcept = 0;
+
+    /// When set, `submit` decodes command encoders on worker threads of the
+    /// `thread_pool`, and `submit` must not be called from them.
+    /// `nullptr` decodes all command encoders on the calling thread.
+    virtual void set_thread_pool(core::ThreadPool* thread_pool) noexcept = 0;
+
+    /// When enabled, work of `submit` calls is decoded, submitted and presented on a
+    /// dedicated thread. `submit` returns once the frame can begin, i.e. when fewer than
+    /// `config::MAX_FRAMES_IN_FLIGHT` frames are in flight, so results of earlier frames
+    /// are available as without it.
+    ///
+    /// `submit` must be called from one thread at a time. Disabling it waits until all
+    /// submitted work is submitted to the GPU.
+    virtual void set_async_submit(const bool is_enabled) noexcept = 0;
+
+    /// Returns timestamps, in nanoseconds, indexed by a query. They were written by
+    /// `CommandEncoder::write_timestamp` in the `submit` call made
+    /// `config::MAX_FRAMES_IN_FLIGHT` calls before the last one.
+    ///
+    /// Results are read without waiting for the GPU. Queries that were not written,
+    /// or whose results are not available yet, are `None`.
+    [[nodiscard]] virtual core::Array<core::Option<u64>> get_timestamps()
+        const noexcept = 0;
+
+    /// Returns results of `CommandEncoder::begin_pipeline_statistics` queries,
+    /// indexed by a query. Like `get_timestamps`, they are `config::MAX_FRAMES_IN_FLIGHT`
+    /// `submit` calls old, and read without waiting for the GPU.
+    [[nodiscard]] virtual core::Array<core::Option<PipelineStatistics>>
+        get_pipeline_statistics() const noexcept = 0;
+
     /// Returns a valid handle to a swapchain.
     [[nodiscard]] virtual SwapchainHandle create_swapchain(
         const SwapchainCreateInfo& create_info) noexcept = 0;
@@ -53,6 +102,20 @@ public:
         const BufferHandle handle,
         const core::Array<BufferUpdateRegion>& update_regions) noexcept = 0;
 
+    /// Copies a range of a `MemoryType::Readback` buffer to the host.
+    /// It does not wait for the GPU, so the range must not be written by work that is
+    /// still in flight. Device writes must be followed by a barrier to
+    /// `BufferAccessFlags::HOST_READ`.
+    [[nodiscard]] virtual core::Array<char> read_buffer(
+        const BufferHandle handle, const BufferSubresourceRange& range) noexcept = 0;
+
+    /// Returns the persistently mapped memory of a `MemoryType::Upload` or
+    /// `MemoryType::Dynamic` buffer. It stays valid until the buffer is destroyed.
+    /// Writes to it are not synchronized, so the written range must not be read by work
+    /// that is still in flight.
+    [[nodiscard]] virtual core::Span<char> map_buffer(
+        const BufferHandle handle) noexcept = 0;
+
     /// Destroy a buffer.
     ///
     /// @param handle A valid handle to a buffer.
@@ -112,6 +175,17 @@ public:
     ///
     /// @param handle A valid handle to a sampler.
     virtual void destroy_sampler(const SamplerHandle handle) noexcept = 0;
+
+    /// Decodes commands of `create_info.encoder` once, and returns a valid handle to
+    /// a recorded bundle. Resources used by the bundle are kept alive until it is
+    /// destroyed.
+    [[nodiscard]] virtual RecordedBundleHandle create_recorded_bundle(
+        const RecordedBundleCreateInfo& create_info) noexcept = 0;
+
+    /// Destroy a recorded bundle.
+    ///
+    /// @param handle A valid handle to a recorded bundle.
+    virtual void destroy_recorded_bundle(const RecordedBundleHandle handle) noexcept = 0;
 };
 
 } // namespace tundra::rhi
@@ -10,8 +10,14 @@ namespace tundra::rhi {
 ///
 struct RHI_API SubmitInfo {
     core::Array<CommandEncoder> encoders;
+    /// Stages that wait for `wait_submit_infos`.
     SynchronizationStage synchronization_stage = SynchronizationStage::NONE;
     QueueType queue_type = QueueType::Graphics;
+    /// Indices of submit infos, passed earlier in the same `IRHIContext::submit` call,
+    /// that must finish before this submit info starts.
+    /// Submit infos on the same queue are ordered by barriers, so only waits on
+    /// other queues are needed.
+    core::Array<usize> wait_submit_infos;
 
     SubmitInfo() noexcept = default;
     ~SubmitInfo() noexcept = default;
@@ -30,4 +36,27 @@ struct RHI_API PresentInfo {
     TextureAccessFlags texture_previous_access = TextureAccessFlags::NONE;
 };
 
+/// Statistics of one `IRHIContext::submit` call.
+struct RHI_API SubmitStatistics {
+    /// Barriers recorded into command encoders.
+    u32 num_barriers = 0;
+    /// Barriers merged into other barriers, or covered by a global barrier.
+    u32 num_removed_barriers = 0;
+    /// Pipeline barrier commands recorded into command buffers.
+    u32 num_pipeline_barriers = 0;
+};
+
+/// Counters of a pipeline statistics query.
+struct RHI_API PipelineStatistics {
+    u64 input_assembly_vertices = 0;
+    u64 input_assembly_primitives = 0;
+    u64 vertex_shader_invocations = 0;
+    /// Primitives that reached the clipping stage, also from mesh shaders.
+    u64 clipping_invocations = 0;
+    /// Primitives that survived clipping and culling.
+    u64 clipping_primitives = 0;
+    u64 fragment_shader_invocations = 0;
+    u64 compute_shader_invocations = 0;
+};
+
 } // namespace tundra::rhi
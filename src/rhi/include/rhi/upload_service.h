@@ -0,0 +1,119 @@
+#pragma once
+#include "rhi/rhi_export.h"
+#include "core/core.h"
+#include "core/std/containers/array.h"
+#include "core/std/containers/deque.h"
+#include "core/std/option.h"
+#include "core/std/span.h"
+#include "rhi/commands/barrier.h"
+#include "rhi/resources/access_flags.h"
+#include "rhi/resources/buffer.h"
+#include "rhi/resources/handle.h"
+#include "rhi/submit_info.h"
+
+namespace tundra::rhi {
+
+class IRHIContext;
+
+/// Identifies an upload. See `UploadService::is_complete`.
+using UploadTicket = u64;
+
+/// Uploads data to `MemoryType::GPU` buffers in the background.
+///
+/// Data is copied into a persistently mapped `MemoryType::Upload` staging ring buffer,
+/// and uploads added between two `flush` calls are copied on `QueueType::Transfer`
+/// in one batch. Staging memory of a batch is reused once its submit has finished.
+/// Data that does not fit into the ring gets a dedicated staging buffer.
+///
+/// When the transfer queue belongs to another queue family than the graphics queue,
+/// destination buffers are released by the transfer queue, and acquired by the graphics
+/// queue in the first `flush` after the copies have finished.
+///
+/// It is not thread safe.
+class RHI_API UploadService {
+public:
+    ///
+    static constexpr u64 DEFAULT_STAGING_BUFFER_SIZE = 64 * 1024 * 1024;
+    /// Alignment of uploads in the staging buffer.
+    static constexpr u64 ALIGNMENT = 16;
+
+private:
+    ///
+    struct PendingUpload {
+        BufferHandle staging_buffer;
+        u64 staging_offset;
+        BufferHandle dst;
+        u64 dst_offset;
+        u64 size;
+        BufferAccessFlags next_access;
+    };
+
+    /// Uploads copied by one submit.
+    struct Batch {
+        UploadTicket ticket;
+        /// `submit` call that executes the copies, see `IRHIContext::get_num_submits`.
+        u64 submit;
+        /// Position of the staging ring after the batch.
+        u64 staging_end;
+        core::Array<BufferBarrier> acquire_barriers;
+        core::Array<BufferHandle> dedicated_buffers;
+    };
+
+    /// A batch whose destination buffers are acquired by the graphics queue.
+    struct AcquiredBatch {
+        UploadTicket ticket;
+        /// `submit` call that executes the acquire barriers.
+        u64 submit;
+    };
+
+private:
+    IRHIContext* m_context;
+    bool m_needs_ownership_transfer;
+
+    BufferHandle m_staging_buffer;
+    core::Span<char> m_staging_memory;
+    /// Positions in the staging ring. They only grow, and are wrapped by its size.
+    u64 m_staging_head = 0;
+    u64 m_staging_tail = 0;
+
+    core::Array<PendingUpload> m_pending_uploads;
+    core::Array<BufferHandle> m_pending_dedicated_buffers;
+    core::Deque<Batch> m_batches;
+    core::Deque<AcquiredBatch> m_acquired_batches;
+    UploadTicket m_last_ticket = 0;
+    UploadTicket m_last_completed_ticket = 0;
+
+public:
+    UploadService(
+        IRHIContext* context,
+        const u64 staging_buffer_size = DEFAULT_STAGING_BUFFER_SIZE) noexcept;
+    ~UploadService() noexcept;
+    UploadService(const UploadService&) = delete;
+    UploadService& operator=(const UploadService&) = delete;
+
+public:
+    /// Copies `data` to `dst` at `dst_offset`.
+    ///
+    /// `dst` must be created with `BufferUsageFlags::TRANSFER_DESTINATION`, and must not
+    /// be used by the GPU until the upload is complete. `next_access` is the first access
+    /// of `dst` after the upload.
+    [[nodiscard]] UploadTicket upload_buffer(
+        const BufferHandle dst,
+        const u64 dst_offset,
+        const core::Span<const char> data,
+        const BufferAccessFlags next_access) noexcept;
+
+    /// Records uploads added since the last call, and barriers of finished uploads.
+    /// Returned submit infos must be passed first to the next `IRHIContext::submit`.
+    [[nodiscard]] core::Array<SubmitInfo> flush() noexcept;
+
+    /// Returns true when the data of `ticket` can be used by work submitted after the
+    /// last `flush`.
+    [[nodiscard]] bool is_complete(const UploadTicket ticket) const noexcept;
+
+private:
+    /// Returns an offset in the staging ring, or `None` when it is full.
+    [[nodiscard]] core::Option<u64> allocate_staging(const u64 size) noexcept;
+};
+
+} // namespace tundra::rhi
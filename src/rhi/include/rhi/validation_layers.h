@@ -22,6 +22,15 @@ public: // IRHIContext
     virtual void submit(
         core::Array<SubmitInfo> submit_infos,
         core::Array<PresentInfo> present_infos) noexcept final;
+    [[nodiscard]] virtual SubmitStatistics get_submit_statistics() const noexcept final;
+    [[nodiscard]] virtual u64 get_num_submits() const noexcept final;
+    [[nodiscard]] virtual u64 get_num_completed_submits() const noexcept final;
+    virtual void set_thread_pool(core::ThreadPool* thread_pool) noexcept final;
+    virtual void set_async_submit(const bool is_enabled) noexcept final;
+    [[nodiscard]] virtual core::Array<core::Option<u64>> get_timestamps()
+        const noexcept final;
+    [[nodiscard]] virtual core::Array<core::Option<PipelineStatistics>>
+        get_pipeline_statistics() const noexcept final;
     virtual const char* get_name() const noexcept final;
     [[nodiscard]] virtual GraphicsAPI get_graphics_api() const noexcept final;
     [[nodiscard]] virtual QueueFamilyIndices get_queue_family_indices()
@@ -34,6 +43,10 @@ public: // IRHIContext
     virtual void update_buffer(
         const BufferHandle handle,
         const core::Array<BufferUpdateRegion>& update_regions) noexcept final;
+    [[nodiscard]] virtual core::Array<char> read_buffer(
+        const BufferHandle handle, const BufferSubresourceRange& range) noexcept final;
+    [[nodiscard]] virtual core::Span<char> map_buffer(
+        const BufferHandle handle) noexcept final;
     virtual void destroy_buffer(const BufferHandle handle) noexcept final;
     [[nodiscard]] virtual TextureHandle create_texture(
         const TextureCreateInfo& create_info) noexcept final;
@@ -55,6 +68,10 @@ public: // IRHIContext
     [[nodiscard]] virtual SamplerHandle create_sampler(
         const SamplerCreateInfo& create_info) noexcept final;
     virtual void destroy_sampler(const SamplerHandle handle) noexcept final;
+    [[nodiscard]] virtual RecordedBundleHandle create_recorded_bundle(
+        const RecordedBundleCreateInfo& create_info) noexcept final;
+    virtual void destroy_recorded_bundle(
+        const RecordedBundleHandle handle) noexcept final;
 
 private:
     [[nodiscard]] auto& get_textures() noexcept
@@ -77,6 +94,11 @@ private:
         return m_graphics_pipelines;
     }
 
+    [[nodiscard]] auto& get_recorded_bundles() noexcept
+    {
+        return m_recorded_bundles;
+    }
+
 private:
     core::RwLock<core::HashMap<TextureHandleType, TextureCreateInfo>> m_textures;
     core::RwLock<core::HashMap<BufferHandleType, BufferCreateInfo>> m_buffers;
@@ -84,6 +106,7 @@ private:
         m_compute_pipelines;
     core::RwLock<core::HashMap<GraphicsPipelineHandleType, GraphicsPipelineCreateInfo>>
         m_graphics_pipelines;
+    core::RwLock<core::HashMap<RecordedBundleHandleType, QueueType>> m_recorded_bundles;
 
 private:
     friend class CommandEncoderValidator;
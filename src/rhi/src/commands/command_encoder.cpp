@@ -2,15 +2,12 @@
 #include "core/std/panic.h"
 #include "core/std/utils.h"
 #include "rhi/commands/commands.h"
-#include "rhi/config.h"
 #include <cstring>
 
 namespace tundra::rhi {
 
 CommandEncoder::CommandEncoder() noexcept
-    : m_command_allocator(config::COMMAND_BUFFER_SIZE)
-    , m_root_command(
-          static_cast<commands::BaseCommand*>(m_command_allocator.get_buffer()))
+    : m_root_command(nullptr)
     , m_command_link(&m_root_command)
 {
 }
@@ -27,6 +24,9 @@ CommandEncoder::CommandEncoder(CommandEncoder&& rhs) noexcept
     , m_num_commands(core::exchange(rhs.m_num_commands, 0))
     , m_state(core::move(rhs.m_state))
 {
+    if (m_command_link == &rhs.m_root_command) {
+        m_command_link = &m_root_command;
+    }
 }
 
 CommandEncoder& CommandEncoder::operator=(CommandEncoder&& rhs) noexcept
@@ -39,6 +39,10 @@ CommandEncoder& CommandEncoder::operator=(CommandEncoder&& rhs) noexcept
         m_command_link = core::exchange(rhs.m_command_link, nullptr);
         m_num_commands = core::exchange(rhs.m_num_commands, 0);
         m_state = core::move(rhs.m_state);
+
+        if (m_command_link == &rhs.m_root_command) {
+            m_command_link = &m_root_command;
+        }
     }
 
     return *this;
@@ -309,6 +313,49 @@ void CommandEncoder::buffer_barrier(core::Array<BufferBarrier> barriers) noexcep
     });
 }
 
+void CommandEncoder::set_event(SplitBarrier barrier) noexcept
+{
+    this->construct_command(commands::SetEventCommand {
+        .barrier = core::move(barrier),
+    });
+}
+
+void CommandEncoder::wait_event(SplitBarrier barrier) noexcept
+{
+    this->construct_command(commands::WaitEventCommand {
+        .barrier = core::move(barrier),
+    });
+}
+
+void CommandEncoder::write_timestamp(const u32 query, const TimestampStage stage) noexcept
+{
+    this->construct_command(commands::WriteTimestampCommand {
+        .query = query,
+        .stage = stage,
+    });
+}
+
+void CommandEncoder::begin_pipeline_statistics(const u32 query) noexcept
+{
+    this->construct_command(commands::BeginPipelineStatisticsCommand {
+        .query = query,
+    });
+}
+
+void CommandEncoder::end_pipeline_statistics(const u32 query) noexcept
+{
+    this->construct_command(commands::EndPipelineStatisticsCommand {
+        .query = query,
+    });
+}
+
+void CommandEncoder::execute_recorded_bundle(const RecordedBundleHandle bundle) noexcept
+{
+    this->construct_command(commands::ExecuteRecordedBundleCommand {
+        .bundle = bundle,
+    });
+}
+
 template <typename T>
 void destroy_command(T& command) noexcept
 {
@@ -353,6 +400,12 @@ void CommandEncoder::reset() noexcept
                 CASE(GlobalBarrier)
                 CASE(TextureBarrier)
                 CASE(BufferBarrier)
+                CASE(SetEvent)
+                CASE(WaitEvent)
+                CASE(WriteTimestamp)
+                CASE(BeginPipelineStatistics)
+                CASE(EndPipelineStatistics)
+                CASE(ExecuteRecordedBundle)
 #undef CASE
                 default:
                     core::panic("Invalid command type!");
@@ -363,8 +416,7 @@ void CommandEncoder::reset() noexcept
     }
 
     m_command_allocator.reset();
-    m_root_command = static_cast<commands::BaseCommand*>(
-        m_command_allocator.get_buffer());
+    m_root_command = nullptr;
     m_command_link = &m_root_command;
     m_num_commands = 0;
 
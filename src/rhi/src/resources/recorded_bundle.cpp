@@ -0,0 +1,5 @@
+#include "rhi/resources/recorded_bundle.h"
+
+namespace tundra::rhi {
+
+} // namespace tundra::rhi
@@ -1,32 +1,21 @@
 #include "rhi/resources/resource_tracker.h"
 #include "core/std/panic.h"
+#include "core/std/utils.h"
 
 namespace tundra::rhi {
 
-/////////////////////////////////////////////////////////////////////////////////////////
-// ResourceTracker::Resources
-
-void ResourceTracker::Resources::add_reference(
-    ResourceTracker& resource_tracker, const u64 resource) noexcept
-{
-    if (auto it = resources.find(resource); it == resources.end()) {
-        resources.insert(resource);
-        resource_tracker.add_reference(resource);
-    }
-}
-
 /////////////////////////////////////////////////////////////////////////////////////////
 // ResourceTracker
 
 void ResourceTracker::add_resource(
-    const u64 resource, core::Function<void()>&& destructor) noexcept
+    const u64 resource, const BindableResource bindings) noexcept
 {
     auto inner = m_inner.write();
 
     inner->resources.insert({
         resource,
         ResourceTracker::Resource {
-            core::move(destructor),
+            bindings,
         },
     });
 }
@@ -55,19 +44,27 @@ void ResourceTracker::remove_reference(const u64 resource) noexcept
     }();
 
     if ((value - 1) <= 0) {
-        auto inner = m_inner.write();
+        const BindableResource bindings = [&] {
+            auto inner = m_inner.write();
 
-        const auto it = inner->resources.find(resource);
-        (*it).second.resource_destructor();
-        inner->resources.erase(it);
+            const auto it = inner->resources.find(resource);
+            const BindableResource resource_bindings = (*it).second.bindings;
+            inner->resources.erase(it);
+            return resource_bindings;
+        }();
+
+        m_released_resources.lock()->push_back(ReleasedResource {
+            .resource = resource,
+            .bindings = bindings,
+        });
     }
 }
 
-void ResourceTracker::remove_references(ResourceTracker::Resources& resources) noexcept
+core::Array<ResourceTracker::ReleasedResource> ResourceTracker::
+    take_released_resources() noexcept
 {
-    for (const u64 resource : resources.resources) {
-        this->remove_reference(resource);
-    }
+    return core::exchange(
+        *m_released_resources.lock(), core::Array<ResourceTracker::ReleasedResource> {});
 }
 
 } // namespace tundra::rhi
@@ -0,0 +1,242 @@
+#include "rhi/upload_service.h"
+#include "core/profiler.h"
+#include "core/std/assert.h"
+#include "core/std/utils.h"
+#include "rhi/commands/command_encoder.h"
+#include "rhi/rhi_context.h"
+#include <cstring>
+
+namespace tundra::rhi {
+
+UploadService::UploadService(IRHIContext* context, const u64 staging_buffer_size) noexcept
+    : m_context(context)
+{
+    TNDR_PROFILER_TRACE("UploadService::UploadService");
+
+    tndr_assert(m_context != nullptr, "`context` must not be nullptr.");
+    tndr_assert(
+        (staging_buffer_size % ALIGNMENT) == 0,
+        "`staging_buffer_size` must be a multiple of ALIGNMENT.");
+
+    const QueueFamilyIndices queue_indices = m_context->get_queue_family_indices();
+    m_needs_ownership_transfer = queue_indices.transfer_queue !=
+                                 queue_indices.graphics_queue;
+
+    m_staging_buffer = m_context->create_buffer(BufferCreateInfo {
+        .usage = BufferUsageFlags::TRANSFER_SOURCE,
+        .memory_type = MemoryType::Upload,
+        .size = staging_buffer_size,
+        .name = "upload_service_staging_buffer",
+    });
+    m_staging_memory = m_context->map_buffer(m_staging_buffer);
+}
+
+UploadService::~UploadService() noexcept
+{
+    TNDR_PROFILER_TRACE("UploadService::~UploadService");
+
+    // Destruction of buffers is deferred until submitted work stops using them.
+    m_context->destroy_buffer(m_staging_buffer);
+
+    for (const BufferHandle buffer : m_pending_dedicated_buffers) {
+        m_context->destroy_buffer(buffer);
+    }
+
+    for (const Batch& batch : m_batches) {
+        for (const BufferHandle buffer : batch.dedicated_buffers) {
+            m_context->destroy_buffer(buffer);
+        }
+    }
+}
+
+UploadTicket UploadService::upload_buffer(
+    const BufferHandle dst,
+    const u64 dst_offset,
+    const core::Span<const char> data,
+    const BufferAccessFlags next_access) noexcept
+{
+    TNDR_PROFILER_TRACE("UploadService::upload_buffer");
+
+    tndr_assert(dst.is_valid(), "`dst` must be a valid handle.");
+    tndr_assert(!data.is_empty(), "`data` must not be empty.");
+
+    const u64 size = data.size();
+
+    BufferHandle staging_buffer;
+    u64 staging_offset = 0;
+    if (const core::Option<u64> offset = this->allocate_staging(size)) {
+        staging_buffer = m_staging_buffer;
+        staging_offset = *offset;
+        std::memcpy(m_staging_memory.data() + staging_offset, data.data(), data.size());
+    } else {
+        staging_buffer = m_context->create_buffer(BufferCreateInfo {
+            .usage = BufferUsageFlags::TRANSFER_SOURCE,
+            .memory_type = MemoryType::Upload,
+            .size = size,
+            .name = "upload_service_dedicated_staging_buffer",
+        });
+        std::memcpy(
+            m_context->map_buffer(staging_buffer).data(), data.data(), data.size());
+        m_pending_dedicated_buffers.push_back(staging_buffer);
+    }
+
+    m_pending_uploads.push_back(PendingUpload {
+        .staging_buffer = staging_buffer,
+        .staging_offset = staging_offset,
+        .dst = dst,
+        .dst_offset = dst_offset,
+        .size = size,
+        .next_access = next_access,
+    });
+
+    // Uploads are copied by the next `flush`.
+    return m_last_ticket + 1;
+}
+
+core::Array<SubmitInfo> UploadService::flush() noexcept
+{
+    TNDR_PROFILER_TRACE("UploadService::flush");
+
+    const u64 num_submits = m_context->get_num_submits();
+    const u64 num_completed_submits = m_context->get_num_completed_submits();
+
+    // Acquire barriers recorded by earlier calls were submitted, so later work on the
+    // graphics queue is ordered after them.
+    while (!m_acquired_batches.empty() &&
+           (m_acquired_batches.front().submit <= num_submits)) {
+        m_last_completed_ticket = m_acquired_batches.front().ticket;
+        m_acquired_batches.pop_front();
+    }
+
+    // Copies of finished batches are visible, and their staging memory can be reused.
+    core::Array<BufferBarrier> acquire_barriers;
+    while (!m_batches.empty() && (m_batches.front().submit <= num_completed_submits)) {
+        Batch& batch = m_batches.front();
+        m_staging_tail = batch.staging_end;
+
+        for (const BufferHandle buffer : batch.dedicated_buffers) {
+            m_context->destroy_buffer(buffer);
+        }
+
+        if (m_needs_ownership_transfer) {
+            acquire_barriers.insert(
+                acquire_barriers.end(),
+                batch.acquire_barriers.begin(),
+                batch.acquire_barriers.end());
+            m_acquired_batches.push_back(AcquiredBatch {
+                .ticket = batch.ticket,
+                .submit = num_submits + 1,
+            });
+        } else {
+            m_last_completed_ticket = batch.ticket;
+        }
+
+        m_batches.pop_front();
+    }
+
+    core::Array<SubmitInfo> submit_infos;
+
+    if (!m_pending_uploads.empty()) {
+        core::Array<BufferBarrier> barriers;
+
+        CommandEncoder encoder;
+        encoder.begin_command_buffer();
+
+        for (const PendingUpload& upload : m_pending_uploads) {
+            encoder.buffer_copy(
+                upload.staging_buffer,
+                upload.dst,
+                {
+                    BufferCopyRegion {
+                        .src_offset = upload.staging_offset,
+                        .dst_offset = upload.dst_offset,
+                        .size = upload.size,
+                    },
+                });
+
+            if (m_needs_ownership_transfer) {
+                barriers.push_back(BufferBarrier {
+                    .buffer = upload.dst,
+                    .previous_access = BufferAccessFlags::TRANSFER_DESTINATION,
+                    .next_access = upload.next_access,
+                    .source_queue = QueueType::Transfer,
+                    .destination_queue = QueueType::Graphics,
+                    .subresource_range =
+                        BufferSubresourceRange {
+                            .offset = upload.dst_offset,
+                            .size = upload.size,
+                        },
+                });
+            }
+        }
+
+        // Release barriers.
+        if (!barriers.empty()) {
+            encoder.buffer_barrier(barriers);
+        }
+
+        encoder.end_command_buffer();
+
+        SubmitInfo submit_info;
+        submit_info.encoders.push_back(core::move(encoder));
+        submit_info.synchronization_stage = SynchronizationStage::TRANSFER;
+        submit_info.queue_type = QueueType::Transfer;
+        submit_infos.push_back(core::move(submit_info));
+
+        m_last_ticket += 1;
+        m_batches.push_back(Batch {
+            .ticket = m_last_ticket,
+            .submit = num_submits + 1,
+            .staging_end = m_staging_head,
+            .acquire_barriers = core::move(barriers),
+            .dedicated_buffers = core::exchange(m_pending_dedicated_buffers, {}),
+        });
+        m_pending_uploads.clear();
+    }
+
+    if (!acquire_barriers.empty()) {
+        CommandEncoder encoder;
+        encoder.begin_command_buffer();
+        encoder.buffer_barrier(core::move(acquire_barriers));
+        encoder.end_command_buffer();
+
+        // Copies have finished, so the acquire does not wait for the transfer queue.
+        SubmitInfo submit_info;
+        submit_info.encoders.push_back(core::move(encoder));
+        submit_info.synchronization_stage = SynchronizationStage::ALL_COMMANDS;
+        submit_info.queue_type = QueueType::Graphics;
+        submit_infos.push_back(core::move(submit_info));
+    }
+
+    return submit_infos;
+}
+
+bool UploadService::is_complete(const UploadTicket ticket) const noexcept
+{
+    return ticket <= m_last_completed_ticket;
+}
+
+core::Option<u64> UploadService::allocate_staging(const u64 size) noexcept
+{
+    const u64 capacity = m_staging_memory.size();
+    const u64 aligned_size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (aligned_size > capacity) {
+        return std::nullopt;
+    }
+
+    // An upload does not wrap around the end of the ring.
+    u64 offset = m_staging_head;
+    const u64 position = offset % capacity;
+    if ((position + aligned_size) > capacity) {
+        offset += capacity - position;
+    }
+
+    if ((offset + aligned_size - m_staging_tail) > capacity) {
+        return std::nullopt;
+    }
+
+    m_staging_head = offset + aligned_size;
+    return offset % capacity;
+}
+
+} // namespace tundra::rhi
@@ -3,6 +3,7 @@
 #include "rhi/commands/command_encoder.h"
 #include "rhi/commands/dispatch_indirect.h"
 #include "rhi/commands/draw_indirect.h"
+#include "rhi/config.h"
 #include "rhi/resources/buffer.h"
 #include "rhi/resources/texture.h"
 #include "rhi/validation_layers.h"
@@ -15,6 +16,9 @@ class CommandEncoderValidator {
 private:
     ValidationLayers* m_validation_layers;
     const CommandEncoder& m_command_encoder;
+    /// Commands of recorded bundles are decoded once, so they can't use per-frame
+    /// objects (events and queries).
+    bool m_is_recorded_bundle;
 
 private:
     struct {
@@ -25,11 +29,14 @@ private:
         bool is_viewport_defined = false;
         bool is_graphics_pipeline_binded = false;
         bool is_index_buffer_binded = false;
+        core::Option<u32> active_pipeline_statistics_query;
     } m_encoder_state;
 
 public:
     CommandEncoderValidator(
-        ValidationLayers* validation_layers, const CommandEncoder& encoder) noexcept;
+        ValidationLayers* validation_layers,
+        const CommandEncoder& encoder,
+        const bool is_recorded_bundle) noexcept;
 
 public:
     void validate() noexcept;
@@ -66,8 +73,20 @@ private:
     void global_barrier(const rhi::commands::GlobalBarrierCommand& cmd) noexcept;
     void texture_barrier(const rhi::commands::TextureBarrierCommand& cmd) noexcept;
     void buffer_barrier(const rhi::commands::BufferBarrierCommand& cmd) noexcept;
+    void set_event(const rhi::commands::SetEventCommand& cmd) noexcept;
+    void wait_event(const rhi::commands::WaitEventCommand& cmd) noexcept;
+    void write_timestamp(const rhi::commands::WriteTimestampCommand& cmd) noexcept;
+    void begin_pipeline_statistics(
+        const rhi::commands::BeginPipelineStatisticsCommand& cmd) noexcept;
+    void end_pipeline_statistics(
+        const rhi::commands::EndPipelineStatisticsCommand& cmd) noexcept;
+    void execute_recorded_bundle(
+        const rhi::commands::ExecuteRecordedBundleCommand& cmd) noexcept;
 
 private:
+    void validate_split_barrier(const SplitBarrier& barrier) noexcept;
+    void validate_texture_barriers(const core::Array<TextureBarrier>& barriers) noexcept;
+    void validate_buffer_barriers(const core::Array<BufferBarrier>& barriers) noexcept;
     [[nodiscard]] bool validate_access_flags(
         const rhi::BufferAccessFlags access_flags,
         const rhi::BufferUsageFlags buffer_usage) noexcept;
@@ -77,9 +96,12 @@ private:
 };
 
 CommandEncoderValidator::CommandEncoderValidator(
-    ValidationLayers* validation_layers, const CommandEncoder& command_encoder) noexcept
+    ValidationLayers* validation_layers,
+    const CommandEncoder& command_encoder,
+    const bool is_recorded_bundle) noexcept
     : m_validation_layers(validation_layers)
     , m_command_encoder(command_encoder)
+    , m_is_recorded_bundle(is_recorded_bundle)
 {
 }
 
@@ -163,6 +185,24 @@ void CommandEncoderValidator::validate() noexcept
         },
         [&](const rhi::commands::BufferBarrierCommand& cmd) {
             this->buffer_barrier(cmd);
+        },
+        [&](const rhi::commands::SetEventCommand& cmd) { //
+            this->set_event(cmd);
+        },
+        [&](const rhi::commands::WaitEventCommand& cmd) { //
+            this->wait_event(cmd);
+        },
+        [&](const rhi::commands::WriteTimestampCommand& cmd) {
+            this->write_timestamp(cmd);
+        },
+        [&](const rhi::commands::BeginPipelineStatisticsCommand& cmd) {
+            this->begin_pipeline_statistics(cmd);
+        },
+        [&](const rhi::commands::EndPipelineStatisticsCommand& cmd) {
+            this->end_pipeline_statistics(cmd);
+        },
+        [&](const rhi::commands::ExecuteRecordedBundleCommand& cmd) {
+            this->execute_recorded_bundle(cmd);
         }));
 }
 
@@ -181,6 +221,9 @@ void CommandEncoderValidator::end_command_buffer(
     tndr_assert(
         m_encoder_state.is_in_recording_state,
         "`begin_command_buffer`/`end_command_buffer` mismatch.");
+    tndr_assert(
+        !m_encoder_state.active_pipeline_statistics_query.has_value(),
+        "`begin_pipeline_statistics`/`end_pipeline_statistics` mismatch.");
     m_encoder_state.is_in_recording_state = false;
 }
 
@@ -907,8 +950,151 @@ void CommandEncoderValidator::texture_barrier(
         !m_encoder_state.is_in_render_pass,
         "`texture_barrier` must be called outside of a render pass.");
 
+    this->validate_texture_barriers(cmd.barriers);
+}
+
+void CommandEncoderValidator::buffer_barrier(
+    const rhi::commands::BufferBarrierCommand& cmd) noexcept
+{
+    tndr_assert(
+        m_encoder_state.is_in_recording_state,
+        "Command encoder is not in the recording state.");
+    tndr_assert(
+        !m_encoder_state.is_in_render_pass,
+        "`buffer_barrier` must be called outside of a render pass.");
+
+    this->validate_buffer_barriers(cmd.barriers);
+}
+
+void CommandEncoderValidator::set_event(
+    const rhi::commands::SetEventCommand& cmd) noexcept
+{
+    tndr_assert(
+        m_encoder_state.is_in_recording_state,
+        "Command encoder is not in the recording state.");
+    tndr_assert(
+        !m_encoder_state.is_in_render_pass,
+        "`set_event` must be called outside of a render pass.");
+    tndr_assert(!m_is_recorded_bundle, "Recorded bundles can't use events.");
+
+    this->validate_split_barrier(cmd.barrier);
+}
+
+void CommandEncoderValidator::wait_event(
+    const rhi::commands::WaitEventCommand& cmd) noexcept
+{
+    tndr_assert(
+        m_encoder_state.is_in_recording_state,
+        "Command encoder is not in the recording state.");
+    tndr_assert(
+        !m_encoder_state.is_in_render_pass,
+        "`wait_event` must be called outside of a render pass.");
+    tndr_assert(!m_is_recorded_bundle, "Recorded bundles can't use events.");
+
+    this->validate_split_barrier(cmd.barrier);
+}
+
+void CommandEncoderValidator::write_timestamp(
+    const rhi::commands::WriteTimestampCommand& cmd) noexcept
+{
+    tndr_assert(
+        m_encoder_state.is_in_recording_state,
+        "Command encoder is not in the recording state.");
+    tndr_assert(
+        cmd.query < config::MAX_TIMESTAMP_QUERIES,
+        "`query` must be lower than `config::MAX_TIMESTAMP_QUERIES`.");
+    tndr_assert(!m_is_recorded_bundle, "Recorded bundles can't use queries.");
+}
+
+void CommandEncoderValidator::begin_pipeline_statistics(
+    const rhi::commands::BeginPipelineStatisticsCommand& cmd) noexcept
+{
+    tndr_assert(
+        m_encoder_state.is_in_recording_state,
+        "Command encoder is not in the recording state.");
+    tndr_assert(
+        !m_encoder_state.is_in_render_pass,
+        "`begin_pipeline_statistics` must be called outside of a render pass.");
+    tndr_assert(
+        cmd.query < config::MAX_PIPELINE_STATISTICS_QUERIES,
+        "`query` must be lower than `config::MAX_PIPELINE_STATISTICS_QUERIES`.");
+    tndr_assert(
+        !m_encoder_state.active_pipeline_statistics_query.has_value(),
+        "Pipeline statistics queries can't be nested.");
+    tndr_assert(!m_is_recorded_bundle, "Recorded bundles can't use queries.");
+
+    m_encoder_state.active_pipeline_statistics_query = cmd.query;
+}
+
+void CommandEncoderValidator::end_pipeline_statistics(
+    const rhi::commands::EndPipelineStatisticsCommand& cmd) noexcept
+{
+    tndr_assert(
+        m_encoder_state.is_in_recording_state,
+        "Command encoder is not in the recording state.");
+    tndr_assert(
+        !m_encoder_state.is_in_render_pass,
+        "`end_pipeline_statistics` must be called outside of a render pass.");
+    tndr_assert(
+        m_encoder_state.active_pipeline_statistics_query == cmd.query,
+        "`begin_pipeline_statistics`/`end_pipeline_statistics` mismatch.");
+
+    m_encoder_state.active_pipeline_statistics_query = std::nullopt;
+}
+
+void CommandEncoderValidator::execute_recorded_bundle(
+    const rhi::commands::ExecuteRecordedBundleCommand& cmd) noexcept
+{
+    tndr_assert(
+        m_encoder_state.is_in_recording_state,
+        "Command encoder is not in the recording state.");
+    tndr_assert(
+        !m_encoder_state.is_in_render_pass,
+        "`execute_recorded_bundle` must be called outside of a render pass.");
+    tndr_assert(!m_is_recorded_bundle, "Recorded bundles can't be nested.");
+    tndr_assert(
+        !m_encoder_state.active_pipeline_statistics_query.has_value(),
+        "`execute_recorded_bundle` can't be called inside a pipeline statistics query.");
+    tndr_assert(cmd.bundle.is_valid(), "`bundle` must be a valid handle.");
+
+    const auto recorded_bundles = m_validation_layers->get_recorded_bundles().read();
+    tndr_assert(
+        recorded_bundles->contains(cmd.bundle.get_handle()),
+        "`ExecuteRecordedBundleCommand::bundle` does not exist.");
+
+    // The bundle leaves the graphics state undefined.
+    m_encoder_state.is_scissor_defined = false;
+    m_encoder_state.is_culling_mode_defined = false;
+    m_encoder_state.is_viewport_defined = false;
+    m_encoder_state.is_graphics_pipeline_binded = false;
+    m_encoder_state.is_index_buffer_binded = false;
+}
+
+void CommandEncoderValidator::validate_split_barrier(const SplitBarrier& barrier) noexcept
+{
+    for (const TextureBarrier& texture_barrier : barrier.texture_barriers) {
+        tndr_assert(
+            !texture_barrier.source_queue.has_value() &&
+                !texture_barrier.destination_queue.has_value(),
+            "Split barriers can't transfer queue ownership.");
+    }
+
+    for (const BufferBarrier& buffer_barrier : barrier.buffer_barriers) {
+        tndr_assert(
+            !buffer_barrier.source_queue.has_value() &&
+                !buffer_barrier.destination_queue.has_value(),
+            "Split barriers can't transfer queue ownership.");
+    }
+
+    this->validate_texture_barriers(barrier.texture_barriers);
+    this->validate_buffer_barriers(barrier.buffer_barriers);
+}
+
+void CommandEncoderValidator::validate_texture_barriers(
+    const core::Array<TextureBarrier>& barriers) noexcept
+{
     auto textures = m_validation_layers->get_textures().read();
-    for (const TextureBarrier& barrier : cmd.barriers) {
+    for (const TextureBarrier& barrier : barriers) {
         tndr_assert(
             barrier.source_queue.has_value() == barrier.destination_queue.has_value(),
             "Both `source_queue` and `destination_queue` must be `Some` or `None`.");
@@ -959,19 +1145,12 @@ void CommandEncoderValidator::texture_barrier(
     }
 }
 
-void CommandEncoderValidator::buffer_barrier(
-    const rhi::commands::BufferBarrierCommand& cmd) noexcept
+void CommandEncoderValidator::validate_buffer_barriers(
+    const core::Array<BufferBarrier>& barriers) noexcept
 {
-    tndr_assert(
-        m_encoder_state.is_in_recording_state,
-        "Command encoder is not in the recording state.");
-    tndr_assert(
-        !m_encoder_state.is_in_render_pass,
-        "`buffer_barrier` must be called outside of a render pass.");
-
     const auto buffers = m_validation_layers->get_buffers().read();
 
-    for (const BufferBarrier& barrier : cmd.barriers) {
+    for (const BufferBarrier& barrier : barriers) {
         tndr_assert(
             barrier.source_queue.has_value() == barrier.destination_queue.has_value(),
             "Both `source_queue` and `destination_queue` must be `Some` or `None`.");
@@ -1125,7 +1304,14 @@ bool CommandEncoderValidator::validate_access_flags(
 void validate_command_encoder(
     ValidationLayers* validation_layers, const CommandEncoder& encoder) noexcept
 {
-    CommandEncoderValidator validator(validation_layers, encoder);
+    CommandEncoderValidator validator(validation_layers, encoder, false);
+    validator.validate();
+}
+
+void validate_recorded_bundle(
+    ValidationLayers* validation_layers, const CommandEncoder& encoder) noexcept
+{
+    CommandEncoderValidator validator(validation_layers, encoder, true);
     validator.validate();
 }
 
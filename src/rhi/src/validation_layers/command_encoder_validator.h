@@ -9,4 +9,8 @@ class ValidationLayers;
 void validate_command_encoder(
     ValidationLayers* validation_layers, const CommandEncoder& encoder) noexcept;
 
+/// Validates commands of a recorded bundle, see `IRHIContext::create_recorded_bundle`.
+void validate_recorded_bundle(
+    ValidationLayers* validation_layers, const CommandEncoder& encoder) noexcept;
+
 } // namespace tundra::rhi
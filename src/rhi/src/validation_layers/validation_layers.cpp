@@ -33,6 +33,42 @@ void ValidationLayers::submit(
     return m_context->submit(core::move(submit_infos), core::move(present_infos));
 }
 
+SubmitStatistics ValidationLayers::get_submit_statistics() const noexcept
+{
+    return m_context->get_submit_statistics();
+}
+
+u64 ValidationLayers::get_num_submits() const noexcept
+{
+    return m_context->get_num_submits();
+}
+
+u64 ValidationLayers::get_num_completed_submits() const noexcept
+{
+    return m_context->get_num_completed_submits();
+}
+
+void ValidationLayers::set_thread_pool(core::ThreadPool* thread_pool) noexcept
+{
+    m_context->set_thread_pool(thread_pool);
+}
+
+void ValidationLayers::set_async_submit(const bool is_enabled) noexcept
+{
+    m_context->set_async_submit(is_enabled);
+}
+
+core::Array<core::Option<u64>> ValidationLayers::get_timestamps() const noexcept
+{
+    return m_context->get_timestamps();
+}
+
+core::Array<core::Option<PipelineStatistics>> ValidationLayers::get_pipeline_statistics()
+    const noexcept
+{
+    return m_context->get_pipeline_statistics();
+}
+
 const char* ValidationLayers::get_name() const noexcept
 {
     return m_context->get_name();
@@ -79,6 +115,31 @@ void ValidationLayers::update_buffer(
     m_context->update_buffer(handle, update_regions);
 }
 
+core::Array<char> ValidationLayers::read_buffer(
+    const BufferHandle handle, const BufferSubresourceRange& range) noexcept
+{
+    tndr_assert(handle.is_valid(), "`handle` must be a valid handle!");
+
+    return m_context->read_buffer(handle, range);
+}
+
+core::Span<char> ValidationLayers::map_buffer(const BufferHandle handle) noexcept
+{
+    tndr_assert(handle.is_valid(), "`handle` must be a valid handle!");
+
+    {
+        const auto buffers = m_buffers.read();
+        const auto it = buffers->find(handle.get_handle());
+        tndr_assert(it != buffers->end(), "Buffer does not exist!");
+        tndr_assert(
+            (it->second.memory_type == MemoryType::Upload) ||
+                (it->second.memory_type == MemoryType::Dynamic),
+            "Only `Upload` and `Dynamic` buffers can be mapped!");
+    }
+
+    return m_context->map_buffer(handle);
+}
+
 void ValidationLayers::destroy_buffer(const BufferHandle handle) noexcept
 {
     tndr_assert(handle.is_valid(), "`handle` must be a valid handle!");
@@ -242,4 +303,33 @@ void ValidationLayers::destroy_sampler(const SamplerHandle handle) noexcept
     m_context->destroy_sampler(handle);
 }
 
+RecordedBundleHandle ValidationLayers::create_recorded_bundle(
+    const RecordedBundleCreateInfo& create_info) noexcept
+{
+    tndr_assert(
+        create_info.queue_type != QueueType::Present,
+        "Recorded bundles can't be executed on `QueueType::Present`.");
+    validate_recorded_bundle(this, create_info.encoder);
+
+    const RecordedBundleHandle handle = m_context->create_recorded_bundle(create_info);
+
+    auto recorded_bundles = m_recorded_bundles.write();
+    tndr_assert(!recorded_bundles->contains(handle.get_handle()), "");
+    recorded_bundles->insert({ handle.get_handle(), create_info.queue_type });
+
+    return handle;
+}
+
+void ValidationLayers::destroy_recorded_bundle(const RecordedBundleHandle handle) noexcept
+{
+    tndr_assert(handle.is_valid(), "`handle` must be a valid handle!");
+
+    auto recorded_bundles = m_recorded_bundles.write();
+    const auto it = recorded_bundles->find(handle.get_handle());
+    tndr_assert(it != recorded_bundles->end(), "");
+    recorded_bundles->erase(it);
+
+    m_context->destroy_recorded_bundle(handle);
+}
+
 } // namespace tundra::rhi
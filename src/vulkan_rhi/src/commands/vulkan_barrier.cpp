@@ -8,6 +8,7 @@
 #include "vulkan/vulkan_core.h"
 #include "vulkan_device.h"
 #include "vulkan_helpers.h"
+#include <algorithm>
 
 namespace tundra::vulkan_rhi {
 
@@ -184,6 +185,18 @@ void VulkanBarrier::global_barrier(const rhi::GlobalBarrier& barrier) noexcept
     tndr_assert(src_stage_mask != VK_PIPELINE_STAGE_2_NONE, "Invalid stage mask");
     tndr_assert(dst_stage_mask != VK_PIPELINE_STAGE_2_NONE, "Invalid stage mask");
 
+    m_num_recorded_barriers += 1;
+
+    // Global barriers apply to all resources, so one is enough.
+    if (!m_memory_barriers.empty()) {
+        VkMemoryBarrier2& memory_barrier = m_memory_barriers.front();
+        memory_barrier.srcStageMask |= src_stage_mask;
+        memory_barrier.srcAccessMask |= src_access_mask;
+        memory_barrier.dstStageMask |= dst_stage_mask;
+        memory_barrier.dstAccessMask |= dst_access_mask;
+        return;
+    }
+
     VkMemoryBarrier2 memory_barrier {
         .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
         .srcStageMask = src_stage_mask,
@@ -194,7 +207,7 @@ void VulkanBarrier::global_barrier(const rhi::GlobalBarrier& barrier) noexcept
     m_memory_barriers.push_back(core::move(memory_barrier));
 }
 
-void VulkanBarrier::texture_barrier(
+bool VulkanBarrier::texture_barrier(
     const VulkanTexture& texture, const rhi::TextureBarrier& barrier) noexcept
 {
     const auto [src_access_mask, src_stage_mask, old_layout] //
@@ -247,10 +260,44 @@ void VulkanBarrier::texture_barrier(
             },
     };
 
-    m_image_barriers.push_back(core::move(image_barrier));
+    const auto it = std::find_if(
+        m_image_barriers.begin(), m_image_barriers.end(), [&](const auto& b) {
+            return b.image == image_barrier.image;
+        });
+
+    if (it != m_image_barriers.end()) {
+        // Transitions of the same image in one pipeline barrier are not ordered,
+        // so they can only be merged into one transition.
+        const VkImageSubresourceRange& lhs = it->subresourceRange;
+        const VkImageSubresourceRange& rhs = image_barrier.subresourceRange;
+        const bool is_same_range = (lhs.aspectMask == rhs.aspectMask) &&
+                                   (lhs.baseMipLevel == rhs.baseMipLevel) &&
+                                   (lhs.levelCount == rhs.levelCount) &&
+                                   (lhs.baseArrayLayer == rhs.baseArrayLayer) &&
+                                   (lhs.layerCount == rhs.layerCount);
+        const bool is_same_queue = (it->srcQueueFamilyIndex == src_queue_family_index) &&
+                                   (it->dstQueueFamilyIndex == dst_queue_family_index);
+        const bool continues_transition = (it->newLayout == old_layout) ||
+                                          (old_layout == VK_IMAGE_LAYOUT_UNDEFINED);
+
+        if (!is_same_range || !is_same_queue || !continues_transition) {
+            return false;
+        }
+
+        it->srcStageMask |= src_stage_mask;
+        it->srcAccessMask |= src_access_mask;
+        it->dstStageMask |= dst_stage_mask;
+        it->dstAccessMask |= dst_access_mask;
+        it->newLayout = new_layout;
+    } else {
+        m_image_barriers.push_back(core::move(image_barrier));
+    }
+
+    m_num_recorded_barriers += 1;
+    return true;
 }
 
-void VulkanBarrier::buffer_barrier(
+bool VulkanBarrier::buffer_barrier(
     const VulkanBuffer& buffer, const rhi::BufferBarrier& barrier) noexcept
 {
     const auto [src_access_mask, src_stage_mask] //
@@ -275,32 +322,135 @@ void VulkanBarrier::buffer_barrier(
         .offset = barrier.subresource_range.offset,
         .size = barrier.subresource_range.size,
     };
-    m_buffer_barriers.push_back(core::move(buffer_barrier));
+
+    const auto it = std::find_if(
+        m_buffer_barriers.begin(), m_buffer_barriers.end(), [&](const auto& b) {
+            return b.buffer == buffer_barrier.buffer;
+        });
+
+    if (it != m_buffer_barriers.end()) {
+        const bool is_same_range = (it->offset == buffer_barrier.offset) &&
+                                   (it->size == buffer_barrier.size);
+        const bool is_same_queue = (it->srcQueueFamilyIndex == src_queue_family_index) &&
+                                   (it->dstQueueFamilyIndex == dst_queue_family_index);
+
+        if (!is_same_range || !is_same_queue) {
+            return false;
+        }
+
+        it->srcStageMask |= src_stage_mask;
+        it->srcAccessMask |= src_access_mask;
+        it->dstStageMask |= dst_stage_mask;
+        it->dstAccessMask |= dst_access_mask;
+    } else {
+        m_buffer_barriers.push_back(core::move(buffer_barrier));
+    }
+
+    m_num_recorded_barriers += 1;
+    return true;
+}
+
+void VulkanBarrier::merge_scopes() noexcept
+{
+    VkPipelineStageFlags2 src_stage_mask = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 src_access_mask = VK_ACCESS_2_NONE;
+    VkPipelineStageFlags2 dst_stage_mask = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 dst_access_mask = VK_ACCESS_2_NONE;
+
+    const auto gather = [&](const auto& barriers) {
+        for (const auto& barrier : barriers) {
+            src_stage_mask |= barrier.srcStageMask;
+            src_access_mask |= barrier.srcAccessMask;
+            dst_stage_mask |= barrier.dstStageMask;
+            dst_access_mask |= barrier.dstAccessMask;
+        }
+    };
+
+    const auto extend = [&](auto& barriers) {
+        for (auto& barrier : barriers) {
+            barrier.srcStageMask |= src_stage_mask;
+            barrier.srcAccessMask |= src_access_mask;
+            barrier.dstStageMask |= dst_stage_mask;
+            barrier.dstAccessMask |= dst_access_mask;
+        }
+    };
+
+    // Barriers executed one after another form a dependency chain. Barriers in one
+    // pipeline barrier do not, so every barrier has to cover the whole chain.
+    gather(m_memory_barriers);
+    gather(m_image_barriers);
+    gather(m_buffer_barriers);
+    extend(m_memory_barriers);
+    extend(m_image_barriers);
+    extend(m_buffer_barriers);
+
+    if (!m_memory_barriers.empty()) {
+        core::erase_if(m_buffer_barriers, [](const VkBufferMemoryBarrier2& barrier) {
+            return barrier.srcQueueFamilyIndex == barrier.dstQueueFamilyIndex;
+        });
+        core::erase_if(m_image_barriers, [](const VkImageMemoryBarrier2& barrier) {
+            return (barrier.srcQueueFamilyIndex == barrier.dstQueueFamilyIndex) &&
+                   (barrier.oldLayout == barrier.newLayout);
+        });
+    }
+}
+
+u32 VulkanBarrier::get_num_recorded_barriers() const noexcept
+{
+    return m_num_recorded_barriers;
+}
+
+u32 VulkanBarrier::get_num_barriers() const noexcept
+{
+    return static_cast<u32>(
+        m_memory_barriers.size() + m_image_barriers.size() + m_buffer_barriers.size());
 }
 
 void VulkanBarrier::execute(const VkCommandBuffer command_buffer) const noexcept
 {
     if (!m_memory_barriers.empty() || !m_buffer_barriers.empty() ||
         !m_image_barriers.empty()) {
-        const VkDependencyInfo dependency_info {
-            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            .memoryBarrierCount = static_cast<u32>(m_memory_barriers.size()),
-            .pMemoryBarriers = m_memory_barriers.data(),
-            .bufferMemoryBarrierCount = static_cast<u32>(m_buffer_barriers.size()),
-            .pBufferMemoryBarriers = m_buffer_barriers.data(),
-            .imageMemoryBarrierCount = static_cast<u32>(m_image_barriers.size()),
-            .pImageMemoryBarriers = m_image_barriers.data(),
-        };
+        const VkDependencyInfo dependency_info = this->get_dependency_info();
         m_raw_device->get_device().cmd_pipeline_barrier2(
             command_buffer, &dependency_info);
     }
 }
 
+void VulkanBarrier::set_event(
+    const VkCommandBuffer command_buffer, const VkEvent event) const noexcept
+{
+    // The event is signaled even without barriers, so the wait never blocks forever.
+    const VkDependencyInfo dependency_info = this->get_dependency_info();
+    m_raw_device->get_device().cmd_set_event2(command_buffer, event, &dependency_info);
+}
+
+void VulkanBarrier::wait_event(
+    const VkCommandBuffer command_buffer, const VkEvent event) const noexcept
+{
+    const VkDependencyInfo dependency_info = this->get_dependency_info();
+    m_raw_device->get_device().cmd_wait_events2(
+        command_buffer, core::as_span(event), &dependency_info);
+}
+
+VkDependencyInfo VulkanBarrier::get_dependency_info() const noexcept
+{
+    return VkDependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .memoryBarrierCount = static_cast<u32>(m_memory_barriers.size()),
+        .pMemoryBarriers = m_memory_barriers.data(),
+        .bufferMemoryBarrierCount = static_cast<u32>(m_buffer_barriers.size()),
+        .pBufferMemoryBarriers = m_buffer_barriers.data(),
+        .imageMemoryBarrierCount = static_cast<u32>(m_image_barriers.size()),
+        .pImageMemoryBarriers = m_image_barriers.data(),
+    };
+}
+
 void VulkanBarrier::reset() noexcept
 {
     m_buffer_barriers.clear();
     m_image_barriers.clear();
     m_memory_barriers.clear();
+    m_num_recorded_barriers = 0;
 }
 
 } // namespace tundra::vulkan_rhi
@@ -11,7 +11,10 @@ class VulkanBuffer;
 class VulkanRawDevice;
 class VulkanTexture;
 
+/// Collects barriers executed by a single pipeline barrier command.
 ///
+/// Global barriers are merged into one memory barrier. Barriers of the same
+/// buffer or texture region are merged into one barrier.
 class VulkanBarrier {
 private:
     core::SharedPtr<VulkanRawDevice> m_raw_device;
@@ -21,6 +24,8 @@ private:
     core::Array<VkBufferMemoryBarrier2> m_buffer_barriers;
     core::Array<VkImageMemoryBarrier2> m_image_barriers;
     core::Array<VkMemoryBarrier2> m_memory_barriers;
+    /// Number of barriers recorded since the last `reset`, including merged ones.
+    u32 m_num_recorded_barriers = 0;
 
 public:
     explicit VulkanBarrier(const core::SharedPtr<VulkanRawDevice>& raw_device) noexcept;
@@ -33,14 +38,43 @@ public:
         const VkImageSubresourceRange& subresource_range) noexcept;
 
     void global_barrier(const rhi::GlobalBarrier& barrier) noexcept;
-    void texture_barrier(
+
+    /// Returns `false`, and records nothing, when the barrier can not be merged with
+    /// an already recorded barrier of the same texture.
+    /// Recorded barriers must be executed first.
+    [[nodiscard]] bool texture_barrier(
         const VulkanTexture& texture, const rhi::TextureBarrier& barrier) noexcept;
-    void buffer_barrier(
+
+    /// Returns `false`, and records nothing, when the barrier can not be merged with
+    /// an already recorded barrier of the same buffer.
+    /// Recorded barriers must be executed first.
+    [[nodiscard]] bool buffer_barrier(
         const VulkanBuffer& buffer, const rhi::BufferBarrier& barrier) noexcept;
 
+    /// Makes recorded barriers behave as if they were executed one after another,
+    /// by extending every barrier to the scopes of all barriers.
+    /// Buffer and texture barriers that are then covered by a global barrier,
+    /// and do not change layouts nor queue ownership, are removed.
+    ///
+    /// Must be called before `execute` when barriers come from different commands.
+    void merge_scopes() noexcept;
+
+    /// Number of barriers recorded since the last `reset`, including merged ones.
+    [[nodiscard]] u32 get_num_recorded_barriers() const noexcept;
+    /// Number of barriers that will be executed.
+    [[nodiscard]] u32 get_num_barriers() const noexcept;
+
 public:
     void execute(const VkCommandBuffer command_buffer) const noexcept;
+    /// Signals `event` with recorded barriers, instead of executing them.
+    void set_event(const VkCommandBuffer command_buffer, const VkEvent event) const noexcept;
+    /// Waits for `event`. Recorded barriers must be the same as in `set_event`.
+    void wait_event(
+        const VkCommandBuffer command_buffer, const VkEvent event) const noexcept;
     void reset() noexcept;
+
+private:
+    [[nodiscard]] VkDependencyInfo get_dependency_info() const noexcept;
 };
 
 } // namespace tundra::vulkan_rhi
@@ -3,29 +3,43 @@
 #include "core/std/option.h"
 #include "managers/vulkan_descriptor_bindless_manager.h"
 #include "managers/vulkan_pipeline_layout_manager.h"
+#include "managers/vulkan_query_manager.h"
 #include "resources/vulkan_buffer.h"
 #include "resources/vulkan_compute_pipeline.h"
 #include "resources/vulkan_graphics_pipeline.h"
+#include "resources/vulkan_recorded_bundle.h"
 #include "resources/vulkan_texture.h"
 #include "resources/vulkan_texture_view.h"
 #include "rhi/commands/command_encoder.h"
 #include "vulkan_device.h"
 #include "vulkan_helpers.h"
 #include "vulkan_instance.h"
+#include <type_traits>
 
 static constexpr bool PROFILE_DECODER = true;
 
+/// Commands that do not end a batch of barriers.
+/// Debug regions do not execute anything, so barriers are batched across them.
+template <typename Command>
+static constexpr bool is_batched_command =
+    std::is_same_v<Command, tundra::rhi::commands::GlobalBarrierCommand> ||
+    std::is_same_v<Command, tundra::rhi::commands::TextureBarrierCommand> ||
+    std::is_same_v<Command, tundra::rhi::commands::BufferBarrierCommand> ||
+    std::is_same_v<Command, tundra::rhi::commands::BeginRegionCommand> ||
+    std::is_same_v<Command, tundra::rhi::commands::EndRegionCommand>;
+
 namespace tundra::vulkan_rhi {
 
 VulkanCommandDecoder::VulkanCommandDecoder(
     const core::SharedPtr<VulkanRawDevice>& raw_device,
-    Managers& managers,
-    VulkanCommandBufferManager::CommandBundle bundle) noexcept
+    const Managers& managers,
+    VulkanCommandBufferManager::CommandBundle bundle,
+    core::HashSet<u64>* used_resources) noexcept
     : m_raw_device(raw_device)
     , m_loader_device(m_raw_device->get_device())
     , m_bundle(core::move(bundle))
-    , m_resources(m_bundle.get_resources())
     , m_managers(managers)
+    , m_used_resources(used_resources)
     , m_barrier(m_raw_device)
     , m_device_limits(m_raw_device->get_device_limits())
     , m_supports_mesh_shaders(raw_device->supported_features().mesh_shaders)
@@ -39,7 +53,7 @@ VulkanCommandDecoder::VulkanCommandDecoder(
 {
     TNDR_PROFILER_TRACE("VulkanCommandDecoder::decode");
 
-    encoder.execute(core::make_overload(
+    const auto decode_command = core::make_overload(
         [&](const rhi::commands::BeginCommandBufferCommand& cmd) {
             this->begin_command_buffer(cmd);
         },
@@ -121,19 +135,58 @@ VulkanCommandDecoder::VulkanCommandDecoder(
         },
         [&](const rhi::commands::BufferBarrierCommand& cmd) {
             this->buffer_barrier(cmd);
-        }));
+        },
+        [&](const rhi::commands::SetEventCommand& cmd) { //
+            this->set_event(cmd);
+        },
+        [&](const rhi::commands::WaitEventCommand& cmd) { //
+            this->wait_event(cmd);
+        },
+        [&](const rhi::commands::WriteTimestampCommand& cmd) {
+            this->write_timestamp(cmd);
+        },
+        [&](const rhi::commands::BeginPipelineStatisticsCommand& cmd) {
+            this->begin_pipeline_statistics(cmd);
+        },
+        [&](const rhi::commands::EndPipelineStatisticsCommand& cmd) {
+            this->end_pipeline_statistics(cmd);
+        },
+        [&](const rhi::commands::ExecuteRecordedBundleCommand& cmd) {
+            this->execute_recorded_bundle(cmd);
+        });
+
+    encoder.execute([&]<typename Command>(const Command& cmd) {
+        if constexpr (!is_batched_command<Command>) {
+            this->flush_barriers();
+        }
+        decode_command(cmd);
+    });
 
     return m_bundle.command_buffer;
 }
 
+const rhi::SubmitStatistics& VulkanCommandDecoder::get_statistics() const noexcept
+{
+    return m_statistics;
+}
+
 void VulkanCommandDecoder::begin_command_buffer(
     const rhi::commands::BeginCommandBufferCommand&) noexcept
 {
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::begin_command_buffer");
 
+    // Secondary command buffers of recorded bundles begin and end their own render
+    // passes, so they inherit nothing, and are executed by many frames in flight.
+    const VkCommandBufferInheritanceInfo inheritance_info {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+    };
+
     const VkCommandBufferBeginInfo command_buffer_begin_info {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .flags = this->is_recording_bundle()
+                     ? VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT
+                     : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = this->is_recording_bundle() ? &inheritance_info : nullptr,
     };
 
     vulkan_map_result(
@@ -197,8 +250,7 @@ void VulkanCommandDecoder::begin_render_pass(
             core::visit(
                 core::make_overload(
                     [&](rhi::TextureHandleType handle) {
-                        m_resources.add_reference(
-                            *m_managers.resource_tracker, handle.get_id());
+                        this->mark_used(handle);
 
                         return m_managers.texture_manager->with(
                             handle, [&](const VulkanTexture& texture) {
@@ -209,8 +261,7 @@ void VulkanCommandDecoder::begin_render_pass(
                     },
                     [&](rhi::TextureViewHandleType handle)
                         -> core::Expected<VkImageView, rhi::HandleManagerError> {
-                        m_resources.add_reference(
-                            *m_managers.resource_tracker, handle.get_id());
+                        this->mark_used(handle);
 
                         return m_managers.texture_view_manager->with(
                             handle, [&](const VulkanTextureView& texture_view) {
@@ -235,8 +286,7 @@ void VulkanCommandDecoder::begin_render_pass(
                 core::visit(
                     core::make_overload(
                         [&](rhi::TextureHandleType handle) {
-                            m_resources.add_reference(
-                                *m_managers.resource_tracker, handle.get_id());
+                            this->mark_used(handle);
 
                             return m_managers.texture_manager->with(
                                 handle, [&](const VulkanTexture& texture) {
@@ -248,8 +298,7 @@ void VulkanCommandDecoder::begin_render_pass(
                         },
                         [&](rhi::TextureViewHandleType handle)
                             -> core::Expected<VkImageView, rhi::HandleManagerError> {
-                            m_resources.add_reference(
-                                *m_managers.resource_tracker, handle.get_id());
+                            this->mark_used(handle);
 
                             return m_managers.texture_view_manager->with(
                                 handle, [&](const VulkanTextureView& texture_view) {
@@ -295,8 +344,7 @@ void VulkanCommandDecoder::begin_render_pass(
             core::visit(
                 core::make_overload(
                     [&](rhi::TextureHandleType handle) {
-                        m_resources.add_reference(
-                            *m_managers.resource_tracker, handle.get_id());
+                        this->mark_used(handle);
 
                         return m_managers.texture_manager->with(
                             handle, [&](const VulkanTexture& texture) {
@@ -308,8 +356,7 @@ void VulkanCommandDecoder::begin_render_pass(
                     },
                     [&](rhi::TextureViewHandleType handle)
                         -> core::Expected<VkImageView, rhi::HandleManagerError> {
-                        m_resources.add_reference(
-                            *m_managers.resource_tracker, handle.get_id());
+                        this->mark_used(handle);
 
                         return m_managers.texture_view_manager->with(
                             handle, [&](const VulkanTextureView& texture_view) {
@@ -334,8 +381,7 @@ void VulkanCommandDecoder::begin_render_pass(
                 core::visit(
                     core::make_overload(
                         [&](rhi::TextureHandleType handle) {
-                            m_resources.add_reference(
-                                *m_managers.resource_tracker, handle.get_id());
+                            this->mark_used(handle);
 
                             return m_managers.texture_manager->with(
                                 handle, [&](const VulkanTexture& texture) {
@@ -347,8 +393,7 @@ void VulkanCommandDecoder::begin_render_pass(
                         },
                         [&](rhi::TextureViewHandleType handle)
                             -> core::Expected<VkImageView, rhi::HandleManagerError> {
-                            m_resources.add_reference(
-                                *m_managers.resource_tracker, handle.get_id());
+                            this->mark_used(handle);
 
                             return m_managers.texture_view_manager->with(
                                 handle, [&](const VulkanTextureView& texture_view) {
@@ -434,8 +479,7 @@ void VulkanCommandDecoder::push_constants(
 {
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::push_constants");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.ubo_buffer.get_handle().get_id());
+    this->mark_used(cmd.ubo_buffer.get_handle());
 
     const rhi::PushConstants push_constants {
         .buffer_index = cmd.ubo_buffer.get_srv(),
@@ -457,8 +501,7 @@ void VulkanCommandDecoder::bind_graphics_pipeline(
         PROFILE_DECODER, "VulkanCommandDecoder::bind_graphics_pipeline");
 
     if (m_cache.current_graphics_pipeline != cmd.pipeline) {
-        m_resources.add_reference(
-            *m_managers.resource_tracker, cmd.pipeline.get_handle().get_id());
+        this->mark_used(cmd.pipeline.get_handle());
         m_cache.current_graphics_pipeline = cmd.pipeline;
 
         const VkPipeline pipeline =
@@ -529,8 +572,7 @@ void VulkanCommandDecoder::bind_index_buffer(
 
     const auto index_buffer_tie = core::tie(cmd.buffer, cmd.index_type, cmd.offset);
     if (m_cache.current_index_buffer != index_buffer_tie) {
-        m_resources.add_reference(
-            *m_managers.resource_tracker, cmd.buffer.get_handle().get_id());
+        this->mark_used(cmd.buffer.get_handle());
         m_cache.current_index_buffer = index_buffer_tie;
 
         const VkBuffer buffer =
@@ -596,8 +638,7 @@ void VulkanCommandDecoder::draw_indexed_indirect(
     TNDR_PROFILER_TRACE_IF(
         PROFILE_DECODER, "VulkanCommandDecoder::draw_indexed_indirect");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.buffer.get_handle().get_id());
+    this->mark_used(cmd.buffer.get_handle());
 
     const VkBuffer indirect_buffer =
         m_managers.buffer_manager
@@ -618,10 +659,8 @@ void VulkanCommandDecoder::draw_indexed_indirect_count(
     TNDR_PROFILER_TRACE_IF(
         PROFILE_DECODER, "VulkanCommandDecoder::draw_indexed_indirect_count");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.buffer.get_handle().get_id());
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.count_buffer.get_handle().get_id());
+    this->mark_used(cmd.buffer.get_handle());
+    this->mark_used(cmd.count_buffer.get_handle());
 
     const VkBuffer indirect_buffer =
         m_managers.buffer_manager
@@ -658,8 +697,7 @@ void VulkanCommandDecoder::draw_mesh_tasks_indirect(
     TNDR_PROFILER_TRACE_IF(
         PROFILE_DECODER, "VulkanCommandDecoder::draw_mesh_tasks_indirect");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.buffer.get_handle().get_id());
+    this->mark_used(cmd.buffer.get_handle());
 
     const VkBuffer indirect_buffer =
         m_managers.buffer_manager
@@ -693,8 +731,7 @@ void VulkanCommandDecoder::dispatch_indirect(
 {
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::dispatch_indirect");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.buffer.get_handle().get_id());
+    this->mark_used(cmd.buffer.get_handle());
 
     this->bind_compute_pipeline(cmd.pipeline);
 
@@ -716,10 +753,8 @@ void VulkanCommandDecoder::buffer_copy(
 {
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::buffer_copy");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.src.get_handle().get_id());
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.dst.get_handle().get_id());
+    this->mark_used(cmd.src.get_handle());
+    this->mark_used(cmd.dst.get_handle());
 
     const VkBuffer src = m_managers.buffer_manager
                              ->with(
@@ -761,10 +796,8 @@ void VulkanCommandDecoder::texture_copy(
 {
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::texture_copy");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.src.get_handle().get_id());
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.dst.get_handle().get_id());
+    this->mark_used(cmd.src.get_handle());
+    this->mark_used(cmd.dst.get_handle());
 
     const auto [src_image, src_image_aspect_flags] =
         m_managers.texture_manager
@@ -851,8 +884,7 @@ void VulkanCommandDecoder::global_barrier(
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::global_barrier");
 
     m_barrier.global_barrier(cmd.barrier);
-    m_barrier.execute(m_bundle.command_buffer);
-    m_barrier.reset();
+    m_num_pending_barrier_commands += 1;
 }
 
 void VulkanCommandDecoder::texture_barrier(
@@ -861,22 +893,20 @@ void VulkanCommandDecoder::texture_barrier(
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::texture_barrier");
 
     for (const rhi::TextureBarrier& barrier : cmd.barriers) {
-        m_resources.add_reference(
-            *m_managers.resource_tracker, barrier.texture.get_handle().get_id());
+        this->mark_used(barrier.texture.get_handle());
 
         [[maybe_unused]] const bool is_valid //
             = m_managers.texture_manager
                   ->with(
                       barrier.texture.get_handle(),
                       [&](const VulkanTexture& texture) {
-                          m_barrier.texture_barrier(texture, barrier);
+                          this->record_texture_barrier(texture, barrier);
                       })
                   .has_value();
         tndr_assert(is_valid, "`TextureBarrier::texture` is not alive.");
     }
 
-    m_barrier.execute(m_bundle.command_buffer);
-    m_barrier.reset();
+    m_num_pending_barrier_commands += 1;
 }
 
 void VulkanCommandDecoder::buffer_texture_copy(
@@ -884,10 +914,8 @@ void VulkanCommandDecoder::buffer_texture_copy(
 {
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::buffer_texture_copy");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.src.get_handle().get_id());
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.dst.get_handle().get_id());
+    this->mark_used(cmd.src.get_handle());
+    this->mark_used(cmd.dst.get_handle());
 
     const VkBuffer src_buffer =
         m_managers.buffer_manager
@@ -949,10 +977,8 @@ void VulkanCommandDecoder::texture_buffer_copy(
 {
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::texture_buffer_copy");
 
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.src.get_handle().get_id());
-    m_resources.add_reference(
-        *m_managers.resource_tracker, cmd.dst.get_handle().get_id());
+    this->mark_used(cmd.src.get_handle());
+    this->mark_used(cmd.dst.get_handle());
 
     const auto [src_image, src_image_aspect_flags] =
         m_managers.texture_manager
@@ -1015,24 +1041,123 @@ void VulkanCommandDecoder::buffer_barrier(
     TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::buffer_barrier");
 
     for (const rhi::BufferBarrier& barrier : cmd.barriers) {
-        m_resources.add_reference(
-            *m_managers.resource_tracker, barrier.buffer.get_handle().get_id());
+        this->mark_used(barrier.buffer.get_handle());
 
         [[maybe_unused]] const bool is_valid //
             = m_managers.buffer_manager
                   ->with(
                       barrier.buffer.get_handle(),
                       [&](const VulkanBuffer& buffer) {
-                          m_barrier.buffer_barrier(buffer, barrier);
+                          this->record_buffer_barrier(buffer, barrier);
                       })
                   .has_value();
         tndr_assert(is_valid, "`TextureBarrier::texture` is not alive.");
     }
 
-    m_barrier.execute(m_bundle.command_buffer);
+    m_num_pending_barrier_commands += 1;
+}
+
+void VulkanCommandDecoder::set_event(const rhi::commands::SetEventCommand& cmd) noexcept
+{
+    TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::set_event");
+    tndr_assert(!this->is_recording_bundle(), "Recorded bundles can't use events.");
+
+    const VkEvent event = m_managers.command_buffer_manager->get_event(cmd.barrier.event);
+
+    this->record_split_barrier(cmd.barrier);
+    m_barrier.set_event(m_bundle.command_buffer, event);
+    m_barrier.reset();
+}
+
+void VulkanCommandDecoder::wait_event(const rhi::commands::WaitEventCommand& cmd) noexcept
+{
+    TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::wait_event");
+    tndr_assert(!this->is_recording_bundle(), "Recorded bundles can't use events.");
+
+    const VkEvent event = m_managers.command_buffer_manager->get_event(cmd.barrier.event);
+
+    this->record_split_barrier(cmd.barrier);
+    m_barrier.wait_event(m_bundle.command_buffer, event);
     m_barrier.reset();
 }
 
+void VulkanCommandDecoder::write_timestamp(
+    const rhi::commands::WriteTimestampCommand& cmd) noexcept
+{
+    TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::write_timestamp");
+    tndr_assert(!this->is_recording_bundle(), "Recorded bundles can't use queries.");
+
+    const VkQueryPool query_pool = m_managers.query_manager->use_timestamp_query(
+        cmd.query);
+    const VkPipelineStageFlagBits stage = cmd.stage == rhi::TimestampStage::Top
+                                              ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+                                              : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    m_loader_device.cmd_write_timestamp(
+        m_bundle.command_buffer,
+        stage,
+        query_pool,
+        cmd.query);
+}
+
+void VulkanCommandDecoder::begin_pipeline_statistics(
+    const rhi::commands::BeginPipelineStatisticsCommand& cmd) noexcept
+{
+    TNDR_PROFILER_TRACE_IF(
+        PROFILE_DECODER, "VulkanCommandDecoder::begin_pipeline_statistics");
+    tndr_assert(!this->is_recording_bundle(), "Recorded bundles can't use queries.");
+
+    const VkQueryPool query_pool =
+        m_managers.query_manager->use_pipeline_statistics_query(cmd.query);
+    m_loader_device.cmd_begin_query(m_bundle.command_buffer, query_pool, cmd.query, 0);
+}
+
+void VulkanCommandDecoder::end_pipeline_statistics(
+    const rhi::commands::EndPipelineStatisticsCommand& cmd) noexcept
+{
+    TNDR_PROFILER_TRACE_IF(
+        PROFILE_DECODER, "VulkanCommandDecoder::end_pipeline_statistics");
+    tndr_assert(!this->is_recording_bundle(), "Recorded bundles can't use queries.");
+
+    const VkQueryPool query_pool =
+        m_managers.query_manager->use_pipeline_statistics_query(cmd.query);
+    m_loader_device.cmd_end_query(m_bundle.command_buffer, query_pool, cmd.query);
+}
+
+void VulkanCommandDecoder::execute_recorded_bundle(
+    const rhi::commands::ExecuteRecordedBundleCommand& cmd) noexcept
+{
+    TNDR_PROFILER_TRACE_IF(
+        PROFILE_DECODER, "VulkanCommandDecoder::execute_recorded_bundle");
+    tndr_assert(!this->is_recording_bundle(), "Recorded bundles can't be nested.");
+
+    this->mark_used(cmd.bundle.get_handle());
+
+    const VkCommandBuffer command_buffer =
+        m_managers.recorded_bundle_manager
+            ->with(
+                cmd.bundle.get_handle(),
+                [](const VulkanRecordedBundle& bundle) {
+                    return bundle.get_command_buffer();
+                })
+            .value_or_else([](const auto&) -> VkCommandBuffer {
+                core::panic("`ExecuteRecordedBundleCommand::bundle` is not alive.");
+            });
+
+    m_loader_device.cmd_execute_commands(
+        m_bundle.command_buffer, core::as_span(command_buffer));
+
+    // The state of the command buffer is undefined after `vkCmdExecuteCommands`.
+    auto& descriptor_bindless_manager = m_managers.descriptor_bindless_manager;
+    descriptor_bindless_manager->bind_descriptors(
+        m_bundle.command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    descriptor_bindless_manager->bind_descriptors(
+        m_bundle.command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE);
+
+    m_cache.current_graphics_pipeline = {};
+    m_cache.current_compute_pipeline = {};
+    m_cache.current_index_buffer = {};
+}
+
 void VulkanCommandDecoder::bind_compute_pipeline(
     const rhi::ComputePipelineHandle pipeline) noexcept
 {
@@ -1040,8 +1165,7 @@ void VulkanCommandDecoder::bind_compute_pipeline(
         PROFILE_DECODER, "VulkanCommandDecoder::bind_compute_pipeline");
 
     if (m_cache.current_compute_pipeline != pipeline) {
-        m_resources.add_reference(
-            *m_managers.resource_tracker, pipeline.get_handle().get_id());
+        this->mark_used(pipeline.get_handle());
         m_cache.current_compute_pipeline = pipeline;
 
         const VkPipeline vk_pipeline =
@@ -1060,4 +1184,162 @@ void VulkanCommandDecoder::bind_compute_pipeline(
     }
 }
 
+void VulkanCommandDecoder::flush_barriers() noexcept
+{
+    if (m_num_pending_barrier_commands == 0) {
+        return;
+    }
+
+    TNDR_PROFILER_TRACE_IF(PROFILE_DECODER, "VulkanCommandDecoder::flush_barriers");
+
+    if (m_num_pending_barrier_commands > 1) {
+        m_barrier.merge_scopes();
+    }
+
+    const u32 num_recorded_barriers = m_barrier.get_num_recorded_barriers();
+    const u32 num_barriers = m_barrier.get_num_barriers();
+    m_statistics.num_barriers += num_recorded_barriers;
+    m_statistics.num_removed_barriers += num_recorded_barriers - num_barriers;
+
+    if (num_barriers > 0) {
+        m_barrier.execute(m_bundle.command_buffer);
+        m_statistics.num_pipeline_barriers += 1;
+    }
+
+    m_barrier.reset();
+    m_num_pending_barrier_commands = 0;
+}
+
+void VulkanCommandDecoder::record_texture_barrier(
+    const VulkanTexture& texture, const rhi::TextureBarrier& barrier) noexcept
+{
+    if (!m_barrier.texture_barrier(texture, barrier)) {
+        // The rest of the command starts a new batch.
+        this->flush_barriers();
+        m_num_pending_barrier_commands = 1;
+
+        [[maybe_unused]] const bool is_recorded = m_barrier.texture_barrier(
+            texture, barrier);
+        tndr_assert(is_recorded, "A barrier must be recorded into an empty batch.");
+    }
+}
+
+void VulkanCommandDecoder::record_buffer_barrier(
+    const VulkanBuffer& buffer, const rhi::BufferBarrier& barrier) noexcept
+{
+    if (!m_barrier.buffer_barrier(buffer, barrier)) {
+        // The rest of the command starts a new batch.
+        this->flush_barriers();
+        m_num_pending_barrier_commands = 1;
+
+        [[maybe_unused]] const bool is_recorded = m_barrier.buffer_barrier(
+            buffer, barrier);
+        tndr_assert(is_recorded, "A barrier must be recorded into an empty batch.");
+    }
+}
+
+void VulkanCommandDecoder::record_split_barrier(const rhi::SplitBarrier& barrier) noexcept
+{
+    if (barrier.global_barrier.has_value()) {
+        m_barrier.global_barrier(*barrier.global_barrier);
+    }
+
+    for (const rhi::TextureBarrier& texture_barrier : barrier.texture_barriers) {
+        this->mark_used(texture_barrier.texture.get_handle());
+
+        [[maybe_unused]] const bool is_valid //
+            = m_managers.texture_manager
+                  ->with(
+                      texture_barrier.texture.get_handle(),
+                      [&](const VulkanTexture& texture) {
+                          [[maybe_unused]] const bool is_recorded =
+                              m_barrier.texture_barrier(texture, texture_barrier);
+                          tndr_assert(
+                              is_recorded,
+                              "`SplitBarrier::texture_barriers` must not contain a "
+                              "texture twice.");
+                      })
+                  .has_value();
+        tndr_assert(is_valid, "`TextureBarrier::texture` is not alive.");
+    }
+
+    for (const rhi::BufferBarrier& buffer_barrier : barrier.buffer_barriers) {
+        this->mark_used(buffer_barrier.buffer.get_handle());
+
+        [[maybe_unused]] const bool is_valid //
+            = m_managers.buffer_manager
+                  ->with(
+                      buffer_barrier.buffer.get_handle(),
+                      [&](const VulkanBuffer& buffer) {
+                          [[maybe_unused]] const bool is_recorded =
+                              m_barrier.buffer_barrier(buffer, buffer_barrier);
+                          tndr_assert(
+                              is_recorded,
+                              "`SplitBarrier::buffer_barriers` must not contain a "
+                              "buffer twice.");
+                      })
+                  .has_value();
+        tndr_assert(is_valid, "`BufferBarrier::buffer` is not alive.");
+    }
+}
+
+void VulkanCommandDecoder::mark_used(const rhi::BufferHandleType handle) const noexcept
+{
+    if (this->is_recording_bundle()) {
+        m_used_resources->insert(handle.get_id());
+    } else {
+        m_managers.buffer_manager->mark_used(handle, m_bundle.epoch);
+    }
+}
+
+void VulkanCommandDecoder::mark_used(const rhi::TextureHandleType handle) const noexcept
+{
+    if (this->is_recording_bundle()) {
+        m_used_resources->insert(handle.get_id());
+    } else {
+        m_managers.texture_manager->mark_used(handle, m_bundle.epoch);
+    }
+}
+
+void VulkanCommandDecoder::mark_used(
+    const rhi::TextureViewHandleType handle) const noexcept
+{
+    if (this->is_recording_bundle()) {
+        m_used_resources->insert(handle.get_id());
+    } else {
+        m_managers.texture_view_manager->mark_used(handle, m_bundle.epoch);
+    }
+}
+
+void VulkanCommandDecoder::mark_used(
+    const rhi::GraphicsPipelineHandleType handle) const noexcept
+{
+    if (this->is_recording_bundle()) {
+        m_used_resources->insert(handle.get_id());
+    } else {
+        m_managers.graphics_pipeline_manager->mark_used(handle, m_bundle.epoch);
+    }
+}
+
+void VulkanCommandDecoder::mark_used(
+    const rhi::ComputePipelineHandleType handle) const noexcept
+{
+    if (this->is_recording_bundle()) {
+        m_used_resources->insert(handle.get_id());
+    } else {
+        m_managers.compute_pipeline_manager->mark_used(handle, m_bundle.epoch);
+    }
+}
+
+void VulkanCommandDecoder::mark_used(
+    const rhi::RecordedBundleHandleType handle) const noexcept
+{
+    m_managers.recorded_bundle_manager->mark_used(handle, m_bundle.epoch);
+}
+
+bool VulkanCommandDecoder::is_recording_bundle() const noexcept
+{
+    return m_used_resources != nullptr;
+}
+
 } // namespace tundra::vulkan_rhi
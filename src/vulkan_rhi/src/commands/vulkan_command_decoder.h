@@ -1,5 +1,6 @@
 #pragma once
 #include "core/core.h"
+#include "core/std/containers/hash_set.h"
 #include "core/std/option.h"
 #include "core/std/shared_ptr.h"
 #include "core/std/tuple.h"
@@ -8,6 +9,7 @@
 #include "rhi/commands/commands.h"
 #include "rhi/resources/index_buffer.h"
 #include "rhi/resources/render_pass.h"
+#include "rhi/submit_info.h"
 #include "vulkan_barrier.h"
 
 namespace tundra::rhi {
@@ -38,6 +40,12 @@ struct TextureBufferCopyCommand;
 struct GlobalBarrierCommand;
 struct TextureBarrierCommand;
 struct BufferBarrierCommand;
+struct SetEventCommand;
+struct WaitEventCommand;
+struct WriteTimestampCommand;
+struct BeginPipelineStatisticsCommand;
+struct EndPipelineStatisticsCommand;
+struct ExecuteRecordedBundleCommand;
 
 } // namespace commands
 
@@ -54,11 +62,15 @@ private:
     const core::SharedPtr<VulkanRawDevice>& m_raw_device;
     loader::Device m_loader_device;
     VulkanCommandBufferManager::CommandBundle m_bundle;
-    decltype(m_bundle.get_resources()) m_resources;
-    Managers& m_managers;
+    const Managers& m_managers;
+    /// Set when commands are recorded into a recorded bundle.
+    core::HashSet<u64>* m_used_resources;
     VulkanBarrier m_barrier;
     const DeviceLimits& m_device_limits;
     bool m_supports_mesh_shaders;
+    /// Number of barrier commands recorded into `m_barrier`, and not executed yet.
+    u32 m_num_pending_barrier_commands = 0;
+    rhi::SubmitStatistics m_statistics;
 
     struct {
         rhi::GraphicsPipelineHandle current_graphics_pipeline;
@@ -69,14 +81,21 @@ private:
     } m_cache;
 
 public:
+    /// When `used_resources` is set, commands are recorded into a secondary command
+    /// buffer of a recorded bundle, and ids of used resources are inserted into
+    /// `used_resources` instead of being marked as used by the frame of `bundle`.
     VulkanCommandDecoder(
         const core::SharedPtr<VulkanRawDevice>& raw_device,
-        Managers& managers,
-        VulkanCommandBufferManager::CommandBundle bundle) noexcept;
+        const Managers& managers,
+        VulkanCommandBufferManager::CommandBundle bundle,
+        core::HashSet<u64>* used_resources = nullptr) noexcept;
 
 public:
     [[nodiscard]] VkCommandBuffer decode(const rhi::CommandEncoder& encoder) noexcept;
 
+    /// Returns barrier statistics of decoded encoders.
+    [[nodiscard]] const rhi::SubmitStatistics& get_statistics() const noexcept;
+
 private:
     void begin_command_buffer(
         const rhi::commands::BeginCommandBufferCommand& cmd) noexcept;
@@ -109,9 +128,38 @@ private:
     void buffer_texture_copy(const rhi::commands::BufferTextureCopyCommand& cmd) noexcept;
     void texture_buffer_copy(const rhi::commands::TextureBufferCopyCommand& cmd) noexcept;
     void buffer_barrier(const rhi::commands::BufferBarrierCommand& cmd) noexcept;
+    void set_event(const rhi::commands::SetEventCommand& cmd) noexcept;
+    void wait_event(const rhi::commands::WaitEventCommand& cmd) noexcept;
+    void write_timestamp(const rhi::commands::WriteTimestampCommand& cmd) noexcept;
+    void begin_pipeline_statistics(
+        const rhi::commands::BeginPipelineStatisticsCommand& cmd) noexcept;
+    void end_pipeline_statistics(
+        const rhi::commands::EndPipelineStatisticsCommand& cmd) noexcept;
+    void execute_recorded_bundle(
+        const rhi::commands::ExecuteRecordedBundleCommand& cmd) noexcept;
 
 private:
     void bind_compute_pipeline(const rhi::ComputePipelineHandle pipeline) noexcept;
+    /// Executes barriers of consecutive barrier commands as one pipeline barrier.
+    void flush_barriers() noexcept;
+    /// Records a barrier into `m_barrier`. When it can not be merged with
+    /// pending barriers, they are flushed first.
+    void record_texture_barrier(
+        const VulkanTexture& texture, const rhi::TextureBarrier& barrier) noexcept;
+    void record_buffer_barrier(
+        const VulkanBuffer& buffer, const rhi::BufferBarrier& barrier) noexcept;
+    /// Records barriers of a split barrier into `m_barrier`.
+    void record_split_barrier(const rhi::SplitBarrier& barrier) noexcept;
+    /// Records that a resource is used by the frame of `m_bundle`, so it is not
+    /// destroyed before the frame finishes. When recording a recorded bundle,
+    /// the resource is inserted into `m_used_resources` instead.
+    void mark_used(const rhi::BufferHandleType handle) const noexcept;
+    void mark_used(const rhi::TextureHandleType handle) const noexcept;
+    void mark_used(const rhi::TextureViewHandleType handle) const noexcept;
+    void mark_used(const rhi::GraphicsPipelineHandleType handle) const noexcept;
+    void mark_used(const rhi::ComputePipelineHandleType handle) const noexcept;
+    void mark_used(const rhi::RecordedBundleHandleType handle) const noexcept;
+    [[nodiscard]] bool is_recording_bundle() const noexcept;
 };
 
 } // namespace tundra::vulkan_rhi
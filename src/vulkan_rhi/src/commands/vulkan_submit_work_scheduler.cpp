@@ -3,6 +3,8 @@
 #include "commands/vulkan_command_decoder.h"
 #include "commands/vulkan_submit_work_scheduler.h"
 #include "core/profiler.h"
+#include "core/utils/thread_pool.h"
+#include "managers/vulkan_query_manager.h"
 #include "resources/vulkan_swapchain.h"
 #include "resources/vulkan_texture.h"
 #include "vulkan/vulkan_core.h"
@@ -27,7 +29,7 @@ VulkanSubmitWorkScheduler::VulkanSubmitWorkScheduler(
             "`create_semaphore` failed");
     }
 
-    m_timeline_semaphore = [&] {
+    for (core::Tuple<VkSemaphore, u64>& timeline_semaphore : m_timeline_semaphores) {
         VkSemaphoreTypeCreateInfo type_create_info {
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
             .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
@@ -42,8 +44,8 @@ VulkanSubmitWorkScheduler::VulkanSubmitWorkScheduler(
         const VkSemaphore semaphore = vulkan_map_result(
             m_raw_device->get_device().create_semaphore(create_info, nullptr),
             "`create_semaphore` failed");
-        return core::make_tuple(semaphore, 0);
-    }();
+        timeline_semaphore = core::make_tuple(semaphore, u64(0));
+    }
 }
 
 VulkanSubmitWorkScheduler::~VulkanSubmitWorkScheduler() noexcept
@@ -54,8 +56,18 @@ VulkanSubmitWorkScheduler::~VulkanSubmitWorkScheduler() noexcept
         m_raw_device->get_device().destroy_semaphore(semaphore, nullptr);
     }
 
-    m_raw_device->get_device().destroy_semaphore(
-        core::get<VkSemaphore>(m_timeline_semaphore), nullptr);
+    for (core::Tuple<VkSemaphore, u64>& timeline_semaphore : m_timeline_semaphores) {
+        m_raw_device->get_device().destroy_semaphore(
+            core::get<VkSemaphore>(timeline_semaphore), nullptr);
+    }
+}
+
+void VulkanSubmitWorkScheduler::begin_frame() noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanSubmitWorkScheduler::begin_frame");
+
+    m_managers.command_buffer_manager->wait_for_free_pool();
+    m_managers.query_manager->begin_frame();
 }
 
 void VulkanSubmitWorkScheduler::submit(
@@ -65,83 +77,149 @@ void VulkanSubmitWorkScheduler::submit(
     TNDR_PROFILER_TRACE("VulkanSubmitWorkScheduler::submit");
 
     Managers& managers = m_managers;
-    managers.command_buffer_manager->wait_for_free_pool();
 
     struct SubmitData {
         core::Array<VkCommandBuffer> command_buffers;
         rhi::SynchronizationStage synchronization_stage;
         rhi::QueueType queue_type;
+        core::Array<usize> wait_submit_infos;
     };
 
     core::Array<SubmitData> submit_data;
     submit_data.reserve(submit_infos.size());
 
-    for (const rhi::SubmitInfo& submit_info : submit_infos) {
-        core::Array<VkCommandBuffer> command_buffers;
-
-        for (const rhi::CommandEncoder& command_encoder : submit_info.encoders) {
-            VulkanCommandBufferManager::CommandBundle bundle =
-                managers.command_buffer_manager->get_command_bundle(
-                    submit_info.queue_type);
+    // `(submit info, encoder)` of every command encoder.
+    core::Array<core::Tuple<usize, usize>> encoders;
 
-            VulkanCommandDecoder decoder(m_raw_device, m_managers, core::move(bundle));
-            const VkCommandBuffer command_buffer = decoder.decode(command_encoder);
-
-            command_buffers.push_back(command_buffer);
+    for (usize i = 0; i < submit_infos.size(); ++i) {
+        rhi::SubmitInfo& submit_info = submit_infos[i];
+        for (usize j = 0; j < submit_info.encoders.size(); ++j) {
+            encoders.push_back(core::make_tuple(i, j));
         }
 
         submit_data.push_back(SubmitData {
-            .command_buffers = core::move(command_buffers),
+            .command_buffers = core::Array<VkCommandBuffer>(submit_info.encoders.size()),
             .synchronization_stage = submit_info.synchronization_stage,
             .queue_type = submit_info.queue_type,
+            .wait_submit_infos = core::move(submit_info.wait_submit_infos),
         });
     }
 
+    // Encoders are independent, and command buffers are allocated from pools of the
+    // decoding thread, so they are decoded in parallel. Every call writes only its own
+    // command buffer and statistics.
+    core::Array<rhi::SubmitStatistics> encoder_statistics(encoders.size());
+    const auto decode = [&](const usize index) {
+        const auto [submit_info_index, encoder_index] = encoders[index];
+        const rhi::SubmitInfo& submit_info = submit_infos[submit_info_index];
+
+        VulkanCommandBufferManager::CommandBundle bundle =
+            managers.command_buffer_manager->get_command_bundle(submit_info.queue_type);
+
+        VulkanCommandDecoder decoder(m_raw_device, m_managers, core::move(bundle));
+        submit_data[submit_info_index].command_buffers[encoder_index] = decoder.decode(
+            submit_info.encoders[encoder_index]);
+        encoder_statistics[index] = decoder.get_statistics();
+    };
+
+    {
+        TNDR_PROFILER_TRACE("VulkanSubmitWorkScheduler::submit::decode");
+
+        if (m_thread_pool != nullptr) {
+            m_thread_pool->parallel_for(encoders.size(), decode);
+        } else {
+            for (usize i = 0; i < encoders.size(); ++i) {
+                decode(i);
+            }
+        }
+    }
+
+    rhi::SubmitStatistics submit_statistics;
+    for (const rhi::SubmitStatistics& statistics : encoder_statistics) {
+        submit_statistics.num_barriers += statistics.num_barriers;
+        submit_statistics.num_removed_barriers += statistics.num_removed_barriers;
+        submit_statistics.num_pipeline_barriers += statistics.num_pipeline_barriers;
+    }
+    *m_statistics.lock() = submit_statistics;
+
     const VkFence synchronization_fence = managers.command_buffer_manager->get_fence();
     const usize num_present_infos = present_infos.size();
 
+    // Waits for the last signaled value of every timeline semaphore.
+    const auto wait_for_all_queues = [&](core::Array<VkSemaphoreSubmitInfo>& waits) {
+        for (const core::Tuple<VkSemaphore, u64>& timeline : m_timeline_semaphores) {
+            waits.push_back(VkSemaphoreSubmitInfo {
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                .semaphore = core::get<VkSemaphore>(timeline),
+                .value = core::get<u64>(timeline),
+                .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .deviceIndex = 0,
+            });
+        }
+    };
+
+    // Timeline value signaled by every submit info.
+    core::Array<u64> signal_values;
+    signal_values.reserve(submit_data.size());
+    bool is_queue_used[NUM_QUEUE_TYPES] {};
+
     for (usize i = 0; i < submit_data.size(); ++i) {
         const SubmitData& data = submit_data[i];
         const bool submit_with_synchronization_fence = (i == (submit_data.size() - 1)) &&
                                                        (num_present_infos == 0);
 
-        const VkSemaphore timeline_semaphore //
-            = core::get<VkSemaphore>(m_timeline_semaphore);
-        const u64 value_wait = core::get<u64>(m_timeline_semaphore);
-        const u64 value_signal = value_wait + 1;
-        const VkPipelineStageFlags flags //
+        auto& [timeline_semaphore, timeline_value] = //
+            this->get_timeline_semaphore(data.queue_type);
+        const VkPipelineStageFlags2 wait_stage_mask //
             = helpers::map_synchronization_stage(data.synchronization_stage);
 
-        // #TODO: https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#synchronization-semaphores-waiting
-        const VkSemaphoreSubmitInfo wait_semaphore_submit_info = [&] {
-            VkSemaphoreSubmitInfo wait_semaphore_submit_info {
+        core::Array<VkSemaphoreSubmitInfo> wait_semaphores;
+
+        // Work on other queues is ordered only by explicit waits. The work of previous
+        // frames on the same queue is waited for by the first submit on a queue,
+        // later submits on that queue are ordered by barriers.
+        bool& is_first_on_queue = is_queue_used[static_cast<usize>(data.queue_type)];
+        if (!is_first_on_queue) {
+            is_first_on_queue = true;
+            wait_semaphores.push_back(VkSemaphoreSubmitInfo {
                 .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
                 .semaphore = timeline_semaphore,
-                .value = value_wait,
+                .value = timeline_value,
                 .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
                 .deviceIndex = 0,
-            };
+            });
+        }
 
-            if (i != 0) {
-            }
+        for (const usize wait_submit_info : data.wait_submit_infos) {
+            tndr_assert(
+                wait_submit_info < i, "Submit info can only wait for earlier submits.");
 
-            return wait_semaphore_submit_info;
-        }();
-
-        const VkSemaphoreSubmitInfo signal_semaphore_submit_info = [&] {
-            VkSemaphoreSubmitInfo signal_semaphore_submit_info {
+            const SubmitData& wait_data = submit_data[wait_submit_info];
+            wait_semaphores.push_back(VkSemaphoreSubmitInfo {
                 .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-                .semaphore = timeline_semaphore,
-                .value = value_signal,
-                .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .semaphore = core::get<VkSemaphore>(
+                    this->get_timeline_semaphore(wait_data.queue_type)),
+                .value = signal_values[wait_submit_info],
+                .stageMask = wait_stage_mask,
                 .deviceIndex = 0,
-            };
+            });
+        }
 
-            if (i != 0) {
-            }
+        // The synchronization fence must be signaled only after work on all queues.
+        if (submit_with_synchronization_fence) {
+            wait_for_all_queues(wait_semaphores);
+        }
 
-            return signal_semaphore_submit_info;
-        }();
+        timeline_value += 1;
+        signal_values.push_back(timeline_value);
+
+        const VkSemaphoreSubmitInfo signal_semaphore_submit_info {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = timeline_semaphore,
+            .value = timeline_value,
+            .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .deviceIndex = 0,
+        };
 
         core::Array<VkCommandBufferSubmitInfo> command_buffer_submit_infos = [&] {
             core::Array<VkCommandBufferSubmitInfo> submit_infos;
@@ -160,8 +238,8 @@ void VulkanSubmitWorkScheduler::submit(
         VkSubmitInfo2 submit_info = [&] {
             VkSubmitInfo2 submit_info {
                 .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-                .waitSemaphoreInfoCount = 1,
-                .pWaitSemaphoreInfos = &wait_semaphore_submit_info,
+                .waitSemaphoreInfoCount = static_cast<u32>(wait_semaphores.size()),
+                .pWaitSemaphoreInfos = wait_semaphores.data(),
                 .commandBufferInfoCount = static_cast<u32>(
                     command_buffer_submit_infos.size()),
                 .pCommandBufferInfos = command_buffer_submit_infos.data(),
@@ -176,8 +254,26 @@ void VulkanSubmitWorkScheduler::submit(
             data.queue_type,
             core::as_span(submit_info),
             submit_with_synchronization_fence ? synchronization_fence : VK_NULL_HANDLE);
+    }
+
+    // The synchronization fence was reset for this frame, so it must be signaled even
+    // without any work, e.g. while the first uploads are in flight.
+    if (submit_data.empty() && (num_present_infos == 0)) {
+        core::Array<VkSemaphoreSubmitInfo> wait_semaphores;
+        wait_for_all_queues(wait_semaphores);
 
-        core::get<u64>(m_timeline_semaphore) += 1;
+        const VkSubmitInfo2 submit_info {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+            .waitSemaphoreInfoCount = static_cast<u32>(wait_semaphores.size()),
+            .pWaitSemaphoreInfos = wait_semaphores.data(),
+            .commandBufferInfoCount = 0,
+            .pCommandBufferInfos = nullptr,
+            .signalSemaphoreInfoCount = 0,
+            .pSignalSemaphoreInfos = nullptr,
+        };
+
+        m_raw_device->queue_submit(
+            rhi::QueueType::Graphics, core::as_span(submit_info), synchronization_fence);
     }
 
     // Copy textures to swapchains.
@@ -192,7 +288,6 @@ void VulkanSubmitWorkScheduler::submit(
 
         VulkanCommandBufferManager::CommandBundle command_bundle =
             managers.command_buffer_manager->get_command_bundle(rhi::QueueType::Present);
-        auto& resources = command_bundle.get_resources();
 
         const VkCommandBufferBeginInfo command_buffer_begin_info {
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
@@ -211,10 +306,10 @@ void VulkanSubmitWorkScheduler::submit(
             { 1.0, 0.75, 0.05, 1.0 });
 
         for (const rhi::PresentInfo& present_info : present_infos) {
-            resources.add_reference(
-                *managers.resource_tracker, present_info.swapchain.get_handle().get_id());
-            resources.add_reference(
-                *managers.resource_tracker, present_info.texture.get_handle().get_id());
+            managers.swapchain_manager->mark_used(
+                present_info.swapchain.get_handle(), command_bundle.epoch);
+            managers.texture_manager->mark_used(
+                present_info.texture.get_handle(), command_bundle.epoch);
 
             const auto
                 [swapchain_image_index,
@@ -356,20 +451,16 @@ void VulkanSubmitWorkScheduler::submit(
 
         //////////////////////////////////////////////////////////////////////////////////
         // Submit work to a GPU.
-        const VkSemaphore timeline_semaphore //
-            = core::get<VkSemaphore>(m_timeline_semaphore);
         const VkSemaphore present_semaphore =
             m_present_semaphores[m_submit_counter % rhi::config::MAX_FRAMES_IN_FLIGHT];
-        const u64 value_wait = core::get<u64>(m_timeline_semaphore);
-        core::get<u64>(m_timeline_semaphore) += 1;
 
-        wait_semaphores.push_back(VkSemaphoreSubmitInfo {
-            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-            .semaphore = timeline_semaphore,
-            .value = value_wait,
-            .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
-            .deviceIndex = 0,
-        });
+        // Textures can be produced on any queue, and the synchronization fence
+        // must be signaled only after work on all queues.
+        wait_for_all_queues(wait_semaphores);
+
+        auto& [timeline_semaphore, timeline_value] = //
+            this->get_timeline_semaphore(rhi::QueueType::Present);
+        timeline_value += 1;
         // // Make sure the presentation engine has finished presenting the swapchain images.
         // wait_semaphores.push_back(VkSemaphoreSubmitInfo {
         //     .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
@@ -383,7 +474,7 @@ void VulkanSubmitWorkScheduler::submit(
         signal_semaphores.push_back(VkSemaphoreSubmitInfo {
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
             .semaphore = timeline_semaphore,
-            .value = value_wait + 1,
+            .value = timeline_value,
             .stageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
             .deviceIndex = 0,
         });
@@ -430,7 +521,26 @@ void VulkanSubmitWorkScheduler::submit(
     }
 
     managers.command_buffer_manager->end_frame();
+    managers.query_manager->end_frame();
     m_submit_counter += 1;
 }
 
+rhi::SubmitStatistics VulkanSubmitWorkScheduler::get_statistics() const noexcept
+{
+    return *m_statistics.lock();
+}
+
+void VulkanSubmitWorkScheduler::set_thread_pool(core::ThreadPool* thread_pool) noexcept
+{
+    m_thread_pool = thread_pool;
+}
+
+core::Tuple<VkSemaphore, u64>& VulkanSubmitWorkScheduler::get_timeline_semaphore(
+    const rhi::QueueType queue_type) noexcept
+{
+    const usize index = static_cast<usize>(queue_type);
+    tndr_assert(index < NUM_QUEUE_TYPES, "Invalid queue type.");
+    return m_timeline_semaphores[index];
+}
+
 } // namespace tundra::vulkan_rhi
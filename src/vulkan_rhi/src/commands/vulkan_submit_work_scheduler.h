@@ -2,12 +2,18 @@
 #include "core/core.h"
 #include "core/std/containers/array.h"
 #include "core/std/shared_ptr.h"
+#include "core/std/sync/lock.h"
 #include "core/std/tuple.h"
 #include "managers/managers.h"
 #include "rhi/config.h"
+#include "rhi/enums.h"
 #include "rhi/submit_info.h"
 #include "vulkan_utils.h"
 
+namespace tundra::core {
+class ThreadPool;
+} // namespace tundra::core
+
 namespace tundra::vulkan_rhi {
 
 ///
@@ -15,10 +21,16 @@ class VulkanSubmitWorkScheduler {
 private:
     core::SharedPtr<VulkanRawDevice> m_raw_device;
     Managers m_managers;
+    static constexpr usize NUM_QUEUE_TYPES = rhi::NUM_QUEUE_TYPES;
+
     VkSemaphore m_present_semaphores[rhi::config::MAX_FRAMES_IN_FLIGHT] {};
-    /// `(semaphore, value)`.
-    core::Tuple<VkSemaphore, u64> m_timeline_semaphore {};
+    /// Timeline semaphore of every `rhi::QueueType`, `(semaphore, last signaled value)`.
+    /// Queues wait on each other only where submit infos say so.
+    core::Tuple<VkSemaphore, u64> m_timeline_semaphores[NUM_QUEUE_TYPES] {};
     u64 m_submit_counter = 0;
+    /// Written at the end of `submit`, and read from any thread.
+    mutable core::Lock<rhi::SubmitStatistics> m_statistics;
+    core::ThreadPool* m_thread_pool = nullptr;
 
 public:
     VulkanSubmitWorkScheduler(
@@ -26,9 +38,22 @@ public:
     ~VulkanSubmitWorkScheduler() noexcept;
 
 public:
+    /// Waits until resources of the frame are free, and reads query results of the frame
+    /// that used them. Must be called before every `submit`.
+    void begin_frame() noexcept;
     void submit(
         core::Array<rhi::SubmitInfo> submit_infos,
         core::Array<rhi::PresentInfo> present_infos) noexcept;
+
+    /// Returns statistics of the last `submit` call.
+    [[nodiscard]] rhi::SubmitStatistics get_statistics() const noexcept;
+
+    /// See `rhi::IRHIContext::set_thread_pool`.
+    void set_thread_pool(core::ThreadPool* thread_pool) noexcept;
+
+private:
+    [[nodiscard]] core::Tuple<VkSemaphore, u64>& get_timeline_semaphore(
+        const rhi::QueueType queue_type) noexcept;
 };
 
 } // namespace tundra::vulkan_rhi
@@ -56,6 +56,7 @@ Device::Device(
     m_table.cmd_set_depth_bias = reinterpret_cast<PFN_vkCmdSetDepthBias>(load("vkCmdSetDepthBias"));
     m_table.cmd_set_depth_bounds = reinterpret_cast<PFN_vkCmdSetDepthBounds>(load("vkCmdSetDepthBounds"));
     m_table.cmd_set_event = reinterpret_cast<PFN_vkCmdSetEvent>(load("vkCmdSetEvent"));
+    m_table.cmd_set_event2 = reinterpret_cast<PFN_vkCmdSetEvent2>(load("vkCmdSetEvent2"));
     m_table.cmd_set_line_width = reinterpret_cast<PFN_vkCmdSetLineWidth>(load("vkCmdSetLineWidth"));
     m_table.cmd_set_scissor = reinterpret_cast<PFN_vkCmdSetScissor>(load("vkCmdSetScissor"));
     m_table.cmd_set_cull_mode = reinterpret_cast<PFN_vkCmdSetCullMode>(load("vkCmdSetCullMode"));
@@ -65,6 +66,7 @@ Device::Device(
     m_table.cmd_set_viewport = reinterpret_cast<PFN_vkCmdSetViewport>(load("vkCmdSetViewport"));
     m_table.cmd_update_buffer = reinterpret_cast<PFN_vkCmdUpdateBuffer>(load("vkCmdUpdateBuffer"));
     m_table.cmd_wait_events = reinterpret_cast<PFN_vkCmdWaitEvents>(load("vkCmdWaitEvents"));
+    m_table.cmd_wait_events2 = reinterpret_cast<PFN_vkCmdWaitEvents2>(load("vkCmdWaitEvents2"));
     m_table.cmd_write_timestamp = reinterpret_cast<PFN_vkCmdWriteTimestamp>(load("vkCmdWriteTimestamp"));
     m_table.create_buffer = reinterpret_cast<PFN_vkCreateBuffer>(load("vkCreateBuffer"));
     m_table.create_buffer_view = reinterpret_cast<PFN_vkCreateBufferView>(load("vkCreateBufferView"));
@@ -417,6 +419,14 @@ void Device::cmd_end_rendering(const VkCommandBuffer command_buffer) const noexc
     m_table.cmd_end_rendering(command_buffer);
 }
 
+void Device::cmd_execute_commands(
+    const VkCommandBuffer command_buffer,
+    const core::Span<const VkCommandBuffer>& command_buffers) const noexcept
+{
+    m_table.cmd_execute_commands(
+        command_buffer, static_cast<u32>(command_buffers.size()), command_buffers.data());
+}
+
 void Device::cmd_pipeline_barrier(
     const VkCommandBuffer command_buffer,
     const VkPipelineStageFlags src_stage_mask,
@@ -446,6 +456,52 @@ void Device::cmd_pipeline_barrier2(
     m_table.cmd_pipeline_barrier2(command_buffer, dependency_info);
 }
 
+void Device::cmd_set_event2(
+    const VkCommandBuffer command_buffer,
+    const VkEvent event,
+    const VkDependencyInfo* dependency_info) const noexcept
+{
+    m_table.cmd_set_event2(command_buffer, event, dependency_info);
+}
+
+void Device::cmd_wait_events2(
+    const VkCommandBuffer command_buffer,
+    const core::Span<const VkEvent>& events,
+    const VkDependencyInfo* dependency_infos) const noexcept
+{
+    m_table.cmd_wait_events2(
+        command_buffer,
+        static_cast<u32>(events.size()),
+        events.data(),
+        dependency_infos);
+}
+
+void Device::cmd_begin_query(
+    const VkCommandBuffer command_buffer,
+    const VkQueryPool query_pool,
+    const u32 query,
+    const VkQueryControlFlags flags) const noexcept
+{
+    m_table.cmd_begin_query(command_buffer, query_pool, query, flags);
+}
+
+void Device::cmd_end_query(
+    const VkCommandBuffer command_buffer,
+    const VkQueryPool query_pool,
+    const u32 query) const noexcept
+{
+    m_table.cmd_end_query(command_buffer, query_pool, query);
+}
+
+void Device::cmd_write_timestamp(
+    const VkCommandBuffer command_buffer,
+    const VkPipelineStageFlagBits pipeline_stage,
+    const VkQueryPool query_pool,
+    const u32 query) const noexcept
+{
+    m_table.cmd_write_timestamp(command_buffer, pipeline_stage, query_pool, query);
+}
+
 void Device::cmd_push_constants(
     const VkCommandBuffer command_buffer,
     const VkPipelineLayout pipeline_layout,
@@ -549,6 +605,34 @@ core::Expected<VkFence, VkResult> Device::create_fence(
     }
 }
 
+core::Expected<VkEvent, VkResult> Device::create_event(
+    const VkEventCreateInfo& create_info,
+    const VkAllocationCallbacks* allocator) const noexcept
+{
+    VkEvent event;
+    const VkResult result = m_table.create_event(
+        m_device, &create_info, allocator, &event);
+    if (result == VK_SUCCESS) {
+        return event;
+    } else {
+        return core::make_unexpected(result);
+    }
+}
+
+core::Expected<VkQueryPool, VkResult> Device::create_query_pool(
+    const VkQueryPoolCreateInfo& create_info,
+    const VkAllocationCallbacks* allocator) const noexcept
+{
+    VkQueryPool query_pool;
+    const VkResult result = m_table.create_query_pool(
+        m_device, &create_info, allocator, &query_pool);
+    if (result == VK_SUCCESS) {
+        return query_pool;
+    } else {
+        return core::make_unexpected(result);
+    }
+}
+
 core::Expected<VkFramebuffer, VkResult> Device::create_framebuffer(
     const VkFramebufferCreateInfo& create_info,
     const VkAllocationCallbacks* allocator) const noexcept
@@ -742,6 +826,18 @@ void Device::destroy_fence(
     m_table.destroy_fence(m_device, fence, allocator);
 }
 
+void Device::destroy_event(
+    const VkEvent event, const VkAllocationCallbacks* allocator) const noexcept
+{
+    m_table.destroy_event(m_device, event, allocator);
+}
+
+void Device::destroy_query_pool(
+    const VkQueryPool query_pool, const VkAllocationCallbacks* allocator) const noexcept
+{
+    m_table.destroy_query_pool(m_device, query_pool, allocator);
+}
+
 void Device::destroy_framebuffer(
     const VkFramebuffer framebuffer,
     const VkAllocationCallbacks* allocator) const noexcept
@@ -930,6 +1026,47 @@ core::Expected<void, VkResult> Device::reset_fences(
     }
 }
 
+core::Expected<void, VkResult> Device::reset_event(const VkEvent event) const noexcept
+{
+    const VkResult result = m_table.reset_event(m_device, event);
+    if (result == VK_SUCCESS) {
+        return {};
+    } else {
+        return core::make_unexpected(result);
+    }
+}
+
+void Device::reset_query_pool(
+    const VkQueryPool query_pool, const u32 first_query, const u32 query_count)
+    const noexcept
+{
+    m_table.reset_query_pool(m_device, query_pool, first_query, query_count);
+}
+
+core::Expected<void, VkResult> Device::get_query_pool_results(
+    const VkQueryPool query_pool,
+    const u32 first_query,
+    const u32 query_count,
+    core::Span<char> data,
+    const u64 stride,
+    const VkQueryResultFlags flags) const noexcept
+{
+    const VkResult result = m_table.get_query_pool_results(
+        m_device,
+        query_pool,
+        first_query,
+        query_count,
+        data.size(),
+        data.data(),
+        stride,
+        flags);
+    if ((result == VK_SUCCESS) || (result == VK_NOT_READY)) {
+        return {};
+    } else {
+        return core::make_unexpected(result);
+    }
+}
+
 core::Expected<VkRenderPass, VkResult> Device::create_render_pass2(
     const VkRenderPassCreateInfo2& create_info,
     const VkAllocationCallbacks* allocator) const noexcept
@@ -61,6 +61,7 @@ private:
         PFN_vkCmdSetDepthBias cmd_set_depth_bias;
         PFN_vkCmdSetDepthBounds cmd_set_depth_bounds;
         PFN_vkCmdSetEvent cmd_set_event;
+        PFN_vkCmdSetEvent2 cmd_set_event2;
         PFN_vkCmdSetLineWidth cmd_set_line_width;
         PFN_vkCmdSetScissor cmd_set_scissor;
         PFN_vkCmdSetCullMode cmd_set_cull_mode;
@@ -70,6 +71,7 @@ private:
         PFN_vkCmdSetViewport cmd_set_viewport;
         PFN_vkCmdUpdateBuffer cmd_update_buffer;
         PFN_vkCmdWaitEvents cmd_wait_events;
+        PFN_vkCmdWaitEvents2 cmd_wait_events2;
         PFN_vkCmdWriteTimestamp cmd_write_timestamp;
         PFN_vkCreateBuffer create_buffer;
         PFN_vkCreateBufferView create_buffer_view;
@@ -320,6 +322,11 @@ public:
     /// https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/vkCmdEndRendering.html
     void cmd_end_rendering(const VkCommandBuffer command_buffer) const noexcept;
 
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdExecuteCommands.html
+    void cmd_execute_commands(
+        const VkCommandBuffer command_buffer,
+        const core::Span<const VkCommandBuffer>& command_buffers) const noexcept;
+
     /// https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkCmdPipelineBarrier.html
     void cmd_pipeline_barrier(
         const VkCommandBuffer command_buffer,
@@ -336,6 +343,38 @@ public:
         const VkCommandBuffer command_buffer,
         const VkDependencyInfo* dependency_info) const noexcept;
 
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdSetEvent2.html
+    void cmd_set_event2(
+        const VkCommandBuffer command_buffer,
+        const VkEvent event,
+        const VkDependencyInfo* dependency_info) const noexcept;
+
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdWaitEvents2.html
+    void cmd_wait_events2(
+        const VkCommandBuffer command_buffer,
+        const core::Span<const VkEvent>& events,
+        const VkDependencyInfo* dependency_infos) const noexcept;
+
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdBeginQuery.html
+    void cmd_begin_query(
+        const VkCommandBuffer command_buffer,
+        const VkQueryPool query_pool,
+        const u32 query,
+        const VkQueryControlFlags flags) const noexcept;
+
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdEndQuery.html
+    void cmd_end_query(
+        const VkCommandBuffer command_buffer,
+        const VkQueryPool query_pool,
+        const u32 query) const noexcept;
+
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdWriteTimestamp.html
+    void cmd_write_timestamp(
+        const VkCommandBuffer command_buffer,
+        const VkPipelineStageFlagBits pipeline_stage,
+        const VkQueryPool query_pool,
+        const u32 query) const noexcept;
+
     /// https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkCmdPushConstants.html
     void cmd_push_constants(
         const VkCommandBuffer command_buffer,
@@ -387,6 +426,16 @@ public:
         const VkFenceCreateInfo& create_info,
         const VkAllocationCallbacks* allocator) const noexcept;
 
+    /// https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkCreateEvent.html
+    [[nodiscard]] core::Expected<VkEvent, VkResult> create_event(
+        const VkEventCreateInfo& create_info,
+        const VkAllocationCallbacks* allocator) const noexcept;
+
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCreateQueryPool.html
+    [[nodiscard]] core::Expected<VkQueryPool, VkResult> create_query_pool(
+        const VkQueryPoolCreateInfo& create_info,
+        const VkAllocationCallbacks* allocator) const noexcept;
+
     /// https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkCreateFramebuffer.html
     [[nodiscard]] core::Expected<VkFramebuffer, VkResult> create_framebuffer(
         const VkFramebufferCreateInfo& create_info,
@@ -465,6 +514,15 @@ public:
     void destroy_fence(
         const VkFence fence, const VkAllocationCallbacks* allocator) const noexcept;
 
+    /// https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkDestroyEvent.html
+    void destroy_event(
+        const VkEvent event, const VkAllocationCallbacks* allocator) const noexcept;
+
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkDestroyQueryPool.html
+    void destroy_query_pool(
+        const VkQueryPool query_pool,
+        const VkAllocationCallbacks* allocator) const noexcept;
+
     /// https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkDestroyFramebuffer.html
     void destroy_framebuffer(
         const VkFramebuffer framebuffer,
@@ -554,6 +612,26 @@ public:
     [[nodiscard]] core::Expected<void, VkResult> reset_fences(
         const core::Span<const VkFence>& fences) const noexcept;
 
+    /// https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkResetEvent.html
+    [[nodiscard]] core::Expected<void, VkResult> reset_event(
+        const VkEvent event) const noexcept;
+
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkResetQueryPool.html
+    void reset_query_pool(
+        const VkQueryPool query_pool,
+        const u32 first_query,
+        const u32 query_count) const noexcept;
+
+    /// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkGetQueryPoolResults.html
+    /// `VK_NOT_READY` is not an error, results that are not available are left unwritten.
+    [[nodiscard]] core::Expected<void, VkResult> get_query_pool_results(
+        const VkQueryPool query_pool,
+        const u32 first_query,
+        const u32 query_count,
+        core::Span<char> data,
+        const u64 stride,
+        const VkQueryResultFlags flags) const noexcept;
+
     /// https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/vkCreateRenderPass2.html
     [[nodiscard]] core::Expected<VkRenderPass, VkResult> create_render_pass2(
         const VkRenderPassCreateInfo2& create_info,
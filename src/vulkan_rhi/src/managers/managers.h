@@ -2,7 +2,7 @@
 #include "core/core.h"
 #include "core/std/shared_ptr.h"
 #include "rhi/resources/handle.h"
-#include "rhi/resources/handle_manager.h"
+#include "rhi/resources/concurrent_handle_manager.h"
 
 namespace tundra::rhi {
 class ResourceTracker;
@@ -18,6 +18,7 @@ class VulkanGraphicsPipeline;
 class VulkanComputePipeline;
 class VulkanSampler;
 class VulkanTextureView;
+class VulkanRecordedBundle;
 
 class VulkanRawDevice;
 class VulkanPipelineLayoutManager;
@@ -27,31 +28,41 @@ class VulkanDescriptorBindlessManager;
 class VulkanFramebufferManager;
 class VulkanPipelineManager;
 class VulkanRenderPassManager;
+class VulkanQueryManager;
 
 struct Managers {
-    core::SharedPtr<rhi::HandleManager<rhi::SwapchainHandleType, VulkanSwapchain>>
+    core::SharedPtr<
+        rhi::ConcurrentHandleManager<rhi::SwapchainHandleType, VulkanSwapchain>>
         swapchain_manager;
-    core::SharedPtr<rhi::HandleManager<rhi::BufferHandleType, VulkanBuffer>>
+    core::SharedPtr<rhi::ConcurrentHandleManager<rhi::BufferHandleType, VulkanBuffer>>
         buffer_manager;
-    core::SharedPtr<rhi::HandleManager<rhi::TextureHandleType, VulkanTexture>>
+    core::SharedPtr<rhi::ConcurrentHandleManager<rhi::TextureHandleType, VulkanTexture>>
         texture_manager;
-    core::SharedPtr<rhi::HandleManager<rhi::TextureViewHandleType, VulkanTextureView>>
+    core::SharedPtr<
+        rhi::ConcurrentHandleManager<rhi::TextureViewHandleType, VulkanTextureView>>
         texture_view_manager;
-    core::SharedPtr<rhi::HandleManager<rhi::ShaderHandleType, VulkanShader>>
+    core::SharedPtr<rhi::ConcurrentHandleManager<rhi::ShaderHandleType, VulkanShader>>
         shader_manager;
-    core::SharedPtr<
-        rhi::HandleManager<rhi::GraphicsPipelineHandleType, VulkanGraphicsPipeline>>
+    core::SharedPtr<rhi::ConcurrentHandleManager<
+        rhi::GraphicsPipelineHandleType,
+        VulkanGraphicsPipeline>>
         graphics_pipeline_manager;
-    core::SharedPtr<
-        rhi::HandleManager<rhi::ComputePipelineHandleType, VulkanComputePipeline>>
+    core::SharedPtr<rhi::ConcurrentHandleManager<
+        rhi::ComputePipelineHandleType,
+        VulkanComputePipeline>>
         compute_pipeline_manager;
-    core::SharedPtr<rhi::HandleManager<rhi::SamplerHandleType, VulkanSampler>>
+    core::SharedPtr<rhi::ConcurrentHandleManager<rhi::SamplerHandleType, VulkanSampler>>
         sampler_manager;
+    core::SharedPtr<rhi::ConcurrentHandleManager<
+        rhi::RecordedBundleHandleType,
+        VulkanRecordedBundle>>
+        recorded_bundle_manager;
     core::SharedPtr<rhi::ResourceTracker> resource_tracker;
     core::SharedPtr<VulkanPipelineLayoutManager> pipeline_layout_manager;
     core::SharedPtr<VulkanPipelineCacheManager> pipeline_cache_manager;
     core::SharedPtr<VulkanCommandBufferManager> command_buffer_manager;
     core::SharedPtr<VulkanDescriptorBindlessManager> descriptor_bindless_manager;
+    core::SharedPtr<VulkanQueryManager> query_manager;
 
 public:
     Managers(core::SharedPtr<VulkanRawDevice> device) noexcept;
@@ -28,10 +28,8 @@ void VulkanCommandBufferManager::QueueThreadData::clear_used_commands() noexcept
 // VulkanCommandBufferManager
 
 VulkanCommandBufferManager::VulkanCommandBufferManager(
-    core::SharedPtr<VulkanRawDevice> raw_device,
-    core::SharedPtr<rhi::ResourceTracker> resource_tracker) noexcept
+    core::SharedPtr<VulkanRawDevice> raw_device) noexcept
     : m_raw_device(core::move(raw_device))
-    , m_resource_tracker(core::move(resource_tracker))
 {
     TNDR_PROFILER_TRACE("VulkanCommandBufferManager::VulkanCommandBufferManager");
 
@@ -83,12 +81,6 @@ VulkanCommandBufferManager::~VulkanCommandBufferManager() noexcept
         const auto cleanup_frame_data = [&](QueueData& queue_data) {
             auto thread_to_storage = queue_data.thread_to_storage.lock();
             for (auto& [_, thread_data] : *thread_to_storage) {
-                // Destroy resources.
-                for (const u64 resource : thread_data->resources.resources) {
-                    m_resource_tracker->remove_reference(resource);
-                }
-                thread_data->resources.resources.clear();
-
                 m_raw_device->get_device().destroy_command_pool(
                     thread_data->command_pool, nullptr);
             }
@@ -100,6 +92,10 @@ VulkanCommandBufferManager::~VulkanCommandBufferManager() noexcept
         cleanup_frame_data(frame_data.present_queue);
 
         m_raw_device->get_device().destroy_fence(frame_data.fence, nullptr);
+
+        for (const VkEvent event : *frame_data.events.lock()) {
+            m_raw_device->get_device().destroy_event(event, nullptr);
+        }
     }
 }
 
@@ -108,8 +104,9 @@ VulkanCommandBufferManager::CommandBundle VulkanCommandBufferManager::get_comman
 {
     TNDR_PROFILER_TRACE("VulkanCommandBufferManager::get_command_bundle");
 
+    const u64 frame_counter = *m_frame_counter.lock();
     FrameData& frame_data =
-        m_frame_data[*m_frame_counter.lock() % rhi::config::MAX_FRAMES_IN_FLIGHT];
+        m_frame_data[frame_counter % rhi::config::MAX_FRAMES_IN_FLIGHT];
     QueueData& queue_data = [&]() -> QueueData& {
         switch (queue_type) {
             case rhi::QueueType::Compute:
@@ -201,6 +198,7 @@ VulkanCommandBufferManager::CommandBundle VulkanCommandBufferManager::get_comman
     return VulkanCommandBufferManager::CommandBundle {
         .command_buffer = command_buffer,
         .thread_data = core::move(thread_data),
+        .epoch = frame_counter + 1,
     };
 }
 
@@ -208,8 +206,9 @@ void VulkanCommandBufferManager::wait_for_free_pool() noexcept
 {
     TNDR_PROFILER_TRACE("VulkanCommandBufferManager::wait_for_free_pool");
 
+    const u64 frame_counter = *m_frame_counter.lock();
     FrameData& frame_data =
-        m_frame_data[*m_frame_counter.lock() % rhi::config::MAX_FRAMES_IN_FLIGHT];
+        m_frame_data[frame_counter % rhi::config::MAX_FRAMES_IN_FLIGHT];
 
     {
         TNDR_PROFILER_TRACE(
@@ -221,6 +220,15 @@ void VulkanCommandBufferManager::wait_for_free_pool() noexcept
             "`wait_for_fences` failed");
     }
 
+    // The fence of a frame is signaled after work of all queues submitted until then,
+    // so frames finish in order. The frame that used this pool was
+    // `MAX_FRAMES_IN_FLIGHT` frames ago.
+    if (frame_counter >= rhi::config::MAX_FRAMES_IN_FLIGHT) {
+        m_completed_epoch.store(
+            frame_counter - rhi::config::MAX_FRAMES_IN_FLIGHT + 1,
+            std::memory_order_release);
+    }
+
     {
         TNDR_PROFILER_TRACE(
             "VulkanCommandBufferManager::wait_for_free_pool::reset_fences");
@@ -239,12 +247,6 @@ void VulkanCommandBufferManager::wait_for_free_pool() noexcept
                 "`reset_command_pool` failed");
 
             thread_data->clear_used_commands();
-
-            // Destroy resources.
-            for (const u64 resource : thread_data->resources.resources) {
-                m_resource_tracker->remove_reference(resource);
-            }
-            thread_data->resources.resources.clear();
         }
     };
 
@@ -254,6 +256,11 @@ void VulkanCommandBufferManager::wait_for_free_pool() noexcept
     reset_command_pool(frame_data.compute_queue);
     reset_command_pool(frame_data.transfer_queue);
     reset_command_pool(frame_data.present_queue);
+
+    for (const VkEvent event : *frame_data.events.lock()) {
+        vulkan_map_result(
+            m_raw_device->get_device().reset_event(event), "`reset_event` failed");
+    }
 }
 
 void VulkanCommandBufferManager::end_frame() noexcept
@@ -268,4 +275,57 @@ VkFence VulkanCommandBufferManager::get_fence() noexcept
     return frame_data.fence;
 }
 
+u64 VulkanCommandBufferManager::get_completed_epoch() const noexcept
+{
+    return m_completed_epoch.load(std::memory_order_acquire);
+}
+
+void VulkanCommandBufferManager::wait_for_epoch(const u64 epoch) noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanCommandBufferManager::wait_for_epoch");
+
+    if (epoch <= this->get_completed_epoch()) {
+        return;
+    }
+
+    const u64 frame_counter = *m_frame_counter.lock();
+    tndr_assert(epoch <= frame_counter, "The frame was not submitted yet.");
+
+    // The fence is reset only by `wait_for_free_pool` of the frame
+    // `MAX_FRAMES_IN_FLIGHT` frames later, which completes this epoch first.
+    const FrameData& frame_data =
+        m_frame_data[(epoch - 1) % rhi::config::MAX_FRAMES_IN_FLIGHT];
+
+    vulkan_map_result(
+        m_raw_device->get_device().wait_for_fences(
+            core::as_span(frame_data.fence), true, UINT64_MAX),
+        "`wait_for_fences` failed");
+
+    // Frames finish in order, so all epochs until `epoch` are completed.
+    u64 completed_epoch = m_completed_epoch.load(std::memory_order_relaxed);
+    while ((completed_epoch < epoch) &&
+           !m_completed_epoch.compare_exchange_weak(
+               completed_epoch, epoch, std::memory_order_release)) {
+    }
+}
+
+VkEvent VulkanCommandBufferManager::get_event(const u32 index) noexcept
+{
+    FrameData& frame_data =
+        m_frame_data[*m_frame_counter.lock() % rhi::config::MAX_FRAMES_IN_FLIGHT];
+
+    auto events = frame_data.events.lock();
+    while (events->size() <= index) {
+        const VkEventCreateInfo create_info {
+            .sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO,
+        };
+
+        events->push_back(vulkan_map_result(
+            m_raw_device->get_device().create_event(create_info, nullptr),
+            "`create_event` failed"));
+    }
+
+    return (*events)[index];
+}
+
 } // namespace tundra::vulkan_rhi
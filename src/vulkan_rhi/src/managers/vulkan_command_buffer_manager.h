@@ -8,8 +8,8 @@
 #include "core/std/sync/lock.h"
 #include "rhi/config.h"
 #include "rhi/enums.h"
-#include "rhi/resources/resource_tracker.h"
 #include "vulkan_utils.h"
+#include <atomic>
 
 namespace tundra::vulkan_rhi {
 
@@ -18,7 +18,6 @@ class VulkanRawDevice;
 class VulkanCommandBufferManager {
 private:
     struct QueueThreadData {
-        rhi::ResourceTracker::Resources resources;
         VkCommandPool command_pool;
         core::Deque<VkCommandBuffer> free_command_buffers;
         core::Deque<VkCommandBuffer> used_command_buffers;
@@ -37,29 +36,30 @@ private:
         QueueData transfer_queue;
         QueueData present_queue;
         VkFence fence;
+        /// Events of split barriers, indexed by `rhi::SplitBarrier::event`.
+        /// They are reset once the frame finishes.
+        core::Lock<core::Array<VkEvent>> events;
     };
 
 public:
     struct CommandBundle {
         VkCommandBuffer command_buffer;
         core::SharedPtr<QueueThreadData> thread_data;
-
-        [[nodiscard]] rhi::ResourceTracker::Resources& get_resources() const noexcept
-        {
-            return thread_data->resources;
-        }
+        /// Epoch of the frame. Epochs start at `1` and increase by one every frame,
+        /// so resources used by a frame record its epoch
+        /// (see `rhi::ConcurrentHandleManager::mark_used`).
+        u64 epoch;
     };
 
 private:
     core::SharedPtr<VulkanRawDevice> m_raw_device;
-    core::SharedPtr<rhi::ResourceTracker> m_resource_tracker;
     FrameData m_frame_data[rhi::config::MAX_FRAMES_IN_FLIGHT];
     core::Lock<u64> m_frame_counter;
+    /// See `get_completed_epoch`.
+    std::atomic<u64> m_completed_epoch = 0;
 
 public:
-    VulkanCommandBufferManager(
-        core::SharedPtr<VulkanRawDevice> device,
-        core::SharedPtr<rhi::ResourceTracker> resource_tracker) noexcept;
+    VulkanCommandBufferManager(core::SharedPtr<VulkanRawDevice> device) noexcept;
     ~VulkanCommandBufferManager() noexcept;
 
     VulkanCommandBufferManager(const VulkanCommandBufferManager&) = delete;
@@ -73,6 +73,15 @@ public:
     void wait_for_free_pool() noexcept;
     void end_frame() noexcept;
     [[nodiscard]] VkFence get_fence() noexcept;
+    /// Returns the last epoch whose work has finished on the GPU.
+    /// Updated by `wait_for_free_pool`.
+    [[nodiscard]] u64 get_completed_epoch() const noexcept;
+    /// Blocks until the frame with `epoch` finishes on the GPU.
+    /// The frame must be already submitted.
+    void wait_for_epoch(const u64 epoch) noexcept;
+    /// Returns an unsignaled event of the current frame.
+    /// The same `index` returns the same event until the end of the frame.
+    [[nodiscard]] VkEvent get_event(const u32 index) noexcept;
 };
 
 } // namespace tundra::vulkan_rhi
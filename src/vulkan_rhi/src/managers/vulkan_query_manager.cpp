@@ -0,0 +1,191 @@
+#include "managers/vulkan_query_manager.h"
+#include "core/profiler.h"
+#include "core/std/assert.h"
+#include "core/std/span.h"
+#include "core/std/utils.h"
+#include "vulkan_device.h"
+#include "vulkan_helpers.h"
+#include <algorithm>
+
+namespace tundra::vulkan_rhi {
+
+/// Values of a pipeline statistics query are written in the order of these bits.
+static constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+static constexpr u32 NUM_PIPELINE_STATISTICS = 7;
+
+VulkanQueryManager::VulkanQueryManager(
+    core::SharedPtr<VulkanRawDevice> raw_device) noexcept
+    : m_raw_device(core::move(raw_device))
+{
+    TNDR_PROFILER_TRACE("VulkanQueryManager::VulkanQueryManager");
+
+    const auto create_query_pool = [&](const VkQueryType query_type,
+                                       const u32 query_count,
+                                       const VkQueryPipelineStatisticFlags statistics) {
+        const VkQueryPoolCreateInfo create_info {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = query_type,
+            .queryCount = query_count,
+            .pipelineStatistics = statistics,
+        };
+
+        const VkQueryPool query_pool = vulkan_map_result(
+            m_raw_device->get_device().create_query_pool(create_info, nullptr),
+            "`create_query_pool` failed");
+
+        // Queries must be reset before they are used for the first time.
+        m_raw_device->get_device().reset_query_pool(query_pool, 0, query_count);
+        return query_pool;
+    };
+
+    for (FrameData& frame_data : m_frame_data) {
+        frame_data.timestamps.query_pool = create_query_pool(
+            VK_QUERY_TYPE_TIMESTAMP, rhi::config::MAX_TIMESTAMP_QUERIES, 0);
+        frame_data.pipeline_statistics.query_pool = create_query_pool(
+            VK_QUERY_TYPE_PIPELINE_STATISTICS,
+            rhi::config::MAX_PIPELINE_STATISTICS_QUERIES,
+            PIPELINE_STATISTICS);
+    }
+}
+
+VulkanQueryManager::~VulkanQueryManager() noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanQueryManager::~VulkanQueryManager");
+
+    for (const FrameData& frame_data : m_frame_data) {
+        m_raw_device->get_device().destroy_query_pool(
+            frame_data.timestamps.query_pool, nullptr);
+        m_raw_device->get_device().destroy_query_pool(
+            frame_data.pipeline_statistics.query_pool, nullptr);
+    }
+}
+
+void VulkanQueryManager::begin_frame() noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanQueryManager::begin_frame");
+
+    FrameData& frame_data = this->get_frame_data();
+
+    {
+        // `(timestamp, availability)` pairs.
+        const core::Array<u64> results = this->read_results(frame_data.timestamps, 1);
+        const DeviceLimits& device_limits = m_raw_device->get_device_limits();
+        const f64 timestamp_period = static_cast<f64>(device_limits.timestamp_period);
+
+        m_timestamps.clear();
+        m_timestamps.reserve(results.size() / 2);
+        for (usize i = 0; i < results.size(); i += 2) {
+            const bool is_available = results[i + 1] != 0;
+            if (is_available) {
+                const u64 ticks = results[i] & device_limits.timestamp_valid_mask;
+                m_timestamps.push_back(
+                    static_cast<u64>(static_cast<f64>(ticks) * timestamp_period));
+            } else {
+                m_timestamps.push_back(std::nullopt);
+            }
+        }
+    }
+
+    {
+        const core::Array<u64> results = this->read_results(
+            frame_data.pipeline_statistics, NUM_PIPELINE_STATISTICS);
+        constexpr usize stride = NUM_PIPELINE_STATISTICS + 1;
+
+        m_pipeline_statistics.clear();
+        m_pipeline_statistics.reserve(results.size() / stride);
+        for (usize i = 0; i < results.size(); i += stride) {
+            const bool is_available = results[i + NUM_PIPELINE_STATISTICS] != 0;
+            if (is_available) {
+                m_pipeline_statistics.push_back(rhi::PipelineStatistics {
+                    .input_assembly_vertices = results[i + 0],
+                    .input_assembly_primitives = results[i + 1],
+                    .vertex_shader_invocations = results[i + 2],
+                    .clipping_invocations = results[i + 3],
+                    .clipping_primitives = results[i + 4],
+                    .fragment_shader_invocations = results[i + 5],
+                    .compute_shader_invocations = results[i + 6],
+                });
+            } else {
+                m_pipeline_statistics.push_back(std::nullopt);
+            }
+        }
+    }
+}
+
+void VulkanQueryManager::end_frame() noexcept
+{
+    *m_frame_counter.lock() += 1;
+}
+
+VkQueryPool VulkanQueryManager::use_timestamp_query(const u32 query) noexcept
+{
+    tndr_assert(query < rhi::config::MAX_TIMESTAMP_QUERIES, "Invalid query.");
+
+    QueryPool& pool = this->get_frame_data().timestamps;
+    auto num_queries = pool.num_queries.lock();
+    *num_queries = std::max(*num_queries, query + 1);
+
+    return pool.query_pool;
+}
+
+VkQueryPool VulkanQueryManager::use_pipeline_statistics_query(const u32 query) noexcept
+{
+    tndr_assert(query < rhi::config::MAX_PIPELINE_STATISTICS_QUERIES, "Invalid query.");
+
+    QueryPool& pool = this->get_frame_data().pipeline_statistics;
+    auto num_queries = pool.num_queries.lock();
+    *num_queries = std::max(*num_queries, query + 1);
+
+    return pool.query_pool;
+}
+
+core::Array<core::Option<u64>> VulkanQueryManager::get_timestamps() const noexcept
+{
+    return m_timestamps;
+}
+
+core::Array<core::Option<rhi::PipelineStatistics>> VulkanQueryManager::
+    get_pipeline_statistics() const noexcept
+{
+    return m_pipeline_statistics;
+}
+
+VulkanQueryManager::FrameData& VulkanQueryManager::get_frame_data() noexcept
+{
+    return m_frame_data[*m_frame_counter.lock() % rhi::config::MAX_FRAMES_IN_FLIGHT];
+}
+
+core::Array<u64> VulkanQueryManager::read_results(
+    QueryPool& pool, const u32 num_values) noexcept
+{
+    const u32 num_queries = core::exchange(*pool.num_queries.lock(), 0u);
+    if (num_queries == 0) {
+        return {};
+    }
+
+    const usize stride = static_cast<usize>(num_values) + 1;
+    core::Array<u64> results(static_cast<usize>(num_queries) * stride);
+    vulkan_map_result(
+        m_raw_device->get_device().get_query_pool_results(
+            pool.query_pool,
+            0,
+            num_queries,
+            core::Span<char>(
+                reinterpret_cast<char*>(results.data()), results.size() * sizeof(u64)),
+            stride * sizeof(u64),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT),
+        "`get_query_pool_results` failed");
+
+    m_raw_device->get_device().reset_query_pool(pool.query_pool, 0, num_queries);
+
+    return results;
+}
+
+} // namespace tundra::vulkan_rhi
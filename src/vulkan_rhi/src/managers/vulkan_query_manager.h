@@ -0,0 +1,75 @@
+#pragma once
+#include "core/core.h"
+#include "core/std/containers/array.h"
+#include "core/std/option.h"
+#include "core/std/shared_ptr.h"
+#include "core/std/sync/lock.h"
+#include "rhi/config.h"
+#include "rhi/submit_info.h"
+#include "vulkan_utils.h"
+
+namespace tundra::vulkan_rhi {
+
+class VulkanRawDevice;
+
+/// Owns query pools of frames in flight.
+///
+/// A frame uses its pools only after `VulkanCommandBufferManager::wait_for_free_pool`
+/// returns, so `begin_frame` reads results of the previous use of the pools and resets
+/// them on the host.
+class VulkanQueryManager {
+private:
+    struct QueryPool {
+        VkQueryPool query_pool;
+        /// One past the highest query used in the frame.
+        core::Lock<u32> num_queries;
+    };
+
+    struct FrameData {
+        QueryPool timestamps;
+        QueryPool pipeline_statistics;
+    };
+
+private:
+    core::SharedPtr<VulkanRawDevice> m_raw_device;
+    FrameData m_frame_data[rhi::config::MAX_FRAMES_IN_FLIGHT];
+    core::Lock<u64> m_frame_counter;
+    /// Results read by the last `begin_frame` call.
+    core::Array<core::Option<u64>> m_timestamps;
+    core::Array<core::Option<rhi::PipelineStatistics>> m_pipeline_statistics;
+
+public:
+    VulkanQueryManager(core::SharedPtr<VulkanRawDevice> device) noexcept;
+    ~VulkanQueryManager() noexcept;
+
+    VulkanQueryManager(const VulkanQueryManager&) = delete;
+    VulkanQueryManager(VulkanQueryManager&&) noexcept = delete;
+    VulkanQueryManager& operator=(const VulkanQueryManager&) = delete;
+    VulkanQueryManager& operator=(VulkanQueryManager&&) noexcept = delete;
+
+public:
+    /// Reads results of the frame that previously used the pools of the current frame,
+    /// and resets them. Must be called after `VulkanCommandBufferManager::wait_for_free_pool`.
+    void begin_frame() noexcept;
+    void end_frame() noexcept;
+
+    /// Returns a query pool of the current frame, in which `query` is written.
+    [[nodiscard]] VkQueryPool use_timestamp_query(const u32 query) noexcept;
+    /// Returns a query pool of the current frame, in which `query` is counted.
+    [[nodiscard]] VkQueryPool use_pipeline_statistics_query(const u32 query) noexcept;
+
+    /// See `rhi::IRHIContext::get_timestamps`.
+    [[nodiscard]] core::Array<core::Option<u64>> get_timestamps() const noexcept;
+    /// See `rhi::IRHIContext::get_pipeline_statistics`.
+    [[nodiscard]] core::Array<core::Option<rhi::PipelineStatistics>>
+        get_pipeline_statistics() const noexcept;
+
+private:
+    [[nodiscard]] FrameData& get_frame_data() noexcept;
+    /// Returns `num_values` values followed by an availability value, for every used
+    /// query, and resets the pool.
+    [[nodiscard]] core::Array<u64> read_results(
+        QueryPool& pool, const u32 num_values) noexcept;
+};
+
+} // namespace tundra::vulkan_rhi
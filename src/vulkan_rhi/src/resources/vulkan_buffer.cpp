@@ -101,6 +101,34 @@ void VulkanBuffer::update_buffer(
     }
 }
 
+core::Array<char> VulkanBuffer::read_buffer(
+    const rhi::BufferSubresourceRange& range) const noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanBuffer::read_buffer");
+
+    tndr_assert(m_allocation.mapped_memory != nullptr, "`mapped_memory` is nullptr.");
+    tndr_assert(m_memory_type == rhi::MemoryType::Readback, "Invalid memory type.");
+    tndr_assert(range.offset <= this->get_capacity(), "`range.offset` is out of bounds.");
+
+    const u64 size = (range.size == rhi::WHOLE_SIZE)
+                         ? (this->get_capacity() - range.offset)
+                         : range.size;
+    tndr_assert(
+        (range.offset + size) <= this->get_capacity(),
+        "`range.offset` + `range.size` is bigger than buffer capacity.");
+
+    // Readback memory is not guaranteed to be host coherent.
+    m_allocator->invalidate_allocation(m_allocation, range.offset, size);
+
+    core::Array<char> data(static_cast<usize>(size));
+    std::memcpy(
+        data.data(),
+        core::pointer_math::add(m_allocation.mapped_memory, range.offset),
+        data.size());
+
+    return data;
+}
+
 VkBuffer VulkanBuffer::get_buffer() const noexcept
 {
     return m_allocation.object;
@@ -121,4 +149,17 @@ rhi::MemoryType VulkanBuffer::get_memory_type() const noexcept
     return m_memory_type;
 }
 
+core::Span<char> VulkanBuffer::get_mapped_memory() const noexcept
+{
+    tndr_assert(m_allocation.mapped_memory != nullptr, "`mapped_memory` is nullptr.");
+    tndr_assert(
+        (m_memory_type == rhi::MemoryType::Upload) ||
+            (m_memory_type == rhi::MemoryType::Dynamic),
+        "Invalid memory type.");
+
+    return core::Span<char>(
+        static_cast<char*>(m_allocation.mapped_memory),
+        static_cast<usize>(m_buffer_capacity));
+}
+
 } // namespace tundra::vulkan_rhi
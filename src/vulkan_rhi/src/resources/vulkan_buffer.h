@@ -35,12 +35,16 @@ public:
 public:
     void update_buffer(
         const core::Array<rhi::BufferUpdateRegion>& update_regions) noexcept;
+    [[nodiscard]] core::Array<char> read_buffer(
+        const rhi::BufferSubresourceRange& range) const noexcept;
 
 public:
     [[nodiscard]] VkBuffer get_buffer() const noexcept;
     [[nodiscard]] u64 get_capacity() const noexcept;
     [[nodiscard]] rhi::BufferUsageFlags get_usage_flags() const noexcept;
     [[nodiscard]] rhi::MemoryType get_memory_type() const noexcept;
+    /// Returns the persistently mapped memory of an `Upload` or `Dynamic` buffer.
+    [[nodiscard]] core::Span<char> get_mapped_memory() const noexcept;
 };
 
 } // namespace tundra::vulkan_rhi
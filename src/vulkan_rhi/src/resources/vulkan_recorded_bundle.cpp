@@ -0,0 +1,130 @@
+#include "resources/vulkan_recorded_bundle.h"
+#include "commands/vulkan_command_decoder.h"
+#include "core/profiler.h"
+#include "core/std/containers/hash_set.h"
+#include "managers/managers.h"
+#include "vulkan_device.h"
+#include "vulkan_helpers.h"
+
+namespace tundra::vulkan_rhi {
+
+VulkanRecordedBundle::VulkanRecordedBundle(
+    core::SharedPtr<VulkanRawDevice> raw_device,
+    const Managers& managers,
+    const rhi::RecordedBundleCreateInfo& create_info) noexcept
+    : m_raw_device(core::move(raw_device))
+    , m_resource_tracker(managers.resource_tracker)
+{
+    TNDR_PROFILER_TRACE("VulkanRecordedBundle::VulkanRecordedBundle");
+
+    const VulkanQueues& queues = m_raw_device->get_queues();
+    const u32 queue_family_index = [&] {
+        switch (create_info.queue_type) {
+            case rhi::QueueType::Compute:
+                return core::get<u32>(queues.compute_queue);
+            case rhi::QueueType::Graphics:
+                return core::get<u32>(queues.graphics_queue);
+            case rhi::QueueType::Transfer:
+                return core::get<u32>(queues.transfer_queue);
+            case rhi::QueueType::Present:
+                return core::get<u32>(queues.present_queue);
+        }
+
+        core::panic("Invalid enum");
+    }();
+
+    // The command buffer is never reset, so it gets its own pool, which is not used
+    // by other threads.
+    const VkCommandPoolCreateInfo command_pool_create_info {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = queue_family_index,
+    };
+
+    m_command_pool = vulkan_map_result(
+        m_raw_device->get_device().create_command_pool(command_pool_create_info, nullptr),
+        "`create_command_pool` failed");
+
+    const VkCommandBufferAllocateInfo command_buffer_allocate_info {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = m_command_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+        .commandBufferCount = 1,
+    };
+
+    m_command_buffer = vulkan_map_result(
+        m_raw_device->get_device().allocate_command_buffers(command_buffer_allocate_info),
+        "`allocate_command_buffers` failed")[0];
+
+    core::HashSet<u64> used_resources;
+    VulkanCommandDecoder decoder(
+        m_raw_device,
+        managers,
+        VulkanCommandBufferManager::CommandBundle {
+            .command_buffer = m_command_buffer,
+            .thread_data = nullptr,
+            .epoch = 0,
+        },
+        &used_resources);
+    [[maybe_unused]] const VkCommandBuffer command_buffer = decoder.decode(
+        create_info.encoder);
+
+    m_used_resources.reserve(used_resources.size());
+    for (const u64 resource : used_resources) {
+        m_resource_tracker->add_reference(resource);
+        m_used_resources.push_back(resource);
+    }
+
+    if (!create_info.name.empty()) {
+        helpers::set_object_name(
+            m_raw_device,
+            reinterpret_cast<u64>(m_command_buffer),
+            VK_OBJECT_TYPE_COMMAND_BUFFER,
+            create_info.name.c_str());
+    }
+}
+
+VulkanRecordedBundle::~VulkanRecordedBundle() noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanRecordedBundle::~VulkanRecordedBundle");
+
+    if (m_command_pool != VK_NULL_HANDLE) {
+        for (const u64 resource : m_used_resources) {
+            m_resource_tracker->remove_reference(resource);
+        }
+
+        // Destroying the pool frees its command buffer.
+        m_raw_device->get_device().destroy_command_pool(m_command_pool, nullptr);
+        m_command_pool = VK_NULL_HANDLE;
+        m_command_buffer = VK_NULL_HANDLE;
+    }
+}
+
+VulkanRecordedBundle::VulkanRecordedBundle(VulkanRecordedBundle&& rhs) noexcept
+    : m_raw_device(core::move(rhs.m_raw_device))
+    , m_resource_tracker(core::move(rhs.m_resource_tracker))
+    , m_used_resources(core::move(rhs.m_used_resources))
+    , m_command_pool(core::exchange(rhs.m_command_pool, VK_NULL_HANDLE))
+    , m_command_buffer(core::exchange(rhs.m_command_buffer, VK_NULL_HANDLE))
+{
+}
+
+VulkanRecordedBundle& VulkanRecordedBundle::operator=(
+    VulkanRecordedBundle&& rhs) noexcept
+{
+    if (&rhs != this) {
+        m_raw_device = core::move(rhs.m_raw_device);
+        m_resource_tracker = core::move(rhs.m_resource_tracker);
+        m_used_resources = core::move(rhs.m_used_resources);
+        m_command_pool = core::exchange(rhs.m_command_pool, VK_NULL_HANDLE);
+        m_command_buffer = core::exchange(rhs.m_command_buffer, VK_NULL_HANDLE);
+    }
+
+    return *this;
+}
+
+VkCommandBuffer VulkanRecordedBundle::get_command_buffer() const noexcept
+{
+    return m_command_buffer;
+}
+
+} // namespace tundra::vulkan_rhi
@@ -0,0 +1,42 @@
+#pragma once
+#include "core/std/containers/array.h"
+#include "core/std/shared_ptr.h"
+#include "rhi/resources/recorded_bundle.h"
+#include "rhi/resources/resource_tracker.h"
+#include "vulkan_utils.h"
+
+namespace tundra::vulkan_rhi {
+
+class VulkanRawDevice;
+struct Managers;
+
+/// A secondary command buffer, decoded once from the encoder of the create info.
+///
+/// The bundle holds references to resources used by its commands. Frames executing the
+/// bundle mark only the bundle as used, so the resources are released after the last
+/// such frame finishes.
+class VulkanRecordedBundle {
+private:
+    core::SharedPtr<VulkanRawDevice> m_raw_device;
+    core::SharedPtr<rhi::ResourceTracker> m_resource_tracker;
+    core::Array<u64> m_used_resources;
+    VkCommandPool m_command_pool;
+    VkCommandBuffer m_command_buffer;
+
+public:
+    VulkanRecordedBundle(
+        core::SharedPtr<VulkanRawDevice> raw_device,
+        const Managers& managers,
+        const rhi::RecordedBundleCreateInfo& create_info) noexcept;
+    ~VulkanRecordedBundle() noexcept;
+
+    VulkanRecordedBundle(VulkanRecordedBundle&& rhs) noexcept;
+    VulkanRecordedBundle& operator=(VulkanRecordedBundle&& rhs) noexcept;
+    VulkanRecordedBundle(const VulkanRecordedBundle&) noexcept = delete;
+    VulkanRecordedBundle& operator=(const VulkanRecordedBundle&) noexcept = delete;
+
+public:
+    [[nodiscard]] VkCommandBuffer get_command_buffer() const noexcept;
+};
+
+} // namespace tundra::vulkan_rhi
@@ -171,6 +171,18 @@ void VulkanAllocator::destroy_buffer(const VulkanAllocation<VkBuffer>& allocatio
     vmaDestroyBuffer(m_allocator, allocation.object, allocation.allocation);
 }
 
+void VulkanAllocator::invalidate_allocation(
+    const VulkanAllocation<VkBuffer>& allocation,
+    const u64 offset,
+    const u64 size) noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanAllocator::invalidate_allocation");
+
+    [[maybe_unused]] const VkResult result = vmaInvalidateAllocation(
+        m_allocator, allocation.allocation, offset, size);
+    tndr_assert(result == VK_SUCCESS, "`vmaInvalidateAllocation` failed.");
+}
+
 core::Expected<VulkanAllocation<VkImage>, VkResult> VulkanAllocator::create_image(
     const VkImageCreateInfo& create_info,
     const AllocationCreateInfo& allocation_create_info) noexcept
@@ -48,6 +48,12 @@ public:
 
     void destroy_buffer(const VulkanAllocation<VkBuffer>& allocation) noexcept;
 
+    /// Makes device writes to a host visible buffer visible to the host.
+    void invalidate_allocation(
+        const VulkanAllocation<VkBuffer>& allocation,
+        const u64 offset,
+        const u64 size) noexcept;
+
     [[nodiscard]] core::Expected<VulkanAllocation<VkImage>, VkResult> create_image(
         const VkImageCreateInfo& create_info,
         const AllocationCreateInfo& allocation_create_info) noexcept;
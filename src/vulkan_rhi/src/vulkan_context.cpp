@@ -78,6 +78,7 @@ void VulkanContext::create_device() noexcept
                 .multiDrawIndirect = true,
                 .depthBounds = true,
                 .samplerAnisotropy = true,
+                .pipelineStatisticsQuery = true,
                 .vertexPipelineStoresAndAtomics = true,
                 .fragmentStoresAndAtomics = true,
                 .shaderInt64 = true,
@@ -102,6 +103,7 @@ void VulkanContext::create_device() noexcept
         .descriptorBindingStorageBufferUpdateAfterBind = true,
         .descriptorBindingPartiallyBound = true,
         .runtimeDescriptorArray = true,
+        .hostQueryReset = true,
         .timelineSemaphore = true,
     };
 
@@ -187,9 +189,22 @@ void VulkanContext::create_device() noexcept
         physical_device_properties.properties.pipelineCacheUUID,
         std::size(device_properties.pipeline_cache_uuid));
 
+    // Timestamps are written on the graphics and compute queues only.
+    const core::Array<VkQueueFamilyProperties> queue_families =
+        m_instance->get_instance().get_physical_device_queue_family_properties(
+            device.physical_device);
+    const u32 timestamp_valid_bits = std::min(
+        queue_families[device.queues.graphics].timestampValidBits,
+        queue_families[device.queues.compute].timestampValidBits);
+
     const DeviceLimits device_limits {
         .max_sampler_anisotropy = physical_device_properties.properties.limits
                                       .maxSamplerAnisotropy,
+        .timestamp_period = physical_device_properties.properties.limits
+                                .timestampPeriod,
+        .timestamp_valid_mask = timestamp_valid_bits >= 64
+                                    ? ~u64(0)
+                                    : (u64(1) << timestamp_valid_bits) - 1,
     };
 
     m_devices.push_back(std::make_shared<VulkanDevice>(
@@ -8,9 +8,11 @@
 #include "managers/vulkan_descriptor_bindless_manager.h"
 #include "managers/vulkan_pipeline_cache_manager.h"
 #include "managers/vulkan_pipeline_layout_manager.h"
+#include "managers/vulkan_query_manager.h"
 #include "resources/vulkan_buffer.h"
 #include "resources/vulkan_compute_pipeline.h"
 #include "resources/vulkan_graphics_pipeline.h"
+#include "resources/vulkan_recorded_bundle.h"
 #include "resources/vulkan_sampler.h"
 #include "resources/vulkan_shader.h"
 #include "resources/vulkan_swapchain.h"
@@ -192,28 +194,246 @@ VulkanDevice::~VulkanDevice() noexcept
 {
     TNDR_PROFILER_TRACE("VulkanDevice::~VulkanDevice");
 
+    this->set_async_submit(false);
     this->wait_until_idle();
+
+    // Destroying a resource may release resources it references (e.g. resources used
+    // by a recorded bundle), so it is repeated until nothing is released.
+    core::Array<rhi::ResourceTracker::ReleasedResource> released_resources =
+        m_managers.resource_tracker->take_released_resources();
+    while (!released_resources.empty()) {
+        this->gc(core::move(released_resources), UINT64_MAX);
+        released_resources = m_managers.resource_tracker->take_released_resources();
+    }
 }
 
 void VulkanDevice::wait_until_idle() const noexcept
 {
     TNDR_PROFILER_TRACE("VulkanDevice::wait_until_idle");
 
+    this->wait_for_jobs(m_num_finished_jobs);
+
     vulkan_map_result(
         m_raw_device->get_device().device_wait_idle(), "`device_wait_idle` failed");
 }
 
-void VulkanDevice::gc() noexcept
+void VulkanDevice::gc(
+    core::Array<rhi::ResourceTracker::ReleasedResource> released_resources,
+    const u64 completed_epoch) noexcept
 {
     TNDR_PROFILER_TRACE("VulkanDevice::gc");
+
+    // Resources are released when their last reference is removed, e.g. when the user
+    // destroys them. Frames in flight hold no references, so a released resource waits
+    // until the last frame that used it finishes.
+    auto pending_resources = m_pending_resources.lock();
+    pending_resources->insert(
+        pending_resources->end(), released_resources.begin(), released_resources.end());
+
+    const auto destroy = [](auto& manager, const auto handle) {
+        [[maybe_unused]] const bool result = manager.destroy(handle);
+        tndr_assert(result, "`destroy` failed!");
+    };
+
+    core::Array<rhi::ResourceTracker::ReleasedResource> used_resources;
+    for (const rhi::ResourceTracker::ReleasedResource& released_resource :
+         *pending_resources) {
+        const auto& [resource, bindings] = released_resource;
+        if (this->get_last_used_epoch(resource) > completed_epoch) {
+            used_resources.push_back(released_resource);
+            continue;
+        }
+
+        switch (rhi::get_handle_type(resource)) {
+            case rhi::HandleType::Buffer:
+                m_managers.descriptor_bindless_manager->unbind_buffer(bindings);
+                destroy(*m_managers.buffer_manager, rhi::BufferHandleType(resource));
+                break;
+            case rhi::HandleType::Shader:
+                destroy(*m_managers.shader_manager, rhi::ShaderHandleType(resource));
+                break;
+            case rhi::HandleType::ComputePipeline:
+                destroy(
+                    *m_managers.compute_pipeline_manager,
+                    rhi::ComputePipelineHandleType(resource));
+                break;
+            case rhi::HandleType::GraphicsPipeline:
+                destroy(
+                    *m_managers.graphics_pipeline_manager,
+                    rhi::GraphicsPipelineHandleType(resource));
+                break;
+            case rhi::HandleType::Swapchain:
+                destroy(*m_managers.swapchain_manager, rhi::SwapchainHandleType(resource));
+                break;
+            case rhi::HandleType::Texture:
+                m_managers.descriptor_bindless_manager->unbind_texture(bindings);
+                destroy(*m_managers.texture_manager, rhi::TextureHandleType(resource));
+                break;
+            case rhi::HandleType::TextureView:
+                m_managers.descriptor_bindless_manager->unbind_texture_view(bindings);
+                destroy(
+                    *m_managers.texture_view_manager,
+                    rhi::TextureViewHandleType(resource));
+                break;
+            case rhi::HandleType::Sampler:
+                m_managers.descriptor_bindless_manager->unbind_sampler(bindings);
+                destroy(*m_managers.sampler_manager, rhi::SamplerHandleType(resource));
+                break;
+            case rhi::HandleType::RecordedBundle:
+                destroy(
+                    *m_managers.recorded_bundle_manager,
+                    rhi::RecordedBundleHandleType(resource));
+                break;
+        }
+    }
+
+    *pending_resources = core::move(used_resources);
+}
+
+u64 VulkanDevice::get_last_used_epoch(const u64 resource) const noexcept
+{
+    switch (rhi::get_handle_type(resource)) {
+        case rhi::HandleType::Buffer:
+            return m_managers.buffer_manager->get_last_used_epoch(
+                rhi::BufferHandleType(resource));
+        case rhi::HandleType::Shader:
+            return m_managers.shader_manager->get_last_used_epoch(
+                rhi::ShaderHandleType(resource));
+        case rhi::HandleType::ComputePipeline:
+            return m_managers.compute_pipeline_manager->get_last_used_epoch(
+                rhi::ComputePipelineHandleType(resource));
+        case rhi::HandleType::GraphicsPipeline:
+            return m_managers.graphics_pipeline_manager->get_last_used_epoch(
+                rhi::GraphicsPipelineHandleType(resource));
+        case rhi::HandleType::Swapchain:
+            return m_managers.swapchain_manager->get_last_used_epoch(
+                rhi::SwapchainHandleType(resource));
+        case rhi::HandleType::Texture:
+            return m_managers.texture_manager->get_last_used_epoch(
+                rhi::TextureHandleType(resource));
+        case rhi::HandleType::TextureView:
+            return m_managers.texture_view_manager->get_last_used_epoch(
+                rhi::TextureViewHandleType(resource));
+        case rhi::HandleType::Sampler:
+            return m_managers.sampler_manager->get_last_used_epoch(
+                rhi::SamplerHandleType(resource));
+        case rhi::HandleType::RecordedBundle:
+            return m_managers.recorded_bundle_manager->get_last_used_epoch(
+                rhi::RecordedBundleHandleType(resource));
+    }
+
+    core::panic("Invalid enum");
+}
+
+void VulkanDevice::submit_thread_loop() noexcept
+{
+    while (core::Option<SubmitJob> job = m_submit_jobs.pop()) {
+        this->execute(core::move(*job));
+    }
+}
+
+void VulkanDevice::execute(SubmitJob job) noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanDevice::execute");
+
+    m_submit_work_scheduler.begin_frame();
+    m_num_started_jobs.fetch_add(1, std::memory_order_release);
+    m_num_started_jobs.notify_all();
+
+    m_submit_work_scheduler.submit(
+        core::move(job.submit_infos), core::move(job.present_infos));
+    this->gc(
+        core::move(job.released_resources),
+        m_managers.command_buffer_manager->get_completed_epoch());
+
+    m_num_finished_jobs.fetch_add(1, std::memory_order_release);
+    m_num_finished_jobs.notify_all();
+}
+
+void VulkanDevice::wait_for_jobs(const std::atomic<u64>& num_jobs) const noexcept
+{
+    u64 value = num_jobs.load(std::memory_order_acquire);
+    while (value != m_num_submitted_jobs) {
+        num_jobs.wait(value, std::memory_order_acquire);
+        value = num_jobs.load(std::memory_order_acquire);
+    }
 }
 
 void VulkanDevice::submit(
     core::Array<rhi::SubmitInfo> submit_infos,
     core::Array<rhi::PresentInfo> present_infos) noexcept
 {
-    m_submit_work_scheduler.submit(core::move(submit_infos), core::move(present_infos));
-    this->gc();
+    TNDR_PROFILER_TRACE("VulkanDevice::submit");
+
+    // Resources released until now can't be used by this or later submits, so they
+    // are destroyed once the work submitted before finishes.
+    SubmitJob job {
+        .submit_infos = core::move(submit_infos),
+        .present_infos = core::move(present_infos),
+        .released_resources = m_managers.resource_tracker->take_released_resources(),
+    };
+    m_num_submitted_jobs += 1;
+
+    if (m_submit_thread.joinable()) {
+        m_submit_jobs.push(core::move(job));
+
+        // Waiting for the frame to begin keeps the back-pressure of
+        // `MAX_FRAMES_IN_FLIGHT` frames, and results of queries and finished frames
+        // the same as without the submit thread. Decoding, queue submits and presents
+        // overlap with the work of the caller.
+        this->wait_for_jobs(m_num_started_jobs);
+    } else {
+        this->execute(core::move(job));
+    }
+}
+
+rhi::SubmitStatistics VulkanDevice::get_submit_statistics() const noexcept
+{
+    return m_submit_work_scheduler.get_statistics();
+}
+
+u64 VulkanDevice::get_num_submits() const noexcept
+{
+    return m_num_submitted_jobs;
+}
+
+u64 VulkanDevice::get_num_completed_submits() const noexcept
+{
+    // Every submit is one frame, and the epoch of a frame is its number.
+    return m_managers.command_buffer_manager->get_completed_epoch();
+}
+
+void VulkanDevice::set_thread_pool(core::ThreadPool* thread_pool) noexcept
+{
+    m_submit_work_scheduler.set_thread_pool(thread_pool);
+}
+
+void VulkanDevice::set_async_submit(const bool is_enabled) noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanDevice::set_async_submit");
+
+    if (is_enabled == m_submit_thread.joinable()) {
+        return;
+    }
+
+    if (is_enabled) {
+        m_submit_thread = std::thread([this] { this->submit_thread_loop(); });
+    } else {
+        // Queued jobs are executed before the thread stops.
+        m_submit_jobs.push(std::nullopt);
+        m_submit_thread.join();
+    }
+}
+
+core::Array<core::Option<u64>> VulkanDevice::get_timestamps() const noexcept
+{
+    return m_managers.query_manager->get_timestamps();
+}
+
+core::Array<core::Option<rhi::PipelineStatistics>> VulkanDevice::get_pipeline_statistics()
+    const noexcept
+{
+    return m_managers.query_manager->get_pipeline_statistics();
 }
 
 rhi::SwapchainHandle VulkanDevice::create_swapchain(
@@ -222,11 +442,7 @@ rhi::SwapchainHandle VulkanDevice::create_swapchain(
     const rhi::SwapchainHandleType handle = m_managers.swapchain_manager->add(
         m_raw_device, create_info);
 
-    m_managers.resource_tracker->add_resource(
-        handle.get_id(), [swapchain_manager = m_managers.swapchain_manager, handle] {
-            const bool result = swapchain_manager->destroy(handle);
-            tndr_assert(result, "`swapchain_manager->destroy` failed!");
-        });
+    m_managers.resource_tracker->add_resource(handle.get_id());
 
     return rhi::SwapchainHandle { handle };
 }
@@ -234,6 +450,16 @@ rhi::SwapchainHandle VulkanDevice::create_swapchain(
 void VulkanDevice::destroy_swapchain(const rhi::SwapchainHandle handle) noexcept
 {
     m_managers.resource_tracker->remove_reference(handle.get_handle().get_id());
+
+    // A new swapchain for the same window can be created only after the old one
+    // is destroyed, so we wait for the last frame that used it, and destroy it
+    // without deferring it until the next submit.
+    this->wait_for_jobs(m_num_finished_jobs);
+    m_managers.command_buffer_manager->wait_for_epoch(
+        this->get_last_used_epoch(handle.get_handle().get_id()));
+    this->gc(
+        m_managers.resource_tracker->take_released_resources(),
+        m_managers.command_buffer_manager->get_completed_epoch());
 }
 
 rhi::BufferHandle VulkanDevice::create_buffer(
@@ -249,16 +475,7 @@ rhi::BufferHandle VulkanDevice::create_buffer(
 
     const rhi::BufferHandle buffer_handle { handle, bindings };
 
-    m_managers.resource_tracker->add_resource(
-        handle.get_id(),
-        [buffer_manager = m_managers.buffer_manager,
-         descriptor_bindless_manager = m_managers.descriptor_bindless_manager,
-         buffer_handle] {
-            descriptor_bindless_manager->unbind_buffer(buffer_handle.get_bindings());
-
-            const bool result = buffer_manager->destroy(buffer_handle.get_handle());
-            tndr_assert(result, "`buffer_manager->destroy` failed!");
-        });
+    m_managers.resource_tracker->add_resource(handle.get_id(), bindings);
 
     return buffer_handle;
 }
@@ -276,6 +493,27 @@ void VulkanDevice::update_buffer(
     tndr_assert(is_valid, "`handle` is not valid!");
 }
 
+core::Array<char> VulkanDevice::read_buffer(
+    const rhi::BufferHandle handle, const rhi::BufferSubresourceRange& range) noexcept
+{
+    auto data = m_managers.buffer_manager->with(
+        handle.get_handle(),
+        [&](const VulkanBuffer& buffer) { return buffer.read_buffer(range); });
+    tndr_assert(data.has_value(), "`handle` is not valid!");
+
+    return core::move(*data);
+}
+
+core::Span<char> VulkanDevice::map_buffer(const rhi::BufferHandle handle) noexcept
+{
+    const auto memory = m_managers.buffer_manager->with(
+        handle.get_handle(),
+        [](const VulkanBuffer& buffer) { return buffer.get_mapped_memory(); });
+    tndr_assert(memory.has_value(), "`handle` is not valid!");
+
+    return *memory;
+}
+
 void VulkanDevice::destroy_buffer(const rhi::BufferHandle handle) noexcept
 {
     m_managers.resource_tracker->remove_reference(handle.get_handle().get_id());
@@ -294,16 +532,7 @@ rhi::TextureHandle VulkanDevice::create_texture(
 
     const rhi::TextureHandle texture_handle { handle, bindings };
 
-    m_managers.resource_tracker->add_resource(
-        handle.get_id(),
-        [texture_manager = m_managers.texture_manager,
-         descriptor_bindless_manager = m_managers.descriptor_bindless_manager,
-         texture_handle] {
-            descriptor_bindless_manager->unbind_texture(texture_handle.get_bindings());
-
-            const bool result = texture_manager->destroy(texture_handle.get_handle());
-            tndr_assert(result, "`texture_manager->destroy` failed!");
-        });
+    m_managers.resource_tracker->add_resource(handle.get_id(), bindings);
 
     return texture_handle;
 }
@@ -326,18 +555,7 @@ rhi::TextureViewHandle VulkanDevice::create_texture_view(
 
     const rhi::TextureViewHandle texture_view_handle { handle, bindings };
 
-    m_managers.resource_tracker->add_resource(
-        handle.get_id(),
-        [texture_view_manager = m_managers.texture_view_manager,
-         descriptor_bindless_manager = m_managers.descriptor_bindless_manager,
-         texture_view_handle] {
-            descriptor_bindless_manager->unbind_texture_view(
-                texture_view_handle.get_bindings());
-
-            const bool result = texture_view_manager->destroy(
-                texture_view_handle.get_handle());
-            tndr_assert(result, "`texture_view_manager->destroy` failed!");
-        });
+    m_managers.resource_tracker->add_resource(handle.get_id(), bindings);
 
     return texture_view_handle;
 }
@@ -353,11 +571,7 @@ rhi::ShaderHandle VulkanDevice::create_shader(
     const rhi::ShaderHandleType handle = m_managers.shader_manager->add(
         m_raw_device, create_info);
 
-    m_managers.resource_tracker->add_resource(
-        handle.get_id(), [shader_manager = m_managers.shader_manager, handle] {
-            const bool result = shader_manager->destroy(handle);
-            tndr_assert(result, "`shader_manager->destroy` failed!");
-        });
+    m_managers.resource_tracker->add_resource(handle.get_id());
 
     return rhi::ShaderHandle { handle };
 }
@@ -373,12 +587,7 @@ rhi::GraphicsPipelineHandle VulkanDevice::create_graphics_pipeline(
     const rhi::GraphicsPipelineHandleType handle =
         m_managers.graphics_pipeline_manager->add(m_raw_device, m_managers, create_info);
 
-    m_managers.resource_tracker->add_resource(
-        handle.get_id(),
-        [graphics_pipeline_manager = m_managers.graphics_pipeline_manager, handle] {
-            const bool result = graphics_pipeline_manager->destroy(handle);
-            tndr_assert(result, "`graphics_pipeline_manager->destroy` failed!");
-        });
+    m_managers.resource_tracker->add_resource(handle.get_id());
 
     return rhi::GraphicsPipelineHandle { handle };
 }
@@ -395,12 +604,7 @@ rhi::ComputePipelineHandle VulkanDevice::create_compute_pipeline(
     const rhi::ComputePipelineHandleType handle = m_managers.compute_pipeline_manager->add(
         m_raw_device, m_managers, create_info);
 
-    m_managers.resource_tracker->add_resource(
-        handle.get_id(),
-        [compute_pipeline_manager = m_managers.compute_pipeline_manager, handle] {
-            const bool result = compute_pipeline_manager->destroy(handle);
-            tndr_assert(result, "`compute_pipeline_manager->destroy` failed!");
-        });
+    m_managers.resource_tracker->add_resource(handle.get_id());
 
     return rhi::ComputePipelineHandle { handle };
 }
@@ -424,16 +628,7 @@ rhi::SamplerHandle VulkanDevice::create_sampler(
 
     const rhi::SamplerHandle sampler_handle { handle, bindings };
 
-    m_managers.resource_tracker->add_resource(
-        handle.get_id(),
-        [sampler_manager = m_managers.sampler_manager,
-         descriptor_bindless_manager = m_managers.descriptor_bindless_manager,
-         sampler_handle] {
-            descriptor_bindless_manager->unbind_sampler(sampler_handle.get_bindings());
-
-            const bool result = sampler_manager->destroy(sampler_handle.get_handle());
-            tndr_assert(result, "`sampler_manager->destroy` failed!");
-        });
+    m_managers.resource_tracker->add_resource(handle.get_id(), bindings);
 
     return sampler_handle;
 }
@@ -443,6 +638,23 @@ void VulkanDevice::destroy_sampler(const rhi::SamplerHandle handle) noexcept
     m_managers.resource_tracker->remove_reference(handle.get_handle().get_id());
 }
 
+rhi::RecordedBundleHandle VulkanDevice::create_recorded_bundle(
+    const rhi::RecordedBundleCreateInfo& create_info) noexcept
+{
+    const rhi::RecordedBundleHandleType handle = m_managers.recorded_bundle_manager->add(
+        m_raw_device, m_managers, create_info);
+
+    m_managers.resource_tracker->add_resource(handle.get_id());
+
+    return rhi::RecordedBundleHandle { handle };
+}
+
+void VulkanDevice::destroy_recorded_bundle(
+    const rhi::RecordedBundleHandle handle) noexcept
+{
+    m_managers.resource_tracker->remove_reference(handle.get_handle().get_id());
+}
+
 core::SharedPtr<VulkanInstance> VulkanDevice::get_instance() const noexcept
 {
     return m_instance;
@@ -1,15 +1,22 @@
 #pragma once
 #include "core/core.h"
 #include "commands/vulkan_submit_work_scheduler.h"
+#include "core/std/containers/array.h"
 #include "core/std/option.h"
 #include "core/std/shared_ptr.h"
+#include "core/std/sync/lock.h"
+#include "core/std/sync/spsc_queue.h"
 #include "core/std/tuple.h"
 #include "loader/device.h"
 #include "loader/extensions/khr/surface.h"
 #include "loader/extensions/khr/swapchain.h"
 #include "managers/managers.h"
 #include "rhi/resources/handle.h"
+#include "rhi/resources/recorded_bundle.h"
+#include "rhi/resources/resource_tracker.h"
 #include "vulkan_context.h"
+#include <atomic>
+#include <thread>
 
 namespace tundra::rhi {
 struct SwapchainCreateInfo;
@@ -30,6 +37,11 @@ class VulkanDevice;
 
 struct DeviceLimits {
     f32 max_sampler_anisotropy = 0.f;
+    /// Nanoseconds per timestamp tick.
+    f32 timestamp_period = 0.f;
+    /// Bits of a timestamp that hold the time on every queue that writes timestamps.
+    /// The rest of the bits are undefined and must be masked out.
+    u64 timestamp_valid_mask = 0;
 };
 
 struct VulkanQueues {
@@ -101,12 +113,33 @@ private:
 
 ///
 class VulkanDevice : public core::EnableSharedFromThis<VulkanDevice> {
+private:
+    /// Work of a `submit` call.
+    struct SubmitJob {
+        core::Array<rhi::SubmitInfo> submit_infos;
+        core::Array<rhi::PresentInfo> present_infos;
+        /// Resources released before the `submit` call.
+        core::Array<rhi::ResourceTracker::ReleasedResource> released_resources;
+    };
+
 private:
     core::SharedPtr<VulkanInstance> m_instance;
     core::SharedPtr<VulkanRawDevice> m_raw_device;
     core::SharedPtr<VulkanAllocator> m_allocator;
     Managers m_managers;
     VulkanSubmitWorkScheduler m_submit_work_scheduler;
+    /// Released resources that may still be used by frames in flight.
+    core::Lock<core::Array<rhi::ResourceTracker::ReleasedResource>> m_pending_resources;
+
+    /// See `set_async_submit`. `None` stops the submit thread.
+    core::SpscQueue<core::Option<SubmitJob>, rhi::config::MAX_FRAMES_IN_FLIGHT>
+        m_submit_jobs;
+    std::thread m_submit_thread;
+    /// Jobs passed to `execute`, written by the thread calling `submit`.
+    u64 m_num_submitted_jobs = 0;
+    /// Jobs whose frame has begun (see `VulkanSubmitWorkScheduler::begin_frame`).
+    std::atomic<u64> m_num_started_jobs = 0;
+    std::atomic<u64> m_num_finished_jobs = 0;
 
 public:
     VulkanDevice(
@@ -124,12 +157,31 @@ public:
     void wait_until_idle() const noexcept;
 
 private:
-    void gc() noexcept;
+    /// Destroys `released_resources`, and resources released by earlier calls, that
+    /// are not used by frames after `completed_epoch`.
+    void gc(
+        core::Array<rhi::ResourceTracker::ReleasedResource> released_resources,
+        const u64 completed_epoch) noexcept;
+    [[nodiscard]] u64 get_last_used_epoch(const u64 resource) const noexcept;
+
+    /// Executes jobs on the submit thread, until it pops `None`.
+    void submit_thread_loop() noexcept;
+    void execute(SubmitJob job) noexcept;
+    /// Waits until `num_jobs` counts all submitted jobs.
+    void wait_for_jobs(const std::atomic<u64>& num_jobs) const noexcept;
 
 public:
     void submit(
         core::Array<rhi::SubmitInfo> submit_infos,
         core::Array<rhi::PresentInfo> present_infos) noexcept;
+    [[nodiscard]] rhi::SubmitStatistics get_submit_statistics() const noexcept;
+    [[nodiscard]] u64 get_num_submits() const noexcept;
+    [[nodiscard]] u64 get_num_completed_submits() const noexcept;
+    void set_thread_pool(core::ThreadPool* thread_pool) noexcept;
+    void set_async_submit(const bool is_enabled) noexcept;
+    [[nodiscard]] core::Array<core::Option<u64>> get_timestamps() const noexcept;
+    [[nodiscard]] core::Array<core::Option<rhi::PipelineStatistics>>
+        get_pipeline_statistics() const noexcept;
 
     [[nodiscard]] rhi::SwapchainHandle create_swapchain(
         const rhi::SwapchainCreateInfo& create_info) noexcept;
@@ -140,6 +192,10 @@ public:
     void update_buffer(
         const rhi::BufferHandle handle,
         const core::Array<rhi::BufferUpdateRegion>& update_regions) noexcept;
+    [[nodiscard]] core::Array<char> read_buffer(
+        const rhi::BufferHandle handle,
+        const rhi::BufferSubresourceRange& range) noexcept;
+    [[nodiscard]] core::Span<char> map_buffer(const rhi::BufferHandle handle) noexcept;
     void destroy_buffer(const rhi::BufferHandle handle) noexcept;
 
     [[nodiscard]] rhi::TextureHandle create_texture(
@@ -166,6 +222,10 @@ public:
         const rhi::SamplerCreateInfo& create_info) noexcept;
     void destroy_sampler(const rhi::SamplerHandle handle) noexcept;
 
+    [[nodiscard]] rhi::RecordedBundleHandle create_recorded_bundle(
+        const rhi::RecordedBundleCreateInfo& create_info) noexcept;
+    void destroy_recorded_bundle(const rhi::RecordedBundleHandle handle) noexcept;
+
 public:
     [[nodiscard]] core::SharedPtr<VulkanInstance> get_instance() const noexcept;
     [[nodiscard]] const loader::Device& get_device() const noexcept;
@@ -1121,6 +1121,13 @@ AccessInfo get_access_info(
                 .image_layout = VK_IMAGE_LAYOUT_UNDEFINED,
             };
         }
+        case rhi::BufferAccessFlags::HOST_READ: {
+            return AccessInfo {
+                .access_flags = VK_ACCESS_2_HOST_READ_BIT,
+                .stage_flags = VK_PIPELINE_STAGE_2_HOST_BIT,
+                .image_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+            };
+        }
         default: {
             core::unreachable();
         }
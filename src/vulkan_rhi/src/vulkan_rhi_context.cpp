@@ -35,6 +35,42 @@ void VulkanRHIContext::submit(
         core::move(submit_infos), core::move(present_infos));
 }
 
+rhi::SubmitStatistics VulkanRHIContext::get_submit_statistics() const noexcept
+{
+    return m_vulkan_context.get_device()->get_submit_statistics();
+}
+
+u64 VulkanRHIContext::get_num_submits() const noexcept
+{
+    return m_vulkan_context.get_device()->get_num_submits();
+}
+
+u64 VulkanRHIContext::get_num_completed_submits() const noexcept
+{
+    return m_vulkan_context.get_device()->get_num_completed_submits();
+}
+
+void VulkanRHIContext::set_thread_pool(core::ThreadPool* thread_pool) noexcept
+{
+    m_vulkan_context.get_device()->set_thread_pool(thread_pool);
+}
+
+void VulkanRHIContext::set_async_submit(const bool is_enabled) noexcept
+{
+    m_vulkan_context.get_device()->set_async_submit(is_enabled);
+}
+
+core::Array<core::Option<u64>> VulkanRHIContext::get_timestamps() const noexcept
+{
+    return m_vulkan_context.get_device()->get_timestamps();
+}
+
+core::Array<core::Option<rhi::PipelineStatistics>> VulkanRHIContext::
+    get_pipeline_statistics() const noexcept
+{
+    return m_vulkan_context.get_device()->get_pipeline_statistics();
+}
+
 rhi::SwapchainHandle VulkanRHIContext::create_swapchain(
     const rhi::SwapchainCreateInfo& create_info) noexcept
 {
@@ -67,6 +103,21 @@ void VulkanRHIContext::update_buffer(
     m_vulkan_context.get_device()->update_buffer(handle, update_regions);
 }
 
+core::Array<char> VulkanRHIContext::read_buffer(
+    const rhi::BufferHandle handle, const rhi::BufferSubresourceRange& range) noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanRHIContext::read_buffer");
+
+    return m_vulkan_context.get_device()->read_buffer(handle, range);
+}
+
+core::Span<char> VulkanRHIContext::map_buffer(const rhi::BufferHandle handle) noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanRHIContext::map_buffer");
+
+    return m_vulkan_context.get_device()->map_buffer(handle);
+}
+
 void VulkanRHIContext::destroy_buffer(const rhi::BufferHandle handle) noexcept
 {
     TNDR_PROFILER_TRACE("VulkanRHIContext::destroy_buffer");
@@ -166,4 +217,20 @@ void VulkanRHIContext::destroy_sampler(const rhi::SamplerHandle handle) noexcept
     m_vulkan_context.get_device()->destroy_sampler(handle);
 }
 
+rhi::RecordedBundleHandle VulkanRHIContext::create_recorded_bundle(
+    const rhi::RecordedBundleCreateInfo& create_info) noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanRHIContext::create_recorded_bundle");
+
+    return m_vulkan_context.get_device()->create_recorded_bundle(create_info);
+}
+
+void VulkanRHIContext::destroy_recorded_bundle(
+    const rhi::RecordedBundleHandle handle) noexcept
+{
+    TNDR_PROFILER_TRACE("VulkanRHIContext::destroy_recorded_bundle");
+
+    m_vulkan_context.get_device()->destroy_recorded_bundle(handle);
+}
+
 } // namespace tundra::vulkan_rhi
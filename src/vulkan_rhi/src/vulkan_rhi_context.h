@@ -18,6 +18,16 @@ public:
     virtual void submit(
         core::Array<rhi::SubmitInfo> submit_infos,
         core::Array<rhi::PresentInfo> present_infos) noexcept final;
+    [[nodiscard]] virtual rhi::SubmitStatistics get_submit_statistics()
+        const noexcept final;
+    [[nodiscard]] virtual u64 get_num_submits() const noexcept final;
+    [[nodiscard]] virtual u64 get_num_completed_submits() const noexcept final;
+    virtual void set_thread_pool(core::ThreadPool* thread_pool) noexcept final;
+    virtual void set_async_submit(const bool is_enabled) noexcept final;
+    [[nodiscard]] virtual core::Array<core::Option<u64>> get_timestamps()
+        const noexcept final;
+    [[nodiscard]] virtual core::Array<core::Option<rhi::PipelineStatistics>>
+        get_pipeline_statistics() const noexcept final;
 
 public:
     [[nodiscard]] virtual rhi::SwapchainHandle create_swapchain(
@@ -29,6 +39,11 @@ public:
     virtual void update_buffer(
         const rhi::BufferHandle handle,
         const core::Array<rhi::BufferUpdateRegion>& update_regions) noexcept final;
+    [[nodiscard]] virtual core::Array<char> read_buffer(
+        const rhi::BufferHandle handle,
+        const rhi::BufferSubresourceRange& range) noexcept final;
+    [[nodiscard]] virtual core::Span<char> map_buffer(
+        const rhi::BufferHandle handle) noexcept final;
     virtual void destroy_buffer(const rhi::BufferHandle handle) noexcept final;
 
     [[nodiscard]] virtual rhi::TextureHandle create_texture(
@@ -56,6 +71,11 @@ public:
     [[nodiscard]] virtual rhi::SamplerHandle create_sampler(
         const rhi::SamplerCreateInfo& create_info) noexcept final;
     virtual void destroy_sampler(const rhi::SamplerHandle handle) noexcept final;
+
+    [[nodiscard]] virtual rhi::RecordedBundleHandle create_recorded_bundle(
+        const rhi::RecordedBundleCreateInfo& create_info) noexcept final;
+    virtual void destroy_recorded_bundle(
+        const rhi::RecordedBundleHandle handle) noexcept final;
 };
 
 } // namespace tundra::vulkan_rhi
@@ -65,6 +65,7 @@ void App::loop() noexcept
 {
     core::Timer timer;
     while (!glfwWindowShouldClose(m_window)) {
+        TNDR_PROFILER_NEW_FRAME(m_frame_counter);
         TNDR_PROFILER_TRACE("App::loop::tick");
 
         glfwPollEvents();
@@ -1,6 +1,7 @@
 #include "app.h"
 #include "core/logger.h"
 #include "core/module/module_manager.h"
+#include "core/profiler.h"
 #include "core/std/containers/hash_map.h"
 #include "core/std/defer.h"
 #include "core/std/option.h"
@@ -9,25 +10,28 @@
 #include "core/std/utils.h"
 #include "core/std/variant.h"
 #include "core/typedefs.h"
+#include "core/utils/thread_pool.h"
 #include "fmt/core.h"
 #include "globals/globals.h"
 #include "math/quat.h"
 #include "math/transform.h"
 #include "math/vector3.h"
 #include "meshlet_mesh.h"
+#include "meshlet_scene.h"
 #include "pipelines.h"
+#include "renderer/config.h"
 #include "renderer/frame_graph/frame_graph.h"
 #include "renderer/renderer.h"
 #include "rhi/config.h"
 #include "rhi/rhi_context.h"
 #include "rhi/rhi_module.h"
+#include "rhi/upload_service.h"
 #include "rhi/validation_layers.h"
 #include "shader.h"
 #include <cxxopts.hpp>
 #include <filesystem>
 #include <fstream>
 #include <ios>
-#include <random>
 #include <thread>
 
 #include <GLFW/glfw3.h>
@@ -37,15 +41,16 @@ namespace tundra {
 ///
 class MeshletApp : public App {
 private:
-    static constexpr usize NUM_INSTANCES = 1;
-
-private:
+    core::ThreadPool m_thread_pool;
     renderer::frame_graph::FrameGraph m_frame_graph;
+    rhi::UploadService m_upload_service;
     renderer::RendererType m_renderer_type = renderer::RendererType::Software;
 
 private:
     rhi::BufferHandle m_mesh_descriptors_buffer;
-    rhi::BufferHandle m_mesh_data_buffer;
+    core::Array<rhi::BufferHandle> m_mesh_data_buffers;
+    /// The scene is rendered once uploads of all meshes are complete.
+    rhi::UploadTicket m_scene_upload_ticket = 0;
 
     core::Array<renderer::MeshInstance> m_mesh_instances;
     core::Array<renderer::MeshDescriptor> m_mesh_descriptors;
@@ -64,79 +69,24 @@ private:
 public:
     MeshletApp() noexcept
         : m_frame_graph(globals::g_rhi_context)
+        , m_upload_service(globals::g_rhi_context)
     {
-        m_mesh_descriptors_buffer = globals::g_rhi_context->create_buffer(
-            rhi::BufferCreateInfo {
-                .usage = rhi::BufferUsageFlags::STORAGE_BUFFER,
-                .memory_type = rhi::MemoryType::Dynamic,
-                .size = sizeof(shader::MeshDescriptor),
-                .name = "mesh_descriptors_buffer",
-            });
-
-        for (rhi::BufferHandle& buffer : m_gpu_instance_transforms_buffer) {
-            buffer = globals::g_rhi_context->create_buffer(rhi::BufferCreateInfo {
-                .usage = rhi::BufferUsageFlags::STORAGE_BUFFER,
-                .memory_type = rhi::MemoryType::Dynamic,
-                .size = NUM_INSTANCES * sizeof(shader::InstanceTransform),
-                .name = "gpu_instance_transforms",
-            });
-        }
-
-        for (usize i = 0; i < rhi::config::MAX_FRAMES_IN_FLIGHT; ++i) {
-            rhi::BufferHandle& buffer = m_mesh_instances_buffer[i];
-            buffer = globals::g_rhi_context->create_buffer(rhi::BufferCreateInfo {
-                .usage = rhi::BufferUsageFlags::STORAGE_BUFFER,
-                .memory_type = rhi::MemoryType::Dynamic,
-                .size = NUM_INSTANCES * sizeof(shader::MeshInstance),
-                .name = fmt::format("mesh_instances: {}", i),
-            });
-
-            core::Array<shader::MeshInstance> mesh_instances(
-                NUM_INSTANCES,
-                shader::MeshInstance {
-                    .mesh_descriptor_index = 0,
-                });
-
-            globals::g_rhi_context->update_buffer(
-                buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(mesh_instances),
-                        .dst_offset = 0,
-                    },
-                });
-        }
-
-        std::mt19937 gen { 0 }; // NOLINT(cert-msc32-c, cert-msc51-cpp)
-        std::uniform_real_distribution<f32> dist { 0, 1 };
-        const f32 scene_radius = 4.f;
-        for (usize i = 0; i < NUM_INSTANCES; ++i) {
-            math::Transform transform = math::Transform::IDENTITY;
-            // transform.position = math::Vec3 {
-            //     dist(gen) * scene_radius * 2 - scene_radius,
-            //     dist(gen) * scene_radius * 2 - scene_radius,
-            //     dist(gen) * scene_radius * 2 - scene_radius,
-            // };
-
-            transform.scale = 1.f;
-            // transform.rotation = math::Quat::from_angle(
-            //     math::to_radians(math::Vec3 { 0.f, 90.f, 0.f }));
-
-            m_instances_transforms.push_back(transform);
-            m_mesh_instances.push_back(renderer::MeshInstance {
-                .mesh_descriptor_index = 0,
-            });
-        }
+        globals::g_rhi_context->set_thread_pool(&m_thread_pool);
+        m_frame_graph.set_thread_pool(&m_thread_pool);
+        m_frame_graph.set_upload_service(&m_upload_service);
 
         m_camera.translate({ -2.6f, 1.8f, 2.7f });
         // m_camera.translate(math::Vec3 { 0, 1, -8 });
 
-        this->upload_mesh();
+        this->upload_scene();
         this->create_pipelines();
     }
 
     ~MeshletApp() override
     {
+        // The thread pool is destroyed before the RHI context.
+        globals::g_rhi_context->set_thread_pool(nullptr);
+
         for (const auto& [_, pipeline] : m_compute_pipelines) {
             globals::g_rhi_context->destroy_compute_pipeline(pipeline);
         }
@@ -168,189 +118,174 @@ protected:
                 }
                 break;
             }
+            case GLFW_KEY_F2: {
+                if (action == GLFW_PRESS) {
+                    const char* path = "tundra_trace.json";
+                    if (core::profiler::export_chrome_trace(path)) {
+                        tndr_info("Profiler trace written to `{}`.", path);
+                    } else {
+                        tndr_warn("Failed to write profiler trace to `{}`.", path);
+                    }
+                }
+                break;
+            }
+            case GLFW_KEY_F3: {
+                if (action == GLFW_PRESS) {
+                    for (const renderer::frame_graph::PassTiming& timing :
+                         m_frame_graph.get_pass_timings()) {
+                        tndr_info(
+                            "Pass `{}`: {:.3f} ms.",
+                            timing.name,
+                            static_cast<f64>(timing.duration) / 1'000'000.0);
+                    }
+                }
+                break;
+            }
             default:
                 break;
         }
     }
 
 private:
-    void upload_mesh() noexcept
+    void upload_scene() noexcept
     {
-        MeshletMesh::import("assets/monkey.glb", "assets/monkey.meshlet_mesh");
-        MeshletMesh meshlet_mesh = MeshletMesh::load("assets/monkey.meshlet_mesh");
-
-        core::Array<u32> meshlet_triangles(meshlet_mesh.meshlet_triangles.size());
-        for (usize i = 0; i < meshlet_triangles.size(); ++i) {
-            meshlet_triangles[i] = static_cast<u32>(meshlet_mesh.meshlet_triangles[i]);
-        }
-
-        core::Array<shader::Meshlet> meshlets;
-        meshlets.reserve(meshlet_mesh.meshlets.size());
-        for (const MeshletMesh::Meshlet& meshlet : meshlet_mesh.meshlets) {
-            meshlets.push_back(shader::Meshlet {
-                .center = meshlet.center,
-                .radius = meshlet.radius,
-                .cone_apex = meshlet.cone_apex,
-                .cone_axis_and_cutoff = meshlet.cone_axis_and_cutoff,
-                .triangle_offset = meshlet.triangle_offset,
-                .triangle_count = meshlet.triangle_count,
-                .vertex_offset = meshlet.vertex_offset,
-                .vertex_count = meshlet.vertex_count,
-            });
-        }
-
-        core::Array<math::Vec2> flattened_uvs;
-        for (const core::Array<math::Vec2>& uv : meshlet_mesh.uvs) {
-            flattened_uvs.insert(flattened_uvs.end(), uv.begin(), uv.end());
+        const core::String scene_path = "assets/monkey.meshlet_scene";
+        MeshletScene::import(
+            "assets/monkey.glb",
+            scene_path,
+            m_thread_pool,
+            MeshletMesh::ImportSettings {});
+        const MeshletScene scene = MeshletScene::load(scene_path);
+        const core::Span<const MeshletScene::Mesh> meshes = scene.get_meshes();
+        const core::Span<const MeshletScene::Instance> instances = scene.get_instances();
+
+        // Buffers can't be empty, and a scene without instances has nothing to render.
+        if (instances.is_empty()) {
+            tndr_warn("`{}` has no instances to render.", scene_path);
+            return;
         }
 
-        u64 total_size = 0;
-
-        const u64 meshlets_size_bytes = sizeof(shader::Meshlet) *
-                                        meshlet_mesh.meshlets.size();
-        total_size += meshlets_size_bytes;
-
-        const u64 meshlet_triangles_offset = total_size;
-        const u64 meshlet_triangles_size_bytes = sizeof(u32) * meshlet_triangles.size();
-        total_size += meshlet_triangles_size_bytes;
-
-        const u64 meshlet_vertices_offset = total_size;
-        const u64 meshlet_vertices_size_bytes = sizeof(u32) *
-                                                meshlet_mesh.meshlet_vertices.size();
-        total_size += meshlet_vertices_size_bytes;
-
-        const u64 vertices_offset = total_size;
-        const u64 vertices_size_bytes = meshlet_mesh.vertices.size() * sizeof(math::Vec3);
-        total_size += vertices_size_bytes;
+        core::Array<shader::MeshDescriptor> gpu_mesh_descriptors;
+        gpu_mesh_descriptors.reserve(meshes.size());
+
+        for (usize i = 0; i < meshes.size(); ++i) {
+            const MeshletMesh::Header& header = meshes[i].header;
+            const core::Span<const char> mesh_data = scene.get_mesh_data(i);
+
+            // Meshes without triangles have no data, and no instances reference them.
+            rhi::BufferHandle mesh_data_buffer;
+            if (!mesh_data.is_empty()) {
+                mesh_data_buffer = globals::g_rhi_context->create_buffer(
+                    rhi::BufferCreateInfo {
+                        .usage = rhi::BufferUsageFlags::STORAGE_BUFFER |
+                                 rhi::BufferUsageFlags::TRANSFER_DESTINATION,
+                        .memory_type = rhi::MemoryType::GPU,
+                        .size = mesh_data.size(),
+                        .name = fmt::format("mesh_data_buffer: {}", i),
+                    });
+                m_mesh_data_buffers.push_back(mesh_data_buffer);
+
+                // The mesh data already has the layout of the buffer, so it is copied
+                // straight from the mapped file.
+                m_scene_upload_ticket = m_upload_service.upload_buffer(
+                    mesh_data_buffer,
+                    0,
+                    mesh_data,
+                    rhi::BufferAccessFlags::COMPUTE_STORAGE_BUFFER_READ |
+                        rhi::BufferAccessFlags::GRAPHICS_STORAGE_BUFFER_READ);
+            }
 
-        const u64 normals_size_bytes = meshlet_mesh.normals.size() * sizeof(math::Vec3);
-        total_size += normals_size_bytes;
+            const auto get_offset = [&](const MeshletMesh::Section section) {
+                const usize index = static_cast<usize>(section);
+                return static_cast<u32>(header.sections[index].offset);
+            };
 
-        const u64 tangents_size_bytes = meshlet_mesh.tangents.size() * sizeof(math::Vec4);
-        total_size += tangents_size_bytes;
+            gpu_mesh_descriptors.push_back(shader::MeshDescriptor {
+                .center = header.center,
+                .radius = header.radius,
+                .mesh_data_buffer_srv = mesh_data_buffer.is_valid()
+                                            ? mesh_data_buffer.get_srv()
+                                            : renderer::config::INVALID_SHADER_HANDLE,
+                .meshlet_count = header.meshlet_count,
+                .meshlet_triangles_offset = get_offset(
+                    MeshletMesh::Section::MeshletTriangles),
+                .meshlet_triangles_count = header.meshlet_triangles_count,
+                .meshlet_vertices_offset = get_offset(
+                    MeshletMesh::Section::MeshletVertices),
+                .meshlet_vertices_count = header.meshlet_vertices_count,
+                .vertex_buffer_offset = get_offset(MeshletMesh::Section::VertexBuffer),
+                .vertex_count = header.vertex_count,
+                .vertex_buffer_layout = header.vertex_buffer_layout,
+            });
 
-        for (const core::Array<math::Vec2>& uv : meshlet_mesh.uvs) {
-            total_size += (uv.size() * sizeof(math::Vec2));
+            m_mesh_descriptors.push_back(renderer::MeshDescriptor {
+                .center = header.center,
+                .radius = header.radius,
+                .meshlet_count = header.meshlet_count,
+                .meshlet_triangles_count = header.meshlet_triangles_count,
+                .meshlet_vertices_count = header.meshlet_vertices_count,
+                .vertex_count = header.vertex_count,
+                .vertex_buffer_layout = header.vertex_buffer_layout,
+            });
         }
 
-        m_mesh_data_buffer = globals::g_rhi_context->create_buffer(rhi::BufferCreateInfo {
-            .usage = rhi::BufferUsageFlags::STORAGE_BUFFER,
-            .memory_type = rhi::MemoryType::Dynamic,
-            .size = total_size,
-            .name = "mesh_data_buffer",
-        });
-
-        core::Array<rhi::BufferUpdateRegion> update_regions;
-        update_regions.push_back(rhi::BufferUpdateRegion {
-            .src = core::as_byte_span(meshlets),
-            .dst_offset = 0,
-        });
-        update_regions.push_back(rhi::BufferUpdateRegion {
-            .src = core::as_byte_span(meshlet_triangles),
-            .dst_offset = meshlet_triangles_offset,
-        });
-        update_regions.push_back(rhi::BufferUpdateRegion {
-            .src = core::as_byte_span(meshlet_mesh.meshlet_vertices),
-            .dst_offset = meshlet_vertices_offset,
-        });
-        u64 offset = vertices_offset;
-        update_regions.push_back(rhi::BufferUpdateRegion {
-            .src = core::as_byte_span(meshlet_mesh.vertices),
-            .dst_offset = offset,
-        });
-        offset += core::as_byte_span(meshlet_mesh.vertices).size();
-
-        update_regions.push_back(rhi::BufferUpdateRegion {
-            .src = core::as_byte_span(meshlet_mesh.normals),
-            .dst_offset = offset,
-        });
-        offset += core::as_byte_span(meshlet_mesh.normals).size();
-
-        update_regions.push_back(rhi::BufferUpdateRegion {
-            .src = core::as_byte_span(meshlet_mesh.tangents),
-            .dst_offset = offset,
-        });
-        offset += core::as_byte_span(meshlet_mesh.tangents).size();
-
-        update_regions.push_back(rhi::BufferUpdateRegion {
-            .src = core::as_byte_span(flattened_uvs),
-            .dst_offset = offset,
-        });
-
-        globals::g_rhi_context->update_buffer(m_mesh_data_buffer, update_regions);
-
-        const shader::MeshDescriptor mesh_descriptor = [&] {
-            shader::VertexBufferLayout layout = shader::VertexBufferLayout::NONE;
-            if (!meshlet_mesh.vertices.empty()) {
-                layout |= shader::VertexBufferLayout::POSITIONS;
-            }
-            if (!meshlet_mesh.normals.empty()) {
-                layout |= shader::VertexBufferLayout::NORMALS;
-            }
-            if (!meshlet_mesh.tangents.empty()) {
-                layout |= shader::VertexBufferLayout::TANGENTS;
-            }
-
-            switch (meshlet_mesh.uvs.size()) {
-                case 0: {
-                    break;
-                }
-                case 1: {
-                    layout |= shader::VertexBufferLayout::UV0;
-                    break;
-                }
-                case 2: {
-                    layout |= shader::VertexBufferLayout::UV0 |
-                              shader::VertexBufferLayout::UV1;
-                    break;
-                }
-                case 3: {
-                    layout |= shader::VertexBufferLayout::UV0 |
-                              shader::VertexBufferLayout::UV1 |
-                              shader::VertexBufferLayout::UV2;
-                    break;
-                }
-                default: {
-                    core::unreachable();
-                    break;
-                }
-            }
-
-            return shader::MeshDescriptor {
-                .center = meshlet_mesh.center,
-                .radius = meshlet_mesh.radius,
-                .mesh_data_buffer_srv = m_mesh_data_buffer.get_srv(),
-                .meshlet_count = static_cast<u32>(meshlet_mesh.meshlets.size()),
-                .meshlet_triangles_offset = static_cast<u32>(meshlet_triangles_offset),
-                .meshlet_triangles_count = static_cast<u32>(meshlet_triangles.size()),
-                .meshlet_vertices_offset = static_cast<u32>(meshlet_vertices_offset),
-                .meshlet_vertices_count = static_cast<u32>(
-                    meshlet_mesh.meshlet_vertices.size()),
-                .vertex_buffer_offset = static_cast<u32>(vertices_offset),
-                .vertex_count = static_cast<u32>(meshlet_mesh.vertices.size()),
-                .vertex_buffer_layout = layout,
-            };
-        }();
+        m_mesh_descriptors_buffer = globals::g_rhi_context->create_buffer(
+            rhi::BufferCreateInfo {
+                .usage = rhi::BufferUsageFlags::STORAGE_BUFFER,
+                .memory_type = rhi::MemoryType::Dynamic,
+                .size = meshes.size() * sizeof(shader::MeshDescriptor),
+                .name = "mesh_descriptors_buffer",
+            });
 
         globals::g_rhi_context->update_buffer(
             m_mesh_descriptors_buffer,
             {
                 rhi::BufferUpdateRegion {
-                    .src = core::as_byte_span(mesh_descriptor),
+                    .src = core::as_byte_span(gpu_mesh_descriptors),
                     .dst_offset = 0,
                 },
             });
 
-        m_mesh_descriptors.push_back(renderer::MeshDescriptor {
-            .center = meshlet_mesh.center,
-            .radius = meshlet_mesh.radius,
-            .meshlet_count = static_cast<u32>(meshlet_mesh.meshlets.size()),
-            .meshlet_triangles_count = static_cast<u32>(meshlet_triangles.size()),
-            .meshlet_vertices_count = static_cast<u32>(
-                meshlet_mesh.meshlet_vertices.size()),
-            .vertex_count = static_cast<u32>(meshlet_mesh.vertices.size()),
-            .vertex_buffer_layout = mesh_descriptor.vertex_buffer_layout,
-        });
+        core::Array<shader::MeshInstance> gpu_mesh_instances;
+        gpu_mesh_instances.reserve(instances.size());
+
+        for (const MeshletScene::Instance& instance : instances) {
+            m_instances_transforms.push_back(instance.transform);
+            m_mesh_instances.push_back(renderer::MeshInstance {
+                .mesh_descriptor_index = instance.mesh_index,
+            });
+            gpu_mesh_instances.push_back(shader::MeshInstance {
+                .mesh_descriptor_index = instance.mesh_index,
+            });
+        }
+
+        for (rhi::BufferHandle& buffer : m_gpu_instance_transforms_buffer) {
+            buffer = globals::g_rhi_context->create_buffer(rhi::BufferCreateInfo {
+                .usage = rhi::BufferUsageFlags::STORAGE_BUFFER,
+                .memory_type = rhi::MemoryType::Dynamic,
+                .size = instances.size() * sizeof(shader::InstanceTransform),
+                .name = "gpu_instance_transforms",
+            });
+        }
+
+        for (usize i = 0; i < rhi::config::MAX_FRAMES_IN_FLIGHT; ++i) {
+            rhi::BufferHandle& buffer = m_mesh_instances_buffer[i];
+            buffer = globals::g_rhi_context->create_buffer(rhi::BufferCreateInfo {
+                .usage = rhi::BufferUsageFlags::STORAGE_BUFFER,
+                .memory_type = rhi::MemoryType::Dynamic,
+                .size = instances.size() * sizeof(shader::MeshInstance),
+                .name = fmt::format("mesh_instances: {}", i),
+            });
+
+            globals::g_rhi_context->update_buffer(
+                buffer,
+                {
+                    rhi::BufferUpdateRegion {
+                        .src = core::as_byte_span(gpu_mesh_instances),
+                        .dst_offset = 0,
+                    },
+                });
+        }
     }
 
     void create_pipelines() noexcept
@@ -508,9 +443,16 @@ private:
 protected:
     virtual void tick(const f32 delta_time) noexcept override
     {
+        if (m_mesh_instances.empty() ||
+            !m_upload_service.is_complete(m_scene_upload_ticket)) {
+            // Only uploads are submitted until the scene can be used.
+            globals::g_rhi_context->submit(m_upload_service.flush(), {});
+            return;
+        }
+
         const u64 frame_index = m_frame_index % rhi::config::MAX_FRAMES_IN_FLIGHT;
 
-        // for (usize i = 0; i < NUM_INSTANCES; ++i) {
+        // for (usize i = 0; i < m_instances_transforms.size(); ++i) {
         //     math::Transform& transform = m_instances_transforms[i];
         //     transform.rotation *= math::Quat::from_angle(math::Vec3 {
         //         0,
@@ -569,7 +511,16 @@ protected:
             core::unreachable();
         }();
 
-        this->set_window_name(fmt::format("{} | fps: {}", type, fps));
+        core::String window_name = fmt::format("{} | fps: {}", type, fps);
+        if (render_output.visible_instances_count.has_value()) {
+            window_name += fmt::format(
+                " | visible instances: {}", *render_output.visible_instances_count);
+        }
+        if (render_output.visible_meshlets_count.has_value()) {
+            window_name += fmt::format(
+                " | visible meshlets: {}", *render_output.visible_meshlets_count);
+        }
+        this->set_window_name(window_name);
     }
 };
 
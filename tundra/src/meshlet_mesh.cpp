@@ -1,13 +1,21 @@
 #include "meshlet_mesh.h"
+#include "core/std/containers/array.h"
+#include "core/logger.h"
 #include "core/std/defer.h"
+#include "core/std/hash.h"
+#include "core/std/option.h"
 #include "core/std/span.h"
 #include "core/std/tuple.h"
 #include <cgltf/cgltf.h>
 #include <meshoptimizer.h>
 #include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <ios>
 #include <iterator>
+#include <type_traits>
+#include <utility>
 
 namespace meshoptimizer {
 
@@ -90,6 +98,10 @@ template <typename T>
         cone_weight);
 
     meshlets.resize(meshlet_count);
+    if (meshlets.empty()) {
+        return BuildMeshletsResult {};
+    }
+
     const meshopt_Meshlet& last = meshlets.back();
 
     const usize meshlet_triangle_count = last.triangle_offset +
@@ -139,176 +151,221 @@ static constexpr u64 MESHLET_MESH_MAGIC_NUMBER = []() consteval {
     return v;
 }();
 
-MeshletMesh MeshletMesh::load(const core::String& path) noexcept
+static_assert(
+    (sizeof(MeshletMesh::Header) % MeshletMesh::SECTION_ALIGNMENT) == 0,
+    "Mesh data must begin at an aligned offset.");
+
+/// Returns true when the file at `output_path` was imported from a file with
+/// `source_hash`, with `import_settings_hash`, by this version of the importer.
+[[nodiscard]] static bool is_import_up_to_date(
+    const core::String& output_path,
+    const u64 source_hash,
+    const u64 import_settings_hash) noexcept
 {
-    const auto load_array = []<typename T>(std::ifstream& input) -> core::Array<T> {
-        u64 arr_size = 0;
-        input.read(reinterpret_cast<char*>(&arr_size), sizeof(arr_size));
-        core::Array<T> temp;
-        temp.resize(arr_size);
-
-        input.read(
-            reinterpret_cast<char*>(temp.data()),
-            static_cast<std::streamsize>(arr_size) * sizeof(T));
-        return temp;
-    };
+    std::ifstream input(output_path, std::ios::binary | std::ios::in);
+    if (!input.is_open()) {
+        return false;
+    }
 
-    std::ifstream input(path, std::ios::binary | std::ios::in);
-    tndr_assert(input.is_open(), "File does not exist.");
+    MeshletMesh::Header header {};
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
 
-    u64 magic = 0;
-    input.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-    tndr_assert(magic == MESHLET_MESH_MAGIC_NUMBER, "");
+    return input.good() && (header.magic == MESHLET_MESH_MAGIC_NUMBER) &&
+           (header.version == MeshletMesh::VERSION) &&
+           (header.source_hash == source_hash) &&
+           (header.import_settings_hash == import_settings_hash);
+}
 
-    math::Vec3 mesh_center;
-    f32 mesh_radius;
-    core::Array<core::Array<math::Vec2>> uvs;
+/// Returns the accessor of attribute `type` with set `index`, or nullptr.
+[[nodiscard]] static const cgltf_accessor* find_accessor(
+    const cgltf_primitive* primitive,
+    const cgltf_attribute_type type,
+    const cgltf_int index) noexcept
+{
+    for (usize i = 0; i < primitive->attributes_count; ++i) {
+        const cgltf_attribute& attribute = primitive->attributes[i];
+        if ((attribute.type == type) && (attribute.index == index)) {
+            return attribute.data;
+        }
+    }
 
-    input.read(reinterpret_cast<char*>(&mesh_center), sizeof(mesh_center));
-    input.read(reinterpret_cast<char*>(&mesh_radius), sizeof(mesh_radius));
+    return nullptr;
+}
 
-    core::Array<Meshlet> meshlets = load_array.operator()<MeshletMesh::Meshlet>(input);
-    core::Array<u8> meshlet_triangles = load_array.operator()<u8>(input);
-    core::Array<u32> meshlet_vertices = load_array.operator()<u32>(input);
-    core::Array<math::Vec3> vertices = load_array.operator()<math::Vec3>(input);
-    core::Array<math::Vec3> normals = load_array.operator()<math::Vec3>(input);
-    core::Array<math::Vec4> tangents = load_array.operator()<math::Vec4>(input);
+u64 MeshletMesh::ImportSettings::get_hash() const noexcept
+{
+    usize seed = 0;
+    core::hash_and_combine(seed, max_vertices);
+    core::hash_and_combine(seed, max_triangles);
+    core::hash_and_combine(seed, cone_weight);
+    return seed;
+}
 
-    u64 arr_size = 0;
-    input.read(reinterpret_cast<char*>(&arr_size), sizeof(arr_size));
-    for ([[maybe_unused]] u64 i = 0; i < arr_size; ++i) {
-        uvs.push_back(load_array.operator()<math::Vec2>(input));
+MeshletMesh::MeshletMesh(const Header& header, core::MappedFile file) noexcept
+    : m_header(header)
+    , m_file(core::move(file))
+{
+}
+
+MeshletMesh MeshletMesh::load(const core::String& path) noexcept
+{
+    core::Option<core::MappedFile> file = core::MappedFile::open(path);
+    tndr_assert(file.has_value(), "File does not exist.");
+
+    const core::Span<const char> data = file->get_data();
+    tndr_assert(data.size() >= sizeof(Header), "File is too small.");
+
+    // The header is copied, so the mapping does not have to be aligned.
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(Header));
+    tndr_assert(header.magic == MESHLET_MESH_MAGIC_NUMBER, "");
+    tndr_assert(header.version == VERSION, "Mesh has to be imported again.");
+
+    const u64 data_size = data.size() - sizeof(Header);
+    for (const SectionRange& section : header.sections) {
+        tndr_assert((section.offset % SECTION_ALIGNMENT) == 0, "");
+        tndr_assert((section.offset + section.size) <= data_size, "");
     }
 
-    return MeshletMesh {
-        .center = mesh_center,
-        .radius = mesh_radius,
-        .meshlets = core::move(meshlets),
-        .meshlet_triangles = core::move(meshlet_triangles),
-        .meshlet_vertices = core::move(meshlet_vertices),
-        .vertices = core::move(vertices),
-        .normals = core::move(normals),
-        .tangents = core::move(tangents),
-        .uvs = core::move(uvs),
-    };
+    return MeshletMesh(header, core::move(*file));
 }
 
-void MeshletMesh::import(
-    const core::String& mesh_path, const core::String& output_path) noexcept
+const MeshletMesh::Header& MeshletMesh::get_header() const noexcept
 {
-    const cgltf_options options {};
-    cgltf_data* data = nullptr;
-    cgltf_result result = cgltf_parse_file(&options, mesh_path.c_str(), &data);
-    tndr_assert(result == cgltf_result_success, "");
+    return m_header;
+}
 
-    tndr_defer {
-        cgltf_free(data);
+core::Span<const char> MeshletMesh::get_data() const noexcept
+{
+    const core::Span<const char> data = m_file.get_data();
+    return core::Span<const char>(
+        data.data() + sizeof(Header), data.size() - sizeof(Header));
+}
+
+const MeshletMesh::SectionRange& MeshletMesh::get_section(
+    const Section section) const noexcept
+{
+    return m_header.sections[static_cast<usize>(section)];
+}
+
+MeshletMesh::ImportedMesh MeshletMesh::import_mesh(
+    const cgltf_mesh& mesh, const ImportSettings& settings) noexcept
+{
+    const core::Span<const cgltf_primitive> primitives = core::Span {
+        static_cast<const cgltf_primitive*>(mesh.primitives),
+        static_cast<const cgltf_primitive*>(mesh.primitives + mesh.primitives_count),
     };
 
-    result = cgltf_load_buffers(&options, data, mesh_path.c_str());
-    tndr_assert(result == cgltf_result_success, "");
-    tndr_assert(data->meshes_count == 1, "");
+    // Only triangle primitives with positions are imported.
+    const auto get_positions = [](const cgltf_primitive& primitive) {
+        const cgltf_accessor* positions = find_accessor(
+            &primitive, cgltf_attribute_type_position, 0);
+        return (primitive.type == cgltf_primitive_type_triangles) ? positions : nullptr;
+    };
 
-    const cgltf_mesh& mesh = data->meshes[0];
+    // Counts are gathered first, so attributes of all primitives are unpacked straight
+    // into their final arrays. Attributes missing in some primitives stay zeroed.
+    usize vertex_count = 0;
+    usize index_count = 0;
+    bool has_normals = false;
+    bool has_tangents = false;
+    usize uv_count = 0;
+
+    for (const cgltf_primitive& primitive : primitives) {
+        const cgltf_accessor* positions = get_positions(primitive);
+        if (positions == nullptr) {
+            continue;
+        }
 
-    core::Array<u32> indices;
-    core::Array<math::Vec3> vertices;
-    core::Array<math::Vec3> normals;
-    core::Array<math::Vec4> tangents;
-    core::Array<core::Array<math::Vec2>> uvs;
-    // Each primitive begins its indices from 0
-    usize indices_offset = 0;
+        vertex_count += positions->count;
+        index_count += (primitive.indices != nullptr) ? primitive.indices->count
+                                                      : positions->count;
+
+        has_normals |= find_accessor(
+                           &primitive, cgltf_attribute_type_normal, 0) != nullptr;
+        has_tangents |= find_accessor(
+                            &primitive, cgltf_attribute_type_tangent, 0) != nullptr;
+        for (usize uv = 0; uv < MAX_UV_COUNT; ++uv) {
+            const cgltf_accessor* accessor = find_accessor(
+                &primitive, cgltf_attribute_type_texcoord, static_cast<cgltf_int>(uv));
+            if (accessor != nullptr) {
+                uv_count = math::max(uv_count, uv + 1);
+            }
+        }
+    }
+
+    core::Array<u32> indices(index_count);
+    core::Array<math::Vec3> vertices(vertex_count);
+    core::Array<math::Vec3> normals(has_normals ? vertex_count : 0);
+    core::Array<math::Vec4> tangents(has_tangents ? vertex_count : 0);
+    core::Array<core::Array<math::Vec2>> uvs(
+        uv_count, core::Array<math::Vec2>(vertex_count));
+
+    const auto unpack_attribute = [](const cgltf_primitive& primitive,
+                                     const cgltf_attribute_type type,
+                                     const cgltf_int index,
+                                     auto& attributes,
+                                     const usize first_vertex,
+                                     const usize count) {
+        const cgltf_accessor* accessor = find_accessor(&primitive, type, index);
+        if ((accessor == nullptr) || attributes.empty()) {
+            return;
+        }
+
+        constexpr usize NUM_COMPONENTS = std::remove_cvref_t<decltype(attributes)>::
+                                             value_type::SIZE;
+        tndr_assert(cgltf_num_components(accessor->type) == NUM_COMPONENTS, "");
+        tndr_assert(accessor->count == count, "");
+
+        cgltf_accessor_unpack_floats(
+            accessor,
+            reinterpret_cast<cgltf_float*>(attributes.data() + first_vertex),
+            count * NUM_COMPONENTS);
+    };
+
+    usize first_vertex = 0;
+    usize first_index = 0;
 
     // Primitive defines the geometry to be rendered with a material.
-    for (usize primitive_index = 0; primitive_index < mesh.primitives_count;
-         ++primitive_index) {
-        const cgltf_primitive& primitive = mesh.primitives[primitive_index];
+    for (const cgltf_primitive& primitive : primitives) {
+        const cgltf_accessor* positions = get_positions(primitive);
+        if (positions == nullptr) {
+            continue;
+        }
 
+        const usize count = positions->count;
+
+        // Each primitive begins its indices from 0.
         if (primitive.indices != nullptr) {
             for (usize i = 0; i < primitive.indices->count; ++i) {
-                indices.push_back(static_cast<u32>(
-                    indices_offset + cgltf_accessor_read_index(primitive.indices, i)));
+                indices[first_index + i] = static_cast<u32>(
+                    first_vertex + cgltf_accessor_read_index(primitive.indices, i));
+            }
+            first_index += primitive.indices->count;
+        } else {
+            for (usize i = 0; i < count; ++i) {
+                indices[first_index + i] = static_cast<u32>(first_vertex + i);
             }
+            first_index += count;
         }
 
-        const core::Span<cgltf_attribute> attributes = core::Span {
-            primitive.attributes,
-            primitive.attributes + primitive.attributes_count,
-        };
-
-        for (const cgltf_attribute& attribute : attributes) {
-            switch (attribute.type) {
-                case cgltf_attribute_type_position: {
-                    const cgltf_accessor* accessor = attribute.data;
-                    const cgltf_size num_components = cgltf_num_components(
-                        accessor->type);
-                    tndr_assert(num_components == 3, "");
-
-                    for (usize i = 0; i < accessor->count; ++i) {
-                        math::Vec3 temp;
-                        cgltf_accessor_read_float(
-                            accessor, i, reinterpret_cast<cgltf_float*>(&temp), 3);
-                        vertices.push_back(temp);
-                    }
-
-                    indices_offset += accessor->count;
-
-                    break;
-                }
-                case cgltf_attribute_type_normal: {
-                    const cgltf_accessor* accessor = attribute.data;
-                    const cgltf_size num_components = cgltf_num_components(
-                        accessor->type);
-                    tndr_assert(num_components == 3, "");
-
-                    for (usize i = 0; i < accessor->count; ++i) {
-                        math::Vec3 temp;
-                        cgltf_accessor_read_float(
-                            accessor, i, reinterpret_cast<cgltf_float*>(&temp), 3);
-                        normals.push_back(temp);
-                    }
-
-                    break;
-                }
-                case cgltf_attribute_type_tangent: {
-                    const cgltf_accessor* accessor = attribute.data;
-                    const cgltf_size num_components = cgltf_num_components(
-                        accessor->type);
-                    tndr_assert(num_components == 4, "");
-
-                    for (usize i = 0; i < accessor->count; ++i) {
-                        math::Vec4 temp;
-                        cgltf_accessor_read_float(
-                            accessor, i, reinterpret_cast<cgltf_float*>(&temp), 4);
-                        tangents.push_back(temp);
-                    }
-
-                    break;
-                }
-                case cgltf_attribute_type_texcoord: {
-                    const cgltf_accessor* accessor = attribute.data;
-                    const cgltf_size num_components = cgltf_num_components(
-                        accessor->type);
-                    tndr_assert(num_components == 2, "");
-
-                    core::Array<math::Vec2> uv;
-                    uv.reserve(accessor->count);
-
-                    for (usize i = 0; i < accessor->count; ++i) {
-                        math::Vec2 temp;
-                        cgltf_accessor_read_float(
-                            accessor, i, reinterpret_cast<cgltf_float*>(&temp), 2);
-                        uv.push_back(temp);
-                    }
-
-                    uvs.push_back(core::move(uv));
-
-                    break;
-                }
-                default:
-                    break;
-            }
+        unpack_attribute(
+            primitive, cgltf_attribute_type_position, 0, vertices, first_vertex, count);
+        unpack_attribute(
+            primitive, cgltf_attribute_type_normal, 0, normals, first_vertex, count);
+        unpack_attribute(
+            primitive, cgltf_attribute_type_tangent, 0, tangents, first_vertex, count);
+        for (usize uv = 0; uv < uvs.size(); ++uv) {
+            unpack_attribute(
+                primitive,
+                cgltf_attribute_type_texcoord,
+                static_cast<cgltf_int>(uv),
+                uvs[uv],
+                first_vertex,
+                count);
         }
+
+        first_vertex += count;
     }
 
     // #TODO: This is incorrect.
@@ -320,19 +377,15 @@ void MeshletMesh::import(
     // meshoptimizer::optimize::optimize_vertex_fetch_in_place(
     //     core::as_span(indices), core::as_span(vertices));
 
-    constexpr usize max_vertices = 64;
-    constexpr usize max_triangles = 128;
-    constexpr f32 cone_weight = 0.5f;
-
     const meshoptimizer::clusterize::BuildMeshletsResult build_meshlets_result =
         meshoptimizer::clusterize::build_meshlets(
             core::as_span(std::as_const(indices)),
             core::as_span(std::as_const(vertices)),
-            max_vertices,
-            max_triangles,
-            cone_weight);
+            settings.max_vertices,
+            settings.max_triangles,
+            settings.cone_weight);
 
-    core::Array<Meshlet> final_meshlets;
+    core::Array<shader::Meshlet> final_meshlets;
     final_meshlets.reserve(build_meshlets_result.meshlets.size());
 
     const core::Array<u8>& meshlet_triangles = build_meshlets_result.meshlet_triangles;
@@ -357,7 +410,7 @@ void MeshletMesh::import(
               (((u32)(static_cast<i16>(bounds.cone_axis_s8[2]) + 127) & 0xFFu) << 8u) |
               (((u32)(static_cast<i16>(bounds.cone_cutoff_s8) + 127) & 0xFFu) << 0u);
 
-        final_meshlets.push_back(Meshlet {
+        final_meshlets.push_back(shader::Meshlet {
             .center = math::Vec3 { bounds.center },
             .radius = bounds.radius,
             .cone_apex = cone_apex,
@@ -378,44 +431,155 @@ void MeshletMesh::import(
             radius = math::max(radius, math::distance(math::Vec3 {}, vertex));
         }
 
-        center /= static_cast<f32>(vertices.size());
+        if (!vertices.empty()) {
+            center /= static_cast<f32>(vertices.size());
+        }
 
         return core::make_tuple(center, radius);
     }();
 
-    //////////////////////////////////////////////////////////////////////////////////////
-    // Write
+    // Triangles are widened to `u32`s read by shaders.
+    const core::Array<u32> wide_meshlet_triangles(
+        meshlet_triangles.begin(), meshlet_triangles.end());
 
-    const auto write_array = []<typename T>(
-                                 std::ofstream& output, const core::Array<T>& arr) {
-        const u64 arr_size = arr.size();
-        output.write(reinterpret_cast<const char*>(&arr_size), sizeof(arr_size));
-        output.write(
-            reinterpret_cast<const char*>(arr.data()),
-            static_cast<std::streamsize>(arr.size() * sizeof(T)));
+    using shader::VertexBufferLayout;
+    VertexBufferLayout vertex_buffer_layout = VertexBufferLayout::POSITIONS;
+    if (!normals.empty()) {
+        vertex_buffer_layout |= VertexBufferLayout::NORMALS;
+    }
+    if (!tangents.empty()) {
+        vertex_buffer_layout |= VertexBufferLayout::TANGENTS;
+    }
+    for (usize i = 0; i < uvs.size(); ++i) {
+        vertex_buffer_layout |= static_cast<VertexBufferLayout>(
+            static_cast<u32>(VertexBufferLayout::UV0) << i);
+    }
+
+    core::Array<core::Span<const char>> vertex_attributes = {
+        core::as_byte_span(vertices),
+        core::as_byte_span(normals),
+        core::as_byte_span(tangents),
     };
+    for (const core::Array<math::Vec2>& uv : uvs) {
+        vertex_attributes.push_back(core::as_byte_span(uv));
+    }
 
-    std::ofstream output(output_path, std::ios::binary | std::ios::out | std::ios::trunc);
+    const core::Array<core::Span<const char>> sections[] = {
+        { core::as_byte_span(final_meshlets) },
+        { core::as_byte_span(wide_meshlet_triangles) },
+        { core::as_byte_span(meshlet_vertices) },
+        vertex_attributes,
+    };
+    static_assert(std::size(sections) == static_cast<usize>(Section::Count));
+
+    ImportedMesh imported_mesh {
+        .header = Header {
+            .magic = 0,
+            .version = 0,
+            .vertex_buffer_layout = vertex_buffer_layout,
+            .center = mesh_center,
+            .radius = mesh_radius,
+            .meshlet_count = static_cast<u32>(final_meshlets.size()),
+            .meshlet_triangles_count = static_cast<u32>(wide_meshlet_triangles.size()),
+            .meshlet_vertices_count = static_cast<u32>(meshlet_vertices.size()),
+            .vertex_count = static_cast<u32>(vertices.size()),
+            .source_hash = 0,
+            .import_settings_hash = 0,
+            .sections = {},
+        },
+        .data = {},
+    };
 
-    output.write(
-        reinterpret_cast<const char*>(&MESHLET_MESH_MAGIC_NUMBER),
-        sizeof(MESHLET_MESH_MAGIC_NUMBER));
+    u64 data_size = 0;
+    for (usize i = 0; i < std::size(sections); ++i) {
+        u64 section_size = 0;
+        for (const core::Span<const char>& part : sections[i]) {
+            section_size += part.size();
+        }
+
+        const u64 offset = (data_size + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+        imported_mesh.header.sections[i] = SectionRange {
+            .offset = offset,
+            .size = section_size,
+        };
+        data_size = offset + section_size;
+    }
 
-    output.write(reinterpret_cast<const char*>(&mesh_center), sizeof(mesh_center));
-    output.write(reinterpret_cast<const char*>(&mesh_radius), sizeof(mesh_radius));
+    // Padding between sections stays zeroed.
+    imported_mesh.data.resize(data_size);
+    for (usize i = 0; i < std::size(sections); ++i) {
+        char* dst = imported_mesh.data.data() + imported_mesh.header.sections[i].offset;
+        for (const core::Span<const char>& part : sections[i]) {
+            if (!part.is_empty()) {
+                std::memcpy(dst, part.data(), part.size());
+            }
+            dst += part.size();
+        }
+    }
 
-    write_array(output, final_meshlets);
-    write_array(output, meshlet_triangles);
-    write_array(output, meshlet_vertices);
-    write_array(output, vertices);
-    write_array(output, normals);
-    write_array(output, tangents);
+    return imported_mesh;
+}
 
-    const u64 uvs_size = uvs.size();
-    output.write(reinterpret_cast<const char*>(&uvs_size), sizeof(uvs_size));
-    for (const core::Array<math::Vec2>& uv : uvs) {
-        write_array(output, uv);
+void MeshletMesh::import(
+    const core::String& mesh_path,
+    const core::String& output_path,
+    const ImportSettings& settings) noexcept
+{
+    const core::Option<core::MappedFile> source = core::MappedFile::open(mesh_path);
+    tndr_assert(source.has_value(), "File does not exist.");
+
+    const core::Span<const char> source_data = source->get_data();
+    const u64 source_hash = core::hash_impl::mumrmur_hash2(
+        source_data.data(), source_data.size());
+    const u64 import_settings_hash = settings.get_hash();
+
+    if (is_import_up_to_date(output_path, source_hash, import_settings_hash)) {
+        tndr_info("`{}` is up to date.", output_path);
+        return;
     }
+
+    tndr_info("Importing `{}`...", mesh_path);
+
+    // The mapped file is parsed, so it is read only once.
+    const cgltf_options options {};
+    cgltf_data* data = nullptr;
+    cgltf_result result = cgltf_parse(
+        &options, source_data.data(), source_data.size(), &data);
+    tndr_assert(result == cgltf_result_success, "");
+
+    tndr_defer {
+        cgltf_free(data);
+    };
+
+    result = cgltf_load_buffers(&options, data, mesh_path.c_str());
+    tndr_assert(result == cgltf_result_success, "");
+    tndr_assert(data->meshes_count == 1, "Use `MeshletScene` to import more meshes.");
+
+    ImportedMesh imported_mesh = import_mesh(data->meshes[0], settings);
+    Header& header = imported_mesh.header;
+    header.magic = MESHLET_MESH_MAGIC_NUMBER;
+    header.version = VERSION;
+    header.source_hash = source_hash;
+    header.import_settings_hash = import_settings_hash;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Write
+
+    // The file is written under a temporary name, so an interrupted import does not
+    // leave an up to date header in front of partial data.
+    const core::String temp_path = output_path + ".tmp";
+    std::ofstream output(temp_path, std::ios::binary | std::ios::out | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(
+        imported_mesh.data.data(),
+        static_cast<std::streamsize>(imported_mesh.data.size()));
+
+    output.close();
+    tndr_assert(!output.fail(), "Failed to write the mesh.");
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, output_path, error);
+    tndr_assert(!error, "Failed to write the mesh.");
 }
 
 } // namespace tundra
@@ -2,51 +2,122 @@
 #include "core/core.h"
 #include "core/std/containers/array.h"
 #include "core/std/containers/string.h"
+#include "core/std/span.h"
+#include "core/utils/mapped_file.h"
 #include "math/vector3.h"
-#include "math/vector4.h"
+#include "shader.h"
 #include <array>
 
+struct cgltf_mesh;
+
 namespace tundra {
 
-struct MeshletMesh {
+/// A mesh split into meshlets, loaded from a `.meshlet_mesh` file.
+///
+/// The file begins with a `Header`, followed by the mesh data. Layout of the mesh data
+/// equals the layout of the `mesh_data_buffer` read by shaders, so it is uploaded
+/// straight from the mapped file, without parsing it.
+class MeshletMesh {
+public:
+    ///
+    static constexpr u32 VERSION = 3;
+    /// Alignment of sections and of the header.
+    static constexpr u64 SECTION_ALIGNMENT = 16;
+    /// Texture coordinate sets beyond it are not imported.
+    static constexpr usize MAX_UV_COUNT = 3;
+
+    /// Sections of the mesh data, in the order of the data.
+    enum class Section : u32 {
+        /// `shader::Meshlet`s.
+        Meshlets,
+        /// Three `u32` indices into meshlet vertices per triangle.
+        MeshletTriangles,
+        /// `u32` indices into the vertex buffer.
+        MeshletVertices,
+        /// Attributes of `Header::vertex_buffer_layout`, each of `Header::vertex_count`
+        /// elements, one after another.
+        VertexBuffer,
+        Count,
+    };
+
+    /// Parameters of meshoptimizer clustering.
+    struct ImportSettings {
+        u32 max_vertices = 64;
+        u32 max_triangles = 128;
+        f32 cone_weight = 0.5f;
+
+        [[nodiscard]] u64 get_hash() const noexcept;
+    };
+
+    ///
+    struct SectionRange {
+        /// Offset from the beginning of the mesh data.
+        u64 offset;
+        u64 size;
+    };
+
     ///
-    struct Meshlet {
+    struct Header {
+        u64 magic;
+        u32 version;
+        shader::VertexBufferLayout vertex_buffer_layout;
+
         math::Vec3 center;
         f32 radius;
 
-        std::array<f32, 3> cone_apex;
-        /// const float cone_axis0 = (int)((cone_axis_and_cutoff & 0xFF000000) >> 24) / 127.0,
-        /// const float cone_axis1 = (int)((cone_axis_and_cutoff & 0x00FF0000) >> 16) / 127.0,
-        /// const float cone_axis2 = (int)((cone_axis_and_cutoff & 0x0000FF00) >> 8) / 127.0);
-        /// const float cone_cutoff = (int)(cone_axis_and_cutoff & 0x000000FF) / 127.0;
-        u32 cone_axis_and_cutoff;
-
-        u32 triangle_offset;
-        u32 triangle_count;
-        u32 vertex_offset;
+        u32 meshlet_count;
+        u32 meshlet_triangles_count;
+        u32 meshlet_vertices_count;
         u32 vertex_count;
+
+        /// Hash of the contents of the imported file.
+        u64 source_hash;
+        /// See `ImportSettings::get_hash`.
+        u64 import_settings_hash;
+
+        alignas(SECTION_ALIGNMENT)
+            std::array<SectionRange, static_cast<usize>(Section::Count)> sections;
     };
 
-    math::Vec3 center;
-    f32 radius;
+    /// A mesh imported in memory.
+    struct ImportedMesh {
+        /// Fields describing a file (`magic`, `version`, and hashes) are zeroed.
+        Header header;
+        /// Mesh data, laid out as in a file.
+        core::Array<char> data;
+    };
 
-    core::Array<Meshlet> meshlets;
-    /// primitive to vertex_index_buffer
-    core::Array<u8> meshlet_triangles;
-    /// vertex_index_buffer to index
-    core::Array<u32> meshlet_vertices;
-    /// index to vertex
-    core::Array<math::Vec3> vertices;
-    core::Array<math::Vec3> normals;
-    core::Array<math::Vec4> tangents;
-    core::Array<core::Array<math::Vec2>> uvs;
+private:
+    Header m_header;
+    core::MappedFile m_file;
+
+private:
+    MeshletMesh(const Header& header, core::MappedFile file) noexcept;
 
 public:
-    ///
+    /// Maps the file at `path`.
     [[nodiscard]] static MeshletMesh load(const core::String& path) noexcept;
+    /// Imports the glTF mesh at `mesh_path` into a file at `output_path`.
     ///
+    /// The output file is a cache: import is skipped when it was imported from a file
+    /// with the same contents, with the same `settings` and `VERSION`. Only `mesh_path`
+    /// is hashed, so buffers in separate files of a `.gltf` are not tracked.
     static void import(
-        const core::String& mesh_path, const core::String& output_path) noexcept;
+        const core::String& mesh_path,
+        const core::String& output_path,
+        const ImportSettings& settings) noexcept;
+    /// Splits triangle primitives of `mesh`, merged into one mesh, into meshlets.
+    ///
+    /// A mesh without triangle primitives has no meshlets, and its data is empty.
+    /// It only reads `mesh`, so meshes of one glTF file can be imported in parallel.
+    [[nodiscard]] static ImportedMesh import_mesh(
+        const cgltf_mesh& mesh, const ImportSettings& settings) noexcept;
+
+public:
+    [[nodiscard]] const Header& get_header() const noexcept;
+    /// Returns the mesh data, which is valid until the mesh is destroyed.
+    [[nodiscard]] core::Span<const char> get_data() const noexcept;
+    [[nodiscard]] const SectionRange& get_section(const Section section) const noexcept;
 };
 
-} // namespace tundra
\ No newline at end of file
+} // namespace tundra
@@ -0,0 +1,345 @@
+#include "meshlet_scene.h"
+#include "core/logger.h"
+#include "core/std/defer.h"
+#include "core/std/hash.h"
+#include "core/std/option.h"
+#include "core/utils/thread_pool.h"
+#include "math/math_utils.h"
+#include "math/quat.h"
+#include "math/vector3.h"
+#include <cgltf/cgltf.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+
+namespace tundra {
+
+static constexpr u64 MESHLET_SCENE_MAGIC_NUMBER = []() consteval {
+    constexpr char LETTERS[] = { 'm', 's', 'h', 'l', 't', '_', 's', 'c' };
+    u64 v = 0;
+    for (u64 i = 0; i < (sizeof(LETTERS) / sizeof(*LETTERS)); ++i) {
+        v |= static_cast<u64>(LETTERS[i]) << (i * 8u);
+    }
+
+    return v;
+}();
+
+/// Returns `MeshletMesh::ImportSettings::get_hash`, combined with the version of the mesh
+/// importer, so scenes are imported again when the mesh data changes.
+[[nodiscard]] static u64 get_import_settings_hash(
+    const MeshletMesh::ImportSettings& settings) noexcept
+{
+    usize seed = settings.get_hash();
+    core::hash_and_combine(seed, MeshletMesh::VERSION);
+    return seed;
+}
+
+/// Returns true when the file at `output_path` was imported from a file with
+/// `source_hash`, with `import_settings_hash`, by this version of the importer.
+[[nodiscard]] static bool is_import_up_to_date(
+    const core::String& output_path,
+    const u64 source_hash,
+    const u64 import_settings_hash) noexcept
+{
+    std::ifstream input(output_path, std::ios::binary | std::ios::in);
+    if (!input.is_open()) {
+        return false;
+    }
+
+    MeshletScene::Header header {};
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    return input.good() && (header.magic == MESHLET_SCENE_MAGIC_NUMBER) &&
+           (header.version == MeshletScene::VERSION) &&
+           (header.source_hash == source_hash) &&
+           (header.import_settings_hash == import_settings_hash);
+}
+
+/// Decomposes a column-major glTF world matrix.
+///
+/// `math::Transform` has a uniform scale, so the largest axis scale is used, and
+/// non-uniformly scaled nodes are rendered larger along their other axes.
+[[nodiscard]] static math::Transform to_transform(
+    const cgltf_float (&matrix)[16]) noexcept
+{
+    math::Vec3 axes[3] = {
+        math::Vec3 { matrix[0], matrix[1], matrix[2] },
+        math::Vec3 { matrix[4], matrix[5], matrix[6] },
+        math::Vec3 { matrix[8], matrix[9], matrix[10] },
+    };
+
+    f32 scale = 0;
+    for (math::Vec3& axis : axes) {
+        const f32 axis_scale = math::length(axis);
+        scale = math::max(scale, axis_scale);
+        if (axis_scale != 0) {
+            axis /= axis_scale;
+        }
+    }
+
+    // Rotation matrix to a quaternion, from the largest of its diagonal terms, so
+    // the square root is never taken of a small number.
+    const f32 m00 = axes[0].x;
+    const f32 m11 = axes[1].y;
+    const f32 m22 = axes[2].z;
+    const f32 trace = m00 + m11 + m22;
+
+    math::Quat rotation;
+    if (trace > 0) {
+        const f32 s = math::sqrt(trace + 1.f) * 2.f;
+        rotation = math::Quat {
+            0.25f * s,
+            (axes[1].z - axes[2].y) / s,
+            (axes[2].x - axes[0].z) / s,
+            (axes[0].y - axes[1].x) / s,
+        };
+    } else if ((m00 > m11) && (m00 > m22)) {
+        const f32 s = math::sqrt(1.f + m00 - m11 - m22) * 2.f;
+        rotation = math::Quat {
+            (axes[1].z - axes[2].y) / s,
+            0.25f * s,
+            (axes[1].x + axes[0].y) / s,
+            (axes[2].x + axes[0].z) / s,
+        };
+    } else if (m11 > m22) {
+        const f32 s = math::sqrt(1.f + m11 - m00 - m22) * 2.f;
+        rotation = math::Quat {
+            (axes[2].x - axes[0].z) / s,
+            (axes[1].x + axes[0].y) / s,
+            0.25f * s,
+            (axes[2].y + axes[1].z) / s,
+        };
+    } else {
+        const f32 s = math::sqrt(1.f + m22 - m00 - m11) * 2.f;
+        rotation = math::Quat {
+            (axes[0].y - axes[1].x) / s,
+            (axes[2].x + axes[0].z) / s,
+            (axes[2].y + axes[1].z) / s,
+            0.25f * s,
+        };
+    }
+
+    return math::Transform {
+        .rotation = math::normalize(rotation),
+        .position = math::Vec3 { matrix[12], matrix[13], matrix[14] },
+        .scale = scale,
+    };
+}
+
+/// Adds instances of `node` and its children.
+static void add_instances(
+    const cgltf_data& data,
+    const cgltf_node& node,
+    core::Array<MeshletScene::Instance>& instances) noexcept
+{
+    if (node.mesh != nullptr) {
+        cgltf_float matrix[16];
+        cgltf_node_transform_world(&node, matrix);
+
+        instances.push_back(MeshletScene::Instance {
+            .transform = to_transform(matrix),
+            .mesh_index = static_cast<u32>(node.mesh - data.meshes),
+        });
+    }
+
+    for (usize i = 0; i < node.children_count; ++i) {
+        add_instances(data, *node.children[i], instances);
+    }
+}
+
+MeshletScene::MeshletScene(
+    const Header& header,
+    core::Array<Mesh> meshes,
+    core::Array<Instance> instances,
+    core::MappedFile file) noexcept
+    : m_header(header)
+    , m_meshes(core::move(meshes))
+    , m_instances(core::move(instances))
+    , m_file(core::move(file))
+{
+}
+
+MeshletScene MeshletScene::load(const core::String& path) noexcept
+{
+    core::Option<core::MappedFile> file = core::MappedFile::open(path);
+    tndr_assert(file.has_value(), "File does not exist.");
+
+    const core::Span<const char> data = file->get_data();
+    tndr_assert(data.size() >= sizeof(Header), "File is too small.");
+
+    // Tables are copied, so the mapping does not have to be aligned.
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(Header));
+    tndr_assert(header.magic == MESHLET_SCENE_MAGIC_NUMBER, "");
+    tndr_assert(header.version == VERSION, "Scene has to be imported again.");
+
+    const u64 meshes_offset = sizeof(Header);
+    const u64 instances_offset = meshes_offset + (header.mesh_count * sizeof(Mesh));
+    const u64 tables_end = instances_offset + (header.instance_count * sizeof(Instance));
+    tndr_assert(tables_end <= data.size(), "File is too small.");
+
+    core::Array<Mesh> meshes(header.mesh_count);
+    std::memcpy(meshes.data(), data.data() + meshes_offset, meshes.size() * sizeof(Mesh));
+
+    core::Array<Instance> instances(header.instance_count);
+    std::memcpy(
+        instances.data(),
+        data.data() + instances_offset,
+        instances.size() * sizeof(Instance));
+
+    for (const Mesh& mesh : meshes) {
+        tndr_assert((mesh.data_offset + mesh.data_size) <= data.size(), "");
+    }
+
+    for (const Instance& instance : instances) {
+        tndr_assert(instance.mesh_index < header.mesh_count, "");
+    }
+
+    return MeshletScene(
+        header, core::move(meshes), core::move(instances), core::move(*file));
+}
+
+void MeshletScene::import(
+    const core::String& scene_path,
+    const core::String& output_path,
+    core::ThreadPool& thread_pool,
+    const MeshletMesh::ImportSettings& settings) noexcept
+{
+    const core::Option<core::MappedFile> source = core::MappedFile::open(scene_path);
+    tndr_assert(source.has_value(), "File does not exist.");
+
+    const core::Span<const char> source_data = source->get_data();
+    const u64 source_hash = core::hash_impl::mumrmur_hash2(
+        source_data.data(), source_data.size());
+    const u64 import_settings_hash = get_import_settings_hash(settings);
+
+    if (is_import_up_to_date(output_path, source_hash, import_settings_hash)) {
+        tndr_info("`{}` is up to date.", output_path);
+        return;
+    }
+
+    tndr_info("Importing `{}`...", scene_path);
+
+    const cgltf_options options {};
+    cgltf_data* data = nullptr;
+    cgltf_result result = cgltf_parse(
+        &options, source_data.data(), source_data.size(), &data);
+    tndr_assert(result == cgltf_result_success, "");
+
+    tndr_defer {
+        cgltf_free(data);
+    };
+
+    result = cgltf_load_buffers(&options, data, scene_path.c_str());
+    tndr_assert(result == cgltf_result_success, "");
+
+    // Meshes are independent, so each one is clustered on its own thread.
+    core::Array<MeshletMesh::ImportedMesh> imported_meshes(data->meshes_count);
+    thread_pool.parallel_for(data->meshes_count, [&](const usize index) {
+        imported_meshes[index] = MeshletMesh::import_mesh(data->meshes[index], settings);
+    });
+
+    const cgltf_scene* scene = (data->scene != nullptr) ? data->scene
+                               : (data->scenes_count > 0) ? &data->scenes[0]
+                                                          : nullptr;
+
+    core::Array<Instance> instances;
+    if (scene != nullptr) {
+        for (usize i = 0; i < scene->nodes_count; ++i) {
+            add_instances(*data, *scene->nodes[i], instances);
+        }
+    } else {
+        for (usize i = 0; i < data->nodes_count; ++i) {
+            if (data->nodes[i].parent == nullptr) {
+                add_instances(*data, data->nodes[i], instances);
+            }
+        }
+    }
+
+    core::erase_if(instances, [&](const Instance& instance) {
+        return imported_meshes[instance.mesh_index].header.meshlet_count == 0;
+    });
+
+    const Header header {
+        .magic = MESHLET_SCENE_MAGIC_NUMBER,
+        .version = VERSION,
+        .mesh_count = static_cast<u32>(imported_meshes.size()),
+        .instance_count = instances.size(),
+        .source_hash = source_hash,
+        .import_settings_hash = import_settings_hash,
+    };
+
+    constexpr u64 ALIGNMENT = MeshletMesh::SECTION_ALIGNMENT;
+    core::Array<Mesh> meshes;
+    meshes.reserve(imported_meshes.size());
+
+    u64 position = sizeof(Header) + (imported_meshes.size() * sizeof(Mesh)) +
+                   (instances.size() * sizeof(Instance));
+    for (const MeshletMesh::ImportedMesh& imported_mesh : imported_meshes) {
+        const u64 offset = (position + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        meshes.push_back(Mesh {
+            .header = imported_mesh.header,
+            .data_offset = offset,
+            .data_size = imported_mesh.data.size(),
+        });
+        position = offset + imported_mesh.data.size();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Write
+
+    // The file is written under a temporary name, so an interrupted import does not
+    // leave an up to date header in front of partial data.
+    const core::String temp_path = output_path + ".tmp";
+    std::ofstream output(temp_path, std::ios::binary | std::ios::out | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(
+        reinterpret_cast<const char*>(meshes.data()),
+        static_cast<std::streamsize>(meshes.size() * sizeof(Mesh)));
+    output.write(
+        reinterpret_cast<const char*>(instances.data()),
+        static_cast<std::streamsize>(instances.size() * sizeof(Instance)));
+
+    constexpr char PADDING[ALIGNMENT] = {};
+    position = static_cast<u64>(output.tellp());
+    for (usize i = 0; i < meshes.size(); ++i) {
+        const u64 padding = meshes[i].data_offset - position;
+        output.write(PADDING, static_cast<std::streamsize>(padding));
+        output.write(
+            imported_meshes[i].data.data(),
+            static_cast<std::streamsize>(meshes[i].data_size));
+        position = meshes[i].data_offset + meshes[i].data_size;
+    }
+
+    output.close();
+    tndr_assert(!output.fail(), "Failed to write the scene.");
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, output_path, error);
+    tndr_assert(!error, "Failed to write the scene.");
+}
+
+const MeshletScene::Header& MeshletScene::get_header() const noexcept
+{
+    return m_header;
+}
+
+core::Span<const MeshletScene::Mesh> MeshletScene::get_meshes() const noexcept
+{
+    return core::as_span(m_meshes);
+}
+
+core::Span<const MeshletScene::Instance> MeshletScene::get_instances() const noexcept
+{
+    return core::as_span(m_instances);
+}
+
+core::Span<const char> MeshletScene::get_mesh_data(const usize index) const noexcept
+{
+    const Mesh& mesh = m_meshes[index];
+    return core::Span<const char>(
+        m_file.get_data().data() + mesh.data_offset, mesh.data_size);
+}
+
+} // namespace tundra
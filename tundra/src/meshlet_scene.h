@@ -0,0 +1,94 @@
+#pragma once
+#include "core/core.h"
+#include "core/std/containers/array.h"
+#include "core/std/containers/string.h"
+#include "core/std/span.h"
+#include "core/utils/mapped_file.h"
+#include "math/transform.h"
+#include "meshlet_mesh.h"
+
+namespace tundra::core {
+class ThreadPool;
+} // namespace tundra::core
+
+namespace tundra {
+
+/// Meshes of a glTF scene and their instances, loaded from a `.meshlet_scene` file.
+///
+/// The file begins with a `Header`, followed by `Header::mesh_count` `Mesh`es and
+/// `Header::instance_count` `Instance`s. Data of every mesh has the layout of
+/// `MeshletMesh` data, and begins at `Mesh::data_offset`.
+class MeshletScene {
+public:
+    ///
+    static constexpr u32 VERSION = 3;
+
+    ///
+    struct Header {
+        u64 magic;
+        u32 version;
+        u32 mesh_count;
+        u64 instance_count;
+
+        /// Hash of the contents of the imported file.
+        u64 source_hash;
+        /// See `MeshletMesh::ImportSettings::get_hash`.
+        u64 import_settings_hash;
+    };
+
+    ///
+    struct Mesh {
+        /// Describes the mesh data, its `magic`, `version`, and hashes are zeroed.
+        /// The data is empty for meshes without triangle primitives.
+        MeshletMesh::Header header;
+        /// Offset from the beginning of the file.
+        u64 data_offset;
+        u64 data_size;
+    };
+
+    ///
+    struct Instance {
+        /// World transform of the node.
+        math::Transform transform;
+        u32 mesh_index;
+    };
+
+private:
+    Header m_header;
+    core::Array<Mesh> m_meshes;
+    core::Array<Instance> m_instances;
+    core::MappedFile m_file;
+
+private:
+    MeshletScene(
+        const Header& header,
+        core::Array<Mesh> meshes,
+        core::Array<Instance> instances,
+        core::MappedFile file) noexcept;
+
+public:
+    /// Maps the file at `path`.
+    [[nodiscard]] static MeshletScene load(const core::String& path) noexcept;
+    /// Imports all meshes and mesh nodes of the glTF file at `scene_path` into a file at
+    /// `output_path`. Meshes are split into meshlets in parallel on `thread_pool`.
+    ///
+    /// Nodes of the default scene become instances, or all nodes, when the file has no
+    /// scenes. Node scale is made uniform, see `math::Transform`. Nodes of meshes without
+    /// meshlets are skipped, so every instance has something to render.
+    ///
+    /// The output file is a cache, the same as in `MeshletMesh::import`.
+    static void import(
+        const core::String& scene_path,
+        const core::String& output_path,
+        core::ThreadPool& thread_pool,
+        const MeshletMesh::ImportSettings& settings) noexcept;
+
+public:
+    [[nodiscard]] const Header& get_header() const noexcept;
+    [[nodiscard]] core::Span<const Mesh> get_meshes() const noexcept;
+    [[nodiscard]] core::Span<const Instance> get_instances() const noexcept;
+    /// Returns the data of mesh `index`, which is valid until the scene is destroyed.
+    [[nodiscard]] core::Span<const char> get_mesh_data(const usize index) const noexcept;
+};
+
+} // namespace tundra
@@ -4,6 +4,7 @@
 #include "rhi/commands/dispatch_indirect.h"
 #include "rhi/rhi_context.h"
 #include <array>
+#include <cstring>
 
 namespace tundra::renderer::common::culling {
 
@@ -36,6 +37,8 @@ struct InstanceCullingUBO {
 namespace config {
 
 inline constexpr u32 MAX_INSTANCE_COUNT = 1u << 16u;
+inline constexpr const char* MESHLET_CULLING_DISPATCH_ARGS_READBACK_NAME =
+    "instance_culling_and_lod.meshlet_culling_dispatch_args_readback";
 
 } // namespace config
 
@@ -46,8 +49,6 @@ InstanceCullingOutput instance_culling_and_lod(
     tndr_assert(input.instance_count < config::MAX_INSTANCE_COUNT, "Too many instances");
 
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle visible_instances;
         frame_graph::BufferHandle meshlet_culling_dispatch_args;
     };
@@ -58,8 +59,6 @@ InstanceCullingOutput instance_culling_and_lod(
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.visible_instances = builder.create_buffer(
                 "instance_culling_and_lod.visible_instances",
                 frame_graph::BufferCreateInfo {
@@ -76,7 +75,8 @@ InstanceCullingOutput instance_culling_and_lod(
                 "instance_culling_and_lod.meshlet_culling_dispatch_args",
                 frame_graph::BufferCreateInfo {
                     .usage = frame_graph::BufferUsageFlags::STORAGE_BUFFER |
-                             frame_graph::BufferUsageFlags::INDIRECT_BUFFER,
+                             frame_graph::BufferUsageFlags::INDIRECT_BUFFER |
+                             frame_graph::BufferUsageFlags::TRANSFER_SOURCE,
                     .memory_type = frame_graph::MemoryType::GPU,
                     .size = sizeof(rhi::DispatchIndirectCommand),
                 });
@@ -84,15 +84,16 @@ InstanceCullingOutput instance_culling_and_lod(
                 data.meshlet_culling_dispatch_args,
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
 
+            builder.use_recorded_bundles();
+
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext* context,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
             //
-            const rhi::BufferHandle ubo_buffer = registry.get_buffer(
-                data.ubo_buffer->buffer());
+            frame_graph::ConstantAllocator& constants = registry.get_constant_allocator();
             const rhi::BufferHandle visible_instances = registry.get_buffer(
                 data.visible_instances);
             const rhi::BufferHandle meshlet_culling_dispatch_args = registry.get_buffer(
@@ -104,34 +105,29 @@ InstanceCullingOutput instance_culling_and_lod(
                                                              .get_uav(),
                 };
 
-                const auto ubo_ref = data.ubo_buffer
-                                         ->allocate<ubo::InstanceCullingInitUbo>();
-
-                rhi->update_buffer(
-                    ubo_buffer,
-                    {
-                        rhi::BufferUpdateRegion {
-                            .src = core::as_byte_span(ubo),
-                            .dst_offset = ubo_ref.offset,
-                        },
-                    });
-
-                encoder.push_constants(ubo_buffer, ubo_ref.offset);
-                encoder.dispatch(
-                    helpers::get_pipeline(
-                        pipelines::common::culling::
-                            INSTANCE_CULLING_AND_LOD_PIPELINE_INIT_NAME,
-                        input.compute_pipelines),
-                    1,
-                    1,
-                    1);
+                const rhi::ComputePipelineHandle init_pipeline = helpers::get_pipeline(
+                    pipelines::common::culling::
+                        INSTANCE_CULLING_AND_LOD_PIPELINE_INIT_NAME,
+                    input.compute_pipelines);
+
+                encoder.execute_recorded_bundle(
+                    registry.get_recorded_bundle_cache().get_or_record(
+                        context,
+                        "instance_culling_and_lod_init",
+                        rhi::QueueType::Graphics,
+                        { init_pipeline.get_handle().get_id() },
+                        core::as_byte_span(ubo),
+                        [&](rhi::CommandEncoder& bundle_encoder,
+                            const rhi::BufferHandle constants_buffer) {
+                            bundle_encoder.push_constants(constants_buffer, 0);
+                            bundle_encoder.dispatch(init_pipeline, 1, 1, 1);
+                            bundle_encoder.global_barrier(rhi::GlobalBarrier {
+                                .previous_access = rhi::GlobalAccessFlags::ALL,
+                                .next_access = rhi::GlobalAccessFlags::ALL,
+                            });
+                        }));
             }
 
-            encoder.global_barrier(rhi::GlobalBarrier {
-                .previous_access = rhi::GlobalAccessFlags::ALL,
-                .next_access = rhi::GlobalAccessFlags::ALL,
-            });
-
             {
                 const ubo::InstanceCullingUBO ubo {
                 .frustum_planes = input.frustum_planes,
@@ -147,18 +143,9 @@ InstanceCullingOutput instance_culling_and_lod(
                 },
             };
 
-                const auto ubo_ref = data.ubo_buffer->allocate<ubo::InstanceCullingUBO>();
+                const u32 ubo_offset = constants.allocate(ubo);
 
-                rhi->update_buffer(
-                    ubo_buffer,
-                    {
-                        rhi::BufferUpdateRegion {
-                            .src = core::as_byte_span(ubo),
-                            .dst_offset = ubo_ref.offset,
-                        },
-                    });
-
-                encoder.push_constants(ubo_buffer, ubo_ref.offset);
+                encoder.push_constants(constants.get_buffer(), ubo_offset);
                 encoder.dispatch(
                     helpers::get_pipeline(
                         pipelines::common::culling::INSTANCE_CULLING_AND_LOD_PIPELINE_NAME,
@@ -169,10 +156,32 @@ InstanceCullingOutput instance_culling_and_lod(
             }
         });
 
+    // `x` of the dispatch arguments is the number of visible instances.
+    fg.add_readback(
+        config::MESHLET_CULLING_DISPATCH_ARGS_READBACK_NAME,
+        data.meshlet_culling_dispatch_args,
+        0,
+        sizeof(rhi::DispatchIndirectCommand));
+
     return InstanceCullingOutput {
         .visible_instances = data.visible_instances,
         .meshlet_culling_dispatch_args = data.meshlet_culling_dispatch_args,
     };
 }
 
+///
+core::Option<u32> read_visible_instances_count(const frame_graph::FrameGraph& fg) noexcept
+{
+    const core::Array<char>* readback = fg.get_readback(
+        config::MESHLET_CULLING_DISPATCH_ARGS_READBACK_NAME);
+    if ((readback == nullptr) ||
+        (readback->size() < sizeof(rhi::DispatchIndirectCommand))) {
+        return std::nullopt;
+    }
+
+    rhi::DispatchIndirectCommand dispatch_args;
+    std::memcpy(&dispatch_args, readback->data(), sizeof(dispatch_args));
+    return dispatch_args.x;
+}
+
 } // namespace tundra::renderer::common::culling
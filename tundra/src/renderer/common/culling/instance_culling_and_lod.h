@@ -1,20 +1,16 @@
 #pragma once
 #include "core/core.h"
-#include "core/std/shared_ptr.h"
+#include "core/std/option.h"
 #include "math/vector4.h"
 #include "renderer/config.h"
 #include "renderer/frame_graph/frame_graph.h"
 #include "renderer/render_input_output.h"
-#include "renderer/ubo.h"
 #include <array>
 
 namespace tundra::renderer::common::culling {
 
 ///
 struct InstanceCullingInput {
-public:
-    core::SharedPtr<UboBuffer> ubo_buffer;
-
 public:
     std::array<math::Vec4, config::NUM_PLANES> frustum_planes = {};
     u32 instance_count = 0;
@@ -38,4 +34,10 @@ struct InstanceCullingOutput {
 [[nodiscard]] InstanceCullingOutput instance_culling_and_lod(
     frame_graph::FrameGraph& fg, const InstanceCullingInput& input) noexcept;
 
+/// Returns the number of instances that passed `instance_culling_and_lod`
+/// `rhi::config::MAX_FRAMES_IN_FLIGHT` frames ago, or `std::nullopt` when no readback
+/// of it has completed yet.
+[[nodiscard]] core::Option<u32> read_visible_instances_count(
+    const frame_graph::FrameGraph& fg) noexcept;
+
 } // namespace tundra::renderer::common::culling
@@ -2,6 +2,7 @@
 #include "pipelines.h"
 #include "renderer/helpers.h"
 #include "rhi/rhi_context.h"
+#include <cstring>
 
 namespace tundra::renderer::common::culling {
 
@@ -40,6 +41,8 @@ struct MeshletCullingUBO {
 namespace config {
 
 inline constexpr u32 MAX_VISIBLE_MESHLETS_COUNT = (1u << 20u) * 4u;
+inline constexpr const char* VISIBLE_MESHLETS_COUNT_READBACK_NAME =
+    "meshlet_culling.visible_meshlets_count_readback";
 
 } // namespace config
 
@@ -52,8 +55,6 @@ MeshletCullingOutput meshlet_culling(
         "Too many meshlets.");
 
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle visible_instances;
         frame_graph::BufferHandle meshlet_culling_dispatch_args;
 
@@ -67,8 +68,6 @@ MeshletCullingOutput meshlet_culling(
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.visible_instances = builder.read(
                 input.visible_instances,
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
@@ -91,7 +90,8 @@ MeshletCullingOutput meshlet_culling(
             data.visible_meshlets_count = builder.create_buffer(
                 "meshlet_culling.visible_meshlets_count",
                 frame_graph::BufferCreateInfo {
-                    .usage = frame_graph::BufferUsageFlags::STORAGE_BUFFER,
+                    .usage = frame_graph::BufferUsageFlags::STORAGE_BUFFER |
+                             frame_graph::BufferUsageFlags::TRANSFER_SOURCE,
                     .memory_type = frame_graph::MemoryType::GPU,
                     .size = sizeof(u32),
                 });
@@ -99,15 +99,16 @@ MeshletCullingOutput meshlet_culling(
                 data.visible_meshlets_count,
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
 
+            builder.use_recorded_bundles();
+
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext* context,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
             //
-            const rhi::BufferHandle ubo_buffer = registry.get_buffer(
-                data.ubo_buffer->buffer());
+            frame_graph::ConstantAllocator& constants = registry.get_constant_allocator();
             const rhi::BufferHandle visible_instances = registry.get_buffer(
                 data.visible_instances);
             const rhi::BufferHandle meshlet_culling_dispatch_args = registry.get_buffer(
@@ -122,33 +123,28 @@ MeshletCullingOutput meshlet_culling(
                     .visible_meshlets_count_uav = visible_meshlets_count.get_uav(),
                 };
 
-                const auto ubo_ref = data.ubo_buffer
-                                         ->allocate<ubo::MeshletCullingInitUbo>();
-
-                rhi->update_buffer(
-                    ubo_buffer,
-                    {
-                        rhi::BufferUpdateRegion {
-                            .src = core::as_byte_span(ubo),
-                            .dst_offset = ubo_ref.offset,
-                        },
-                    });
-
-                encoder.push_constants(ubo_buffer, ubo_ref.offset);
-                encoder.dispatch(
-                    helpers::get_pipeline(
-                        pipelines::common::culling::MESHLET_CULLING_INIT_NAME,
-                        input.compute_pipelines),
-                    1,
-                    1,
-                    1);
+                const rhi::ComputePipelineHandle init_pipeline = helpers::get_pipeline(
+                    pipelines::common::culling::MESHLET_CULLING_INIT_NAME,
+                    input.compute_pipelines);
+
+                encoder.execute_recorded_bundle(
+                    registry.get_recorded_bundle_cache().get_or_record(
+                        context,
+                        "meshlet_culling_init",
+                        rhi::QueueType::Graphics,
+                        { init_pipeline.get_handle().get_id() },
+                        core::as_byte_span(ubo),
+                        [&](rhi::CommandEncoder& bundle_encoder,
+                            const rhi::BufferHandle constants_buffer) {
+                            bundle_encoder.push_constants(constants_buffer, 0);
+                            bundle_encoder.dispatch(init_pipeline, 1, 1, 1);
+                            bundle_encoder.global_barrier(rhi::GlobalBarrier {
+                                .previous_access = rhi::GlobalAccessFlags::ALL,
+                                .next_access = rhi::GlobalAccessFlags::ALL,
+                            });
+                        }));
             }
 
-            encoder.global_barrier(rhi::GlobalBarrier {
-                .previous_access = rhi::GlobalAccessFlags::ALL,
-                .next_access = rhi::GlobalAccessFlags::ALL,
-            });
-
             {
                 const ubo::MeshletCullingUBO ubo {
                 .world_to_view = input.world_to_view,
@@ -166,18 +162,9 @@ MeshletCullingOutput meshlet_culling(
                 },
             };
 
-                const auto ubo_ref = data.ubo_buffer->allocate<ubo::MeshletCullingUBO>();
-
-                rhi->update_buffer(
-                    ubo_buffer,
-                    {
-                        rhi::BufferUpdateRegion {
-                            .src = core::as_byte_span(ubo),
-                            .dst_offset = ubo_ref.offset,
-                        },
-                    });
+                const u32 ubo_offset = constants.allocate(ubo);
 
-                encoder.push_constants(ubo_buffer, ubo_ref.offset);
+                encoder.push_constants(constants.get_buffer(), ubo_offset);
                 encoder.dispatch_indirect(
                     helpers::get_pipeline(
                         pipelines::common::culling::MESHLET_CULLING_NAME,
@@ -187,10 +174,30 @@ MeshletCullingOutput meshlet_culling(
             }
         });
 
+    fg.add_readback(
+        config::VISIBLE_MESHLETS_COUNT_READBACK_NAME,
+        data.visible_meshlets_count,
+        0,
+        sizeof(u32));
+
     return MeshletCullingOutput {
         .visible_meshlets = data.visible_meshlets,
         .visible_meshlets_count = data.visible_meshlets_count,
     };
 }
 
+///
+core::Option<u32> read_visible_meshlets_count(const frame_graph::FrameGraph& fg) noexcept
+{
+    const core::Array<char>* readback = fg.get_readback(
+        config::VISIBLE_MESHLETS_COUNT_READBACK_NAME);
+    if ((readback == nullptr) || (readback->size() < sizeof(u32))) {
+        return std::nullopt;
+    }
+
+    u32 visible_meshlets_count = 0;
+    std::memcpy(&visible_meshlets_count, readback->data(), sizeof(u32));
+    return visible_meshlets_count;
+}
+
 } // namespace tundra::renderer::common::culling
@@ -1,21 +1,17 @@
 #pragma once
 #include "core/core.h"
-#include "core/std/shared_ptr.h"
+#include "core/std/option.h"
 #include "math/matrix4.h"
 #include "math/vector4.h"
 #include "renderer/config.h"
 #include "renderer/frame_graph/frame_graph.h"
 #include "renderer/render_input_output.h"
-#include "renderer/ubo.h"
 #include <array>
 
 namespace tundra::renderer::common::culling {
 
 ///
 struct MeshletCullingInput {
-public:
-    core::SharedPtr<UboBuffer> ubo_buffer;
-
 public:
     std::array<math::Vec4, config::NUM_PLANES> frustum_planes;
     math::Vec3 camera_position;
@@ -44,4 +40,10 @@ struct MeshletCullingOutput {
 [[nodiscard]] MeshletCullingOutput meshlet_culling(
     frame_graph::FrameGraph& fg, const MeshletCullingInput& input) noexcept;
 
+/// Returns the number of meshlets that passed `meshlet_culling`
+/// `rhi::config::MAX_FRAMES_IN_FLIGHT` frames ago, or `std::nullopt` when no readback
+/// of it has completed yet.
+[[nodiscard]] core::Option<u32> read_visible_meshlets_count(
+    const frame_graph::FrameGraph& fg) noexcept;
+
 } // namespace tundra::renderer::common::culling
@@ -35,8 +35,6 @@ IndexBufferGeneratorInitOutput index_buffer_generator_init(
     const IndexBufferGeneratorInitInput& input) noexcept
 {
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle num_visible_meshlets;
 
         frame_graph::BufferHandle meshlet_offsets;
@@ -54,8 +52,6 @@ IndexBufferGeneratorInitOutput index_buffer_generator_init(
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.num_visible_meshlets = builder.read(
                 input.num_visible_meshlets, //
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
@@ -125,16 +121,15 @@ IndexBufferGeneratorInitOutput index_buffer_generator_init(
                     }),
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
 
+            builder.use_recorded_bundles();
+
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext* context,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
             //
-            const rhi::BufferHandle ubo_buffer //
-                = registry.get_buffer(data.ubo_buffer->buffer());
-
             const rhi::BufferHandle num_visible_meshlets = registry.get_buffer(
                 data.num_visible_meshlets);
             const rhi::BufferHandle meshlet_offsets = registry.get_buffer(
@@ -154,31 +149,27 @@ IndexBufferGeneratorInitOutput index_buffer_generator_init(
                 }
             };
 
-            const auto ubo_ref = data.ubo_buffer
-                                     ->allocate<ubo::IndexBufferGeneratorInitUbo>();
-
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(ubo),
-                        .dst_offset = ubo_ref.offset,
-                    },
-                });
-
-            encoder.push_constants(ubo_buffer, ubo_ref.offset);
-            encoder.dispatch(
-                helpers::get_pipeline(
-                    pipelines::hardware::culling::INDEX_BUFFER_GENERATOR_INIT_NAME,
-                    input.compute_pipelines),
-                1,
-                1,
-                1);
-
-            encoder.global_barrier(rhi::GlobalBarrier {
-                .previous_access = rhi::GlobalAccessFlags::ALL,
-                .next_access = rhi::GlobalAccessFlags::ALL,
-            });
+            const rhi::ComputePipelineHandle pipeline = helpers::get_pipeline(
+                pipelines::hardware::culling::INDEX_BUFFER_GENERATOR_INIT_NAME,
+                input.compute_pipelines);
+
+            encoder.execute_recorded_bundle(
+                registry.get_recorded_bundle_cache().get_or_record(
+                    context,
+                    "index_buffer_generator_init",
+                    rhi::QueueType::Graphics,
+                    { pipeline.get_handle().get_id() },
+                    core::as_byte_span(ubo),
+                    [&](rhi::CommandEncoder& bundle_encoder,
+                        const rhi::BufferHandle constants_buffer) {
+                        bundle_encoder.push_constants(constants_buffer, 0);
+                        bundle_encoder.dispatch(pipeline, 1, 1, 1);
+
+                        bundle_encoder.global_barrier(rhi::GlobalBarrier {
+                            .previous_access = rhi::GlobalAccessFlags::ALL,
+                            .next_access = rhi::GlobalAccessFlags::ALL,
+                        });
+                    }));
         });
 
     return IndexBufferGeneratorInitOutput {
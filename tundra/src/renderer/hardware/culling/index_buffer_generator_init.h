@@ -1,17 +1,12 @@
 #pragma once
 #include "core/core.h"
-#include "core/std/shared_ptr.h"
 #include "renderer/frame_graph/frame_graph.h"
 #include "renderer/render_input_output.h"
-#include "renderer/ubo.h"
 
 namespace tundra::renderer::hardware::culling {
 
 ///
 struct IndexBufferGeneratorInitInput {
-public:
-    core::SharedPtr<UboBuffer> ubo_buffer;
-
 public:
     u32 num_loops = 0;
     frame_graph::BufferHandle num_visible_meshlets;
@@ -1,5 +1,4 @@
 #include "renderer/hardware/hardware_rasterizer.h"
-#include "core/std/shared_ptr.h"
 #include "pipelines.h"
 #include "renderer/common/culling/instance_culling_and_lod.h"
 #include "renderer/common/culling/meshlet_culling.h"
@@ -10,7 +9,6 @@
 #include "renderer/hardware/culling/index_buffer_generator_init.h"
 #include "renderer/helpers.h"
 #include "renderer/render_input_output.h"
-#include "renderer/ubo.h"
 #include "rhi/commands/barrier.h"
 #include "rhi/commands/command_encoder.h"
 #include "rhi/commands/dispatch_indirect.h"
@@ -107,9 +105,6 @@ struct DrawMeshletsUbo {
 
 ///
 struct RenderMeshletsInput {
-public:
-    core::SharedPtr<UboBuffer> ubo_buffer;
-
 public:
     u32 num_iterations;
 
@@ -154,8 +149,6 @@ RenderMeshletsOutput render_meshlets(
     frame_graph::FrameGraph& fg, const RenderMeshletsInput& input)
 {
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::TextureHandle visibility_buffer;
         frame_graph::TextureHandle depth_buffer;
 
@@ -179,7 +172,6 @@ RenderMeshletsOutput render_meshlets(
         "render_meshlets",
         [&](frame_graph::Builder& builder, frame_graph::RenderPass& render_pass) {
             Data data {};
-            data.ubo_buffer = input.ubo_buffer;
 
             data.visibility_buffer = builder.write(
                 builder.create_texture(
@@ -270,7 +262,7 @@ RenderMeshletsOutput render_meshlets(
 
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext*,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data,
@@ -279,7 +271,8 @@ RenderMeshletsOutput render_meshlets(
             const auto index_buffer_generator = [&](const u32 index) {
                 encoder.begin_region("index_buffer_generator", { 0.2f, 0.5f, 0.2f, 1.f });
 
-                const auto ubo_buffer = registry.get_buffer(data.ubo_buffer->buffer());
+                frame_graph::ConstantAllocator& constants =
+                    registry.get_constant_allocator();
 
                 const auto index_generator_dispatch_args = registry.get_buffer(
                     data.index_generator_dispatch_indirect_commands);
@@ -299,19 +292,9 @@ RenderMeshletsOutput render_meshlets(
                         .visible_indices_count_uav = visible_indices_count.get_uav(),
                     };
 
-                    const auto ubo_ref =
-                        data.ubo_buffer->allocate<ubo::IndexBufferGeneratorClearUbo>();
-
-                    rhi->update_buffer(
-                        ubo_buffer,
-                        {
-                            rhi::BufferUpdateRegion {
-                                .src = core::as_byte_span(ubo),
-                                .dst_offset = ubo_ref.offset,
-                            },
-                        });
+                    const u32 ubo_offset = constants.allocate(ubo);
 
-                    encoder.push_constants(ubo_buffer, ubo_ref.offset);
+                    encoder.push_constants(constants.get_buffer(), ubo_offset);
                     encoder.dispatch(
                         helpers::get_pipeline(
                             pipelines::hardware::culling::INDEX_BUFFER_GENERATOR_CLEAR_NAME,
@@ -346,19 +329,9 @@ RenderMeshletsOutput render_meshlets(
                         }                      
                     };
 
-                    const auto ubo_ref = data.ubo_buffer
-                                             ->allocate<ubo::IndexBufferGeneratorUBO>();
+                    const u32 ubo_offset = constants.allocate(ubo);
 
-                    rhi->update_buffer(
-                        ubo_buffer,
-                        {
-                            rhi::BufferUpdateRegion {
-                                .src = core::as_byte_span(ubo),
-                                .dst_offset = ubo_ref.offset,
-                            },
-                        });
-
-                    encoder.push_constants(ubo_buffer, ubo_ref.offset);
+                    encoder.push_constants(constants.get_buffer(), ubo_offset);
                     encoder.dispatch_indirect(
                         helpers::get_pipeline(
                             pipelines::hardware::culling::INDEX_BUFFER_GENERATOR_NAME,
@@ -374,8 +347,8 @@ RenderMeshletsOutput render_meshlets(
                 encoder.begin_region(
                     "generate_draw_indirect_commands", { 0.9f, 0.0f, 0.6f, 1.f });
 
-                const rhi::BufferHandle ubo_buffer = registry.get_buffer(
-                    data.ubo_buffer->buffer());
+                frame_graph::ConstantAllocator& constants =
+                    registry.get_constant_allocator();
                 const rhi::BufferHandle visible_indices_count = registry.get_buffer(
                     data.visible_indices_count);
                 const rhi::BufferHandle draw_meshlets_draw_args = registry.get_buffer(
@@ -394,19 +367,9 @@ RenderMeshletsOutput render_meshlets(
                     }
                 };
 
-                const auto ubo_ref = data.ubo_buffer
-                                         ->allocate<ubo::GenerateIndirectCommandsUbo>();
-
-                rhi->update_buffer(
-                    ubo_buffer,
-                    {
-                        rhi::BufferUpdateRegion {
-                            .src = core::as_byte_span(ubo),
-                            .dst_offset = ubo_ref.offset,
-                        },
-                    });
+                const u32 ubo_offset = constants.allocate(ubo);
 
-                encoder.push_constants(ubo_buffer, ubo_ref.offset);
+                encoder.push_constants(constants.get_buffer(), ubo_offset);
                 encoder.dispatch(
                     helpers::get_pipeline(
                         pipelines::hardware::culling::GENERATE_DRAW_INDIRECT_COMMANDS_NAME,
@@ -435,7 +398,8 @@ RenderMeshletsOutput render_meshlets(
             const auto draw_meshlets = [&, render_pass = render_pass_copy]() {
                 encoder.begin_region("draw_meshlets", { 1.f, 0.1f, 0.6f, 1.f });
                 //
-                const auto ubo_buffer = registry.get_buffer(data.ubo_buffer->buffer());
+                frame_graph::ConstantAllocator& constants =
+                    registry.get_constant_allocator();
 
                 const auto visible_meshlets = registry.get_buffer(data.visible_meshlets);
 
@@ -454,18 +418,9 @@ RenderMeshletsOutput render_meshlets(
                                   input.gpu_mesh_instance_transforms.get_srv(),
                           } };
 
-                const auto ubo_ref = data.ubo_buffer->allocate<ubo::DrawMeshletsUbo>();
-
-                rhi->update_buffer(
-                    ubo_buffer,
-                    {
-                        rhi::BufferUpdateRegion {
-                            .src = core::as_byte_span(ubo),
-                            .dst_offset = ubo_ref.offset,
-                        },
-                    });
+                const u32 ubo_offset = constants.allocate(ubo);
 
-                encoder.push_constants(ubo_buffer, ubo_ref.offset);
+                encoder.push_constants(constants.get_buffer(), ubo_offset);
 
                 encoder.set_viewport(rhi::Viewport {
                     .rect =
@@ -617,44 +572,10 @@ RenderOutput hardware_rasterizer(
         math::normalize(-frustum_t[3] + frustum_t[2]),
     };
 
-    struct UboData {
-        // #TODO: This should be provided by frame graph
-        core::SharedPtr<UboBuffer> ubo_buffer;
-    };
-
-    UboData ubo_data = fg.add_pass(
-        frame_graph::QueueType::Graphics,
-        "create_ubo",
-        [&](frame_graph::Builder& builder) {
-            constexpr u64 ubo_size = 1024ull * 1024;
-
-            const auto ubo_buffer = builder.create_buffer(
-                "ubo_buffer",
-                frame_graph::BufferCreateInfo {
-                    .usage = frame_graph::BufferUsageFlags::STORAGE_BUFFER,
-                    .memory_type = frame_graph::MemoryType::Dynamic,
-                    .size = ubo_size,
-                });
-
-            builder.write(
-                ubo_buffer,
-                frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER |
-                    frame_graph::BufferResourceUsage::GRAPHICS_STORAGE_BUFFER);
-
-            return UboData {
-                .ubo_buffer = core::make_shared<UboBuffer>(ubo_buffer, ubo_size),
-            };
-        },
-        [=](rhi::IRHIContext*,
-            const frame_graph::Registry&,
-            rhi::CommandEncoder&,
-            const UboData&) {});
-
     const common::culling::InstanceCullingOutput instance_culling =
         common::culling::instance_culling_and_lod(
             fg,
             common::culling::InstanceCullingInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .frustum_planes = frustum_planes,
                 .instance_count = static_cast<u32>(instance_count),
                 .mesh_descriptors = input.gpu_mesh_descriptors,
@@ -667,7 +588,6 @@ RenderOutput hardware_rasterizer(
         common::culling::meshlet_culling(
             fg,
             common::culling::MeshletCullingInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .frustum_planes = frustum_planes,
                 .camera_position = input.camera_position,
                 .world_to_view = input.world_to_view,
@@ -689,7 +609,6 @@ RenderOutput hardware_rasterizer(
         hardware::culling::index_buffer_generator_init(
             fg,
             hardware::culling::IndexBufferGeneratorInitInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .num_loops = num_iterations,
                 .num_visible_meshlets = meshlet_culling.visible_meshlets_count,
                 .compute_pipelines = input.compute_pipelines,
@@ -698,7 +617,6 @@ RenderOutput hardware_rasterizer(
     const RenderMeshletsOutput render_meshlets_out = render_meshlets(
         fg,
         RenderMeshletsInput {
-            .ubo_buffer = ubo_data.ubo_buffer,
             .num_iterations = num_iterations,
             .world_to_view = input.world_to_view,
             .view_to_clip = input.view_to_clip,
@@ -724,6 +642,8 @@ RenderOutput hardware_rasterizer(
 
     return RenderOutput {
         .color_output = render_meshlets_out.visibility_buffer,
+        .visible_instances_count = common::culling::read_visible_instances_count(fg),
+        .visible_meshlets_count = common::culling::read_visible_meshlets_count(fg),
     };
 }
 
@@ -40,8 +40,6 @@ struct MaterialUbo {
     frame_graph::FrameGraph& fg, const MaterialInput& input) noexcept
 {
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle visible_meshlets;
         frame_graph::TextureHandle vis_texture;
 
@@ -54,8 +52,6 @@ struct MaterialUbo {
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.visible_meshlets = builder.read(
                 input.visible_meshlets,
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
@@ -85,12 +81,11 @@ struct MaterialUbo {
 
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext*,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
-            const rhi::BufferHandle ubo_buffer = registry.get_buffer(
-                data.ubo_buffer->buffer());
+            frame_graph::ConstantAllocator& constants = registry.get_constant_allocator();
             const rhi::BufferHandle visible_meshlets = registry.get_buffer(
                 data.visible_meshlets);
             const rhi::TextureHandle vis_texture = registry.get_texture(data.vis_texture);
@@ -116,18 +111,9 @@ struct MaterialUbo {
                 },
             };
 
-            const auto ubo_ref = data.ubo_buffer->allocate<ubo::MaterialUbo>();
-
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(ubo),
-                        .dst_offset = ubo_ref.offset,
-                    },
-                });
+            const u32 ubo_offset = constants.allocate(ubo);
 
-            encoder.push_constants(ubo_buffer, ubo_ref.offset);
+            encoder.push_constants(constants.get_buffer(), ubo_offset);
             encoder.global_barrier(rhi::GlobalBarrier {
                 .previous_access = rhi::GlobalAccessFlags::ALL,
                 .next_access = rhi::GlobalAccessFlags::ALL,
@@ -62,8 +62,6 @@ InstanceCullingOutput instance_culling(
     tndr_assert(input.num_instances < config::MAX_INSTANCE_COUNT, "Too many instances");
 
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle command_count;
         frame_graph::BufferHandle command_buffer;
     };
@@ -74,8 +72,6 @@ InstanceCullingOutput instance_culling(
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.command_count = builder.create_buffer(
                 "instance_culling.command_count",
                 frame_graph::BufferCreateInfo {
@@ -100,15 +96,16 @@ InstanceCullingOutput instance_culling(
                 data.command_buffer,
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
 
+            builder.use_recorded_bundles();
+
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext* context,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
             //
-            const rhi::BufferHandle ubo_buffer //
-                = registry.get_buffer(data.ubo_buffer->buffer());
+            frame_graph::ConstantAllocator& constants = registry.get_constant_allocator();
             const rhi::BufferHandle command_count //
                 = registry.get_buffer(data.command_count);
             const rhi::BufferHandle command_buffer //
@@ -132,39 +129,29 @@ InstanceCullingOutput instance_culling(
                 },
             };
 
-            auto ubo_ref = data.ubo_buffer->allocate<ubo::InstanceCullingInitUbo>();
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(init_ubo),
-                        .dst_offset = ubo_ref.offset,
-                    },
-                });
-            encoder.push_constants(ubo_buffer, static_cast<u32>(ubo_ref.offset));
-            encoder.dispatch(
-                helpers::get_pipeline(
-                    pipelines::mesh_shaders::passes::INSTANCE_CULLING_INIT_NAME,
-                    input.compute_pipelines),
-                1,
-                1,
-                1);
-
-            encoder.global_barrier(rhi::GlobalBarrier {
-                .previous_access = rhi::GlobalAccessFlags::ALL,
-                .next_access = rhi::GlobalAccessFlags::ALL,
-            });
-
-            ubo_ref = data.ubo_buffer->allocate<ubo::InstanceCullingUbo>();
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(culling_ubo),
-                        .dst_offset = ubo_ref.offset,
-                    },
-                });
-            encoder.push_constants(ubo_buffer, static_cast<u32>(ubo_ref.offset));
+            const rhi::ComputePipelineHandle init_pipeline = helpers::get_pipeline(
+                pipelines::mesh_shaders::passes::INSTANCE_CULLING_INIT_NAME,
+                input.compute_pipelines);
+
+            encoder.execute_recorded_bundle(
+                registry.get_recorded_bundle_cache().get_or_record(
+                    context,
+                    "instance_culling_init",
+                    rhi::QueueType::Graphics,
+                    { init_pipeline.get_handle().get_id() },
+                    core::as_byte_span(init_ubo),
+                    [&](rhi::CommandEncoder& bundle_encoder,
+                        const rhi::BufferHandle constants_buffer) {
+                        bundle_encoder.push_constants(constants_buffer, 0);
+                        bundle_encoder.dispatch(init_pipeline, 1, 1, 1);
+                        bundle_encoder.global_barrier(rhi::GlobalBarrier {
+                            .previous_access = rhi::GlobalAccessFlags::ALL,
+                            .next_access = rhi::GlobalAccessFlags::ALL,
+                        });
+                    }));
+
+            const u32 culling_ubo_offset = constants.allocate(culling_ubo);
+            encoder.push_constants(constants.get_buffer(), culling_ubo_offset);
             encoder.dispatch(
                 helpers::get_pipeline(
                     pipelines::mesh_shaders::passes::INSTANCE_CULLING_NAME,
@@ -1,20 +1,15 @@
 #pragma once
 #include "core/core.h"
-#include "core/std/shared_ptr.h"
 #include "math/vector4.h"
 #include "renderer/config.h"
 #include "renderer/frame_graph/frame_graph.h"
 #include "renderer/render_input_output.h"
-#include "renderer/ubo.h"
 #include <array>
 
 namespace tundra::renderer::mesh_shaders {
 
 ///
 struct InstanceCullingInput {
-public:
-    core::SharedPtr<UboBuffer> ubo_buffer;
-
 public:
     std::array<math::Vec4, config::NUM_PLANES> frustum_planes = {};
     u32 num_instances = 0;
@@ -35,8 +35,6 @@ MeshShaderOutput mesh_shader(
     frame_graph::FrameGraph& fg, const MeshShaderInput& input) noexcept
 {
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle command_count;
         frame_graph::BufferHandle command_buffer;
         frame_graph::BufferHandle task_shader_dispatch_args;
@@ -51,8 +49,6 @@ MeshShaderOutput mesh_shader(
         [&](frame_graph::Builder& builder, frame_graph::RenderPass& render_pass) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.command_count = input.command_count;
             data.command_buffer = input.command_buffer;
             data.task_shader_dispatch_args = input.task_shader_dispatch_args;
@@ -121,14 +117,13 @@ MeshShaderOutput mesh_shader(
 
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext*,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data,
             const rhi::RenderPass& render_pass) {
             //
-            const rhi::BufferHandle ubo_buffer //
-                = registry.get_buffer(data.ubo_buffer->buffer());
+            frame_graph::ConstantAllocator& constants = registry.get_constant_allocator();
             const rhi::BufferHandle command_count //
                 = registry.get_buffer(data.command_count);
             const rhi::BufferHandle command_buffer //
@@ -151,17 +146,9 @@ MeshShaderOutput mesh_shader(
                 },
             };
 
-            auto ubo_ref = data.ubo_buffer->allocate<ubo::TaskShaderUbo>();
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(ubo),
-                        .dst_offset = ubo_ref.offset,
-                    },
-                });
+            const u32 ubo_offset = constants.allocate(ubo);
 
-            encoder.push_constants(ubo_buffer, ubo_ref.offset);
+            encoder.push_constants(constants.get_buffer(), ubo_offset);
 
             encoder.set_viewport(rhi::Viewport {
                 .rect =
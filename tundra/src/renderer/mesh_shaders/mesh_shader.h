@@ -1,21 +1,16 @@
 #pragma once
 #include "core/core.h"
-#include "core/std/shared_ptr.h"
 #include "math/vector4.h"
 #include "renderer/config.h"
 #include "renderer/frame_graph/frame_graph.h"
 #include "renderer/frame_graph/resources/handle.h"
 #include "renderer/render_input_output.h"
-#include "renderer/ubo.h"
 #include <array>
 
 namespace tundra::renderer::mesh_shaders {
 
 ///
 struct MeshShaderInput {
-public:
-    core::SharedPtr<UboBuffer> ubo_buffer;
-
 public:
     math::UVec2 view_size = math::UVec2 {};
     math::Mat4 view_to_clip = math::Mat4 {};
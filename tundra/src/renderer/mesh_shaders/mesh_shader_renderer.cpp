@@ -1,5 +1,4 @@
 #include "renderer/mesh_shaders/mesh_shader_renderer.h"
-#include "core/std/shared_ptr.h"
 #include "math/matrix4.h"
 #include "math/vector4.h"
 #include "renderer/frame_graph/frame_graph.h"
@@ -7,7 +6,6 @@
 #include "renderer/mesh_shaders/instance_culling.h"
 #include "renderer/mesh_shaders/mesh_shader.h"
 #include "renderer/mesh_shaders/task_dispatch_command_generator.h"
-#include "renderer/ubo.h"
 #include "rhi/commands/command_encoder.h"
 #include "rhi/rhi_context.h"
 #include "shader.h"
@@ -34,44 +32,10 @@ RenderOutput mesh_shader_renderer(
         math::normalize(-frustum_t[3] + frustum_t[2]),
     };
 
-    struct UboData {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-    };
-
-    const UboData ubo_data = fg.add_pass(
-        frame_graph::QueueType::Graphics,
-        "create_ubo",
-        [&](frame_graph::Builder& builder) {
-            constexpr u64 ubo_size = 1024ull * 1024;
-            const auto ubo_buffer = builder.create_buffer(
-                "ubo_buffer",
-                frame_graph::BufferCreateInfo {
-                    .usage = frame_graph::BufferUsageFlags::STORAGE_BUFFER,
-                    .memory_type = frame_graph::MemoryType::Dynamic,
-                    .size = ubo_size,
-                });
-
-            builder.write(
-                ubo_buffer,
-                frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER |
-                    frame_graph::BufferResourceUsage::GRAPHICS_STORAGE_BUFFER);
-
-            return UboData {
-                .ubo_buffer = core::make_shared<UboBuffer>(ubo_buffer, ubo_size),
-            };
-        },
-        [=](rhi::IRHIContext*,
-            const frame_graph::Registry&,
-            rhi::CommandEncoder&,
-            const UboData&) {
-
-        });
-
     const mesh_shaders::InstanceCullingOutput instance_culling =
         mesh_shaders::instance_culling(
             fg,
             mesh_shaders::InstanceCullingInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .frustum_planes = frustum_planes,
                 .num_instances = static_cast<u32>(instance_count),
                 .mesh_descriptors = input.gpu_mesh_descriptors,
@@ -84,7 +48,6 @@ RenderOutput mesh_shader_renderer(
         task_dispatch_command_generator = mesh_shaders::task_dispatch_command_generator(
             fg,
             mesh_shaders::TaskDispatchCommandGeneratorInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .command_count = instance_culling.command_count,
                 .compute_pipelines = input.compute_pipelines,
             });
@@ -92,7 +55,6 @@ RenderOutput mesh_shader_renderer(
     const mesh_shaders::MeshShaderOutput mesh_shader = mesh_shaders::mesh_shader(
         fg,
         mesh_shaders::MeshShaderInput {
-            .ubo_buffer = ubo_data.ubo_buffer,
             .view_size = input.view_size,
             .view_to_clip = input.view_to_clip,
             .world_to_view = input.world_to_view,
@@ -116,7 +78,6 @@ RenderOutput mesh_shader_renderer(
     // const passes::MaterialOutput material_output = passes::material(
     //     fg,
     //     passes::MaterialInput {
-    //         .ubo_buffer = ubo_data.ubo_buffer,
     //         .world_to_clip = frustum,
     //         .camera_position = input.camera_position,
     //         .light_position = math::Vec3 { -5, 2, 5 },
@@ -28,8 +28,6 @@ TaskDispatchCommandGeneratorOutput task_dispatch_command_generator(
     frame_graph::FrameGraph& fg, const TaskDispatchCommandGeneratorInput& input) noexcept
 {
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle command_count;
         frame_graph::BufferHandle task_shader_dispatch_args;
     };
@@ -40,8 +38,6 @@ TaskDispatchCommandGeneratorOutput task_dispatch_command_generator(
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.command_count = input.command_count;
             builder.read(
                 data.command_count,
@@ -62,13 +58,12 @@ TaskDispatchCommandGeneratorOutput task_dispatch_command_generator(
 
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext*,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
             //
-            const rhi::BufferHandle ubo_buffer //
-                = registry.get_buffer(data.ubo_buffer->buffer());
+            frame_graph::ConstantAllocator& constants = registry.get_constant_allocator();
             const rhi::BufferHandle command_count //
                 = registry.get_buffer(data.command_count);
             const rhi::BufferHandle task_shader_dispatch_args //
@@ -83,18 +78,8 @@ TaskDispatchCommandGeneratorOutput task_dispatch_command_generator(
                 },
             };
 
-            const auto ubo_ref = data //
-                                     .ubo_buffer
-                                     ->allocate<ubo::TaskDispatchCommandGeneratorUbo>();
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(ubo),
-                        .dst_offset = ubo_ref.offset,
-                    },
-                });
-            encoder.push_constants(ubo_buffer, static_cast<u32>(ubo_ref.offset));
+            const u32 ubo_offset = constants.allocate(ubo);
+            encoder.push_constants(constants.get_buffer(), ubo_offset);
             encoder.dispatch(
                 helpers::get_pipeline(
                     pipelines::mesh_shaders::passes::TASK_DISPATCH_COMMAND_GENERATOR_NAME,
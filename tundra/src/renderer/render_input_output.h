@@ -3,6 +3,7 @@
 #include "core/std/containers/array.h"
 #include "core/std/containers/hash_map.h"
 #include "core/std/containers/string.h"
+#include "core/std/option.h"
 #include "math/matrix4.h"
 #include "math/vector2.h"
 #include "renderer/frame_graph/resources/handle.h"
@@ -46,6 +47,11 @@ public:
 ///
 struct RenderOutput {
     frame_graph::TextureHandle color_output;
+
+    /// GPU culling counters, read back `rhi::config::MAX_FRAMES_IN_FLIGHT` frames late.
+    /// Empty until the first readback completes, or when the renderer doesn't count them.
+    core::Option<u32> visible_instances_count = std::nullopt;
+    core::Option<u32> visible_meshlets_count = std::nullopt;
 };
 
 } // namespace tundra::renderer
@@ -23,8 +23,6 @@ GpuRasterizeDebugOutput gpu_rasterize_debug_pass(
     frame_graph::FrameGraph& fg, const GpuRasterizeDebugInput& input) noexcept
 {
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::TextureHandle vis_depth;
         frame_graph::TextureHandle debug_texture;
     };
@@ -35,8 +33,6 @@ GpuRasterizeDebugOutput gpu_rasterize_debug_pass(
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.vis_depth = builder.read(
                 input.vis_depth,
                 frame_graph::TextureResourceUsage::COMPUTE_STORAGE_IMAGE);
@@ -62,12 +58,11 @@ GpuRasterizeDebugOutput gpu_rasterize_debug_pass(
 
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext*,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
-            const rhi::BufferHandle ubo_buffer = registry.get_buffer(
-                data.ubo_buffer->buffer());
+            frame_graph::ConstantAllocator& constants = registry.get_constant_allocator();
             const rhi::TextureHandle vis_depth = registry.get_texture(data.vis_depth);
             const rhi::TextureHandle debug_texture = registry.get_texture(
                 data.debug_texture);
@@ -78,18 +73,9 @@ GpuRasterizeDebugOutput gpu_rasterize_debug_pass(
                 .output_uav = debug_texture.get_uav(),
             };
 
-            const auto ubo_ref = data.ubo_buffer->allocate<ubo::GpuRasterizeDebugUBO>();
-
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(ubo),
-                        .dst_offset = ubo_ref.offset,
-                    },
-                });
+            const u32 ubo_offset = constants.allocate(ubo);
 
-            encoder.push_constants(ubo_buffer, ubo_ref.offset);
+            encoder.push_constants(constants.get_buffer(), ubo_offset);
             encoder.dispatch(
                 helpers::get_pipeline(
                     pipelines::software::passes::GPU_RASTERIZE_DEBUG_PASS_NAME,
@@ -1,18 +1,13 @@
 #pragma once
 #include "core/core.h"
-#include "core/std/shared_ptr.h"
 #include "math/vector2.h"
 #include "renderer/frame_graph/frame_graph.h"
 #include "renderer/render_input_output.h"
-#include "renderer/ubo.h"
 
 namespace tundra::renderer::passes {
 
 ///
 struct GpuRasterizeDebugInput {
-public:
-    core::SharedPtr<UboBuffer> ubo_buffer;
-
 public:
     math::UVec2 view_size = math::UVec2 {};
 
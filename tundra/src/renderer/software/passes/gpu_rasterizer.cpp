@@ -33,8 +33,6 @@ struct GPURasterizeUBO {
     frame_graph::FrameGraph& fg, const GpuRasterizerInput& input) noexcept
 {
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle visible_meshlets;
         frame_graph::BufferHandle visible_meshlets_count;
         frame_graph::BufferHandle dispatch_indirect_args;
@@ -47,8 +45,6 @@ struct GPURasterizeUBO {
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.visible_meshlets = builder.read(
                 input.visible_meshlets,
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
@@ -70,12 +66,11 @@ struct GPURasterizeUBO {
 
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext*,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
-            const rhi::BufferHandle ubo_buffer = registry.get_buffer(
-                data.ubo_buffer->buffer());
+            frame_graph::ConstantAllocator& constants = registry.get_constant_allocator();
             const rhi::BufferHandle visible_meshlets = registry.get_buffer(
                 data.visible_meshlets);
             const rhi::BufferHandle visible_meshlets_count = registry.get_buffer(
@@ -98,18 +93,9 @@ struct GPURasterizeUBO {
                 },
             };
 
-            const auto ubo_ref = data.ubo_buffer->allocate<ubo::GPURasterizeUBO>();
-
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(ubo),
-                        .dst_offset = ubo_ref.offset,
-                    },
-                });
+            const u32 ubo_offset = constants.allocate(ubo);
 
-            encoder.push_constants(ubo_buffer, ubo_ref.offset);
+            encoder.push_constants(constants.get_buffer(), ubo_offset);
             encoder.dispatch_indirect(
                 helpers::get_pipeline(
                     pipelines::software::passes::GPU_RASTERIZE_PASS_NAME,
@@ -1,20 +1,15 @@
 #pragma once
 #include "core/core.h"
-#include "core/std/shared_ptr.h"
 #include "math/matrix4.h"
 #include "math/vector2.h"
 #include "renderer/frame_graph/frame_graph.h"
 #include "renderer/frame_graph/resources/handle.h"
 #include "renderer/render_input_output.h"
-#include "renderer/ubo.h"
 
 namespace tundra::renderer::passes {
 
 ///
 struct GpuRasterizerInput {
-public:
-    core::SharedPtr<UboBuffer> ubo_buffer;
-
 public:
     math::Mat4 world_to_clip = math::Mat4 {};
     math::UVec2 view_size = math::UVec2 {};
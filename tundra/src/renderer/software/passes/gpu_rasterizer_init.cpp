@@ -26,8 +26,6 @@ GpuRasterizerInitOutput gpu_rasterizer_init_pass(
     frame_graph::FrameGraph& fg, const GpuRasterizerInitInput& input) noexcept
 {
     struct Data {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-
         frame_graph::BufferHandle visible_meshlets_count;
 
         frame_graph::TextureHandle vis_texture;
@@ -40,8 +38,6 @@ GpuRasterizerInitOutput gpu_rasterizer_init_pass(
         [&](frame_graph::Builder& builder) {
             Data data {};
 
-            data.ubo_buffer = input.ubo_buffer;
-
             data.visible_meshlets_count = builder.read(
                 input.visible_meshlets_count,
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
@@ -75,15 +71,15 @@ GpuRasterizerInitOutput gpu_rasterizer_init_pass(
                 data.gpu_rasterizer_dispatch_args,
                 frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER);
 
+            builder.use_recorded_bundles();
+
             return data;
         },
-        [=](rhi::IRHIContext* rhi,
+        [=](rhi::IRHIContext* context,
             const frame_graph::Registry& registry,
             rhi::CommandEncoder& encoder,
             const Data& data) {
             //
-            const rhi::BufferHandle ubo_buffer = registry.get_buffer(
-                data.ubo_buffer->buffer());
             const rhi::BufferHandle visible_meshlets_count = registry.get_buffer(
                 data.visible_meshlets_count);
             const rhi::BufferHandle gpu_rasterizer_dispatch_args = registry.get_buffer(
@@ -103,25 +99,28 @@ GpuRasterizerInitOutput gpu_rasterizer_init_pass(
                 .out_texture_uav = vis_texture.get_uav(),
             };
 
-            const auto ubo_ref = data.ubo_buffer->allocate<ubo::GpuRasterizeInitUBO>();
-
-            rhi->update_buffer(
-                ubo_buffer,
-                {
-                    rhi::BufferUpdateRegion {
-                        .src = core::as_byte_span(ubo),
-                        .dst_offset = ubo_ref.offset,
+            const rhi::ComputePipelineHandle pipeline = helpers::get_pipeline(
+                pipelines::software::passes::GPU_RASTERIZE_INIT_NAME,
+                input.compute_pipelines);
+
+            // The commands only change with the view size and the transient resources.
+            encoder.execute_recorded_bundle(
+                registry.get_recorded_bundle_cache().get_or_record(
+                    context,
+                    "gpu_rasterize_init_pass",
+                    rhi::QueueType::Graphics,
+                    {
+                        pipeline.get_handle().get_id(),
+                        dispatch_grid_dim.x,
+                        dispatch_grid_dim.y,
                     },
-                });
-
-            encoder.push_constants(ubo_buffer, ubo_ref.offset);
-            encoder.dispatch(
-                helpers::get_pipeline(
-                    pipelines::software::passes::GPU_RASTERIZE_INIT_NAME,
-                    input.compute_pipelines),
-                dispatch_grid_dim.x,
-                dispatch_grid_dim.y,
-                1);
+                    core::as_byte_span(ubo),
+                    [&](rhi::CommandEncoder& bundle_encoder,
+                        const rhi::BufferHandle constants_buffer) {
+                        bundle_encoder.push_constants(constants_buffer, 0);
+                        bundle_encoder.dispatch(
+                            pipeline, dispatch_grid_dim.x, dispatch_grid_dim.y, 1);
+                    }));
         });
 
     return GpuRasterizerInitOutput {
@@ -1,5 +1,4 @@
 #include "renderer/software/software_rasterizer.h"
-#include "core/std/shared_ptr.h"
 #include "math/matrix4.h"
 #include "math/vector4.h"
 #include "renderer/common/culling/instance_culling_and_lod.h"
@@ -9,7 +8,6 @@
 #include "renderer/software/passes/gpu_rasterize_debug_pass.h"
 #include "renderer/software/passes/gpu_rasterizer.h"
 #include "renderer/software/passes/gpu_rasterizer_init.h"
-#include "renderer/ubo.h"
 #include "rhi/commands/command_encoder.h"
 #include "rhi/rhi_context.h"
 #include "shader.h"
@@ -47,44 +45,10 @@ RenderOutput software_rasterizer(
         math::normalize(-frustum_t[3] + frustum_t[2]),
     };
 
-    struct UboData {
-        core::SharedPtr<UboBuffer> ubo_buffer;
-    };
-
-    const UboData ubo_data = fg.add_pass(
-        frame_graph::QueueType::Graphics,
-        "create_ubo",
-        [&](frame_graph::Builder& builder) {
-            constexpr u64 ubo_size = 1024ull * 1024;
-            const auto ubo_buffer = builder.create_buffer(
-                "ubo_buffer",
-                frame_graph::BufferCreateInfo {
-                    .usage = frame_graph::BufferUsageFlags::STORAGE_BUFFER,
-                    .memory_type = frame_graph::MemoryType::Dynamic,
-                    .size = ubo_size,
-                });
-
-            builder.write(
-                ubo_buffer,
-                frame_graph::BufferResourceUsage::COMPUTE_STORAGE_BUFFER |
-                    frame_graph::BufferResourceUsage::GRAPHICS_STORAGE_BUFFER);
-
-            return UboData {
-                .ubo_buffer = core::make_shared<UboBuffer>(ubo_buffer, ubo_size),
-            };
-        },
-        [=](rhi::IRHIContext*,
-            const frame_graph::Registry&,
-            rhi::CommandEncoder&,
-            const UboData&) {
-
-        });
-
     const common::culling::InstanceCullingOutput instance_culling =
         common::culling::instance_culling_and_lod(
             fg,
             common::culling::InstanceCullingInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .frustum_planes = frustum_planes,
                 .instance_count = static_cast<u32>(instance_count),
                 .mesh_descriptors = input.gpu_mesh_descriptors,
@@ -97,7 +61,6 @@ RenderOutput software_rasterizer(
         common::culling::meshlet_culling(
             fg,
             common::culling::MeshletCullingInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .frustum_planes = frustum_planes,
                 .camera_position = input.camera_position,
                 .world_to_view = input.world_to_view,
@@ -114,7 +77,6 @@ RenderOutput software_rasterizer(
         passes::gpu_rasterizer_init_pass(
             fg,
             passes::GpuRasterizerInitInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .view_size = input.view_size,
                 .visible_meshlets_count = meshlet_culling.visible_meshlets_count,
                 .compute_pipelines = input.compute_pipelines,
@@ -123,7 +85,6 @@ RenderOutput software_rasterizer(
     const passes::GpuRasterizerOutput gpu_rasterizer = passes::gpu_rasterizer_pass(
         fg,
         passes::GpuRasterizerInput {
-            .ubo_buffer = ubo_data.ubo_buffer,
             .world_to_clip = frustum,
             .view_size = input.view_size,
             .mesh_descriptors = input.gpu_mesh_descriptors,
@@ -140,19 +101,19 @@ RenderOutput software_rasterizer(
             passes::gpu_rasterize_debug_pass(
                 fg,
                 passes::GpuRasterizeDebugInput {
-                    .ubo_buffer = ubo_data.ubo_buffer,
                     .view_size = input.view_size,
                     .vis_depth = gpu_rasterizer.vis_texture,
                     .compute_pipelines = input.compute_pipelines,
                 });
         return RenderOutput {
             .color_output = debug_output.debug_texture,
+            .visible_instances_count = common::culling::read_visible_instances_count(fg),
+            .visible_meshlets_count = common::culling::read_visible_meshlets_count(fg),
         };
     } else {
         const passes::MaterialOutput material_output = passes::material(
             fg,
             passes::MaterialInput {
-                .ubo_buffer = ubo_data.ubo_buffer,
                 .world_to_clip = frustum,
                 .camera_position = input.camera_position,
                 .light_position = math::Vec3 { -5, 2, 5 },
@@ -169,6 +130,8 @@ RenderOutput software_rasterizer(
 
         return RenderOutput {
             .color_output = material_output.color_texture,
+            .visible_instances_count = common::culling::read_visible_instances_count(fg),
+            .visible_meshlets_count = common::culling::read_visible_meshlets_count(fg),
         };
     }
 }